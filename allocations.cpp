@@ -0,0 +1,363 @@
+#include "allocations.hpp"
+
+#include <new>
+#include <cerrno>
+
+#include <stdlib.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+bool tracking = false;
+
+struct ThreadCounts {
+    uint64_t count;
+    uint64_t bytes;
+    int64_t  live;
+    int64_t  peak;
+    int64_t  base;
+};
+
+// Plain data only: it is touched from inside malloc, so it must not need
+// constructing or allocating itself.
+__thread ThreadCounts counts;
+
+// Usable size of a block, in which live bytes are counted. Only glibc can
+// tell it; elsewhere peak live bytes are not tracked.
+inline size_t
+usable_size(void *ptr)
+{
+#if defined(__GLIBC__)
+    return malloc_usable_size(ptr);
+#else
+    (void) ptr;
+    return 0;
+#endif
+}
+
+// The block's size is only asked for while tracking, so that untracked
+// runs pay nothing more than the check on every heap operation.
+inline void
+count_allocation(size_t requested, void *ptr)
+{
+    if (!tracking) {
+        return;
+    }
+
+    size_t usable = usable_size(ptr);
+
+    counts.count++;
+    counts.bytes += requested;
+    counts.live += usable;
+    if (counts.live > counts.peak) {
+        counts.peak = counts.live;
+    }
+}
+
+inline void
+count_deallocation(void *ptr)
+{
+    if (tracking) {
+        counts.live -= usable_size(ptr);
+    }
+}
+
+} // namespace
+
+void
+set_allocation_tracking(bool enabled)
+{
+    tracking = enabled;
+}
+
+bool
+allocation_tracking()
+{
+    return tracking;
+}
+
+void
+begin_allocation_count()
+{
+    counts.count = 0;
+    counts.bytes = 0;
+    counts.base = counts.live;
+    counts.peak = counts.live;
+}
+
+AllocationCounts
+end_allocation_count()
+{
+    AllocationCounts result;
+    result.count = counts.count;
+    result.bytes = counts.bytes;
+    result.peak = counts.peak - counts.base;
+    return result;
+}
+
+#if defined(__GLIBC__)
+
+// With glibc the whole malloc family is replaced by wrappers around glibc's
+// own implementation, so allocations made from C code in the serialization
+// libraries are seen too. operator new below ends up here as well.
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void *ptr);
+
+void *
+malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    if (ptr) {
+        count_allocation(size, ptr);
+    }
+    return ptr;
+}
+
+void *
+calloc(size_t count, size_t size)
+{
+    void *ptr = __libc_calloc(count, size);
+    if (ptr) {
+        count_allocation(count * size, ptr);
+    }
+    return ptr;
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    // the old block's size has to be read while it still exists
+    size_t old_size = tracking && ptr ? malloc_usable_size(ptr) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (tracking && (result || size == 0)) {
+        counts.live -= old_size;
+    }
+    if (result) {
+        count_allocation(size, result);
+    }
+    return result;
+}
+
+void *
+memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr) {
+        count_allocation(size, ptr);
+    }
+    return ptr;
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int
+posix_memalign(void **result, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *ptr = memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *result = ptr;
+    return 0;
+}
+
+void
+free(void *ptr)
+{
+    if (ptr) {
+        count_deallocation(ptr);
+        __libc_free(ptr);
+    }
+}
+
+} // extern "C"
+
+#define ALLOCATE(size) malloc(size)
+#define ALLOCATE_ALIGNED(alignment, size) memalign(alignment, size)
+#define DEALLOCATE(ptr) free(ptr)
+
+#else
+
+// Elsewhere only C++ allocations are counted. Without a portable way to ask
+// for a block's size, peak live bytes are not tracked.
+
+namespace {
+
+void *
+allocate_aligned(size_t alignment, size_t size)
+{
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return NULL;
+    }
+    count_allocation(size, NULL);
+    return ptr;
+}
+
+} // namespace
+
+#define ALLOCATE(size) (count_allocation(size, NULL), malloc(size))
+#define ALLOCATE_ALIGNED(alignment, size) allocate_aligned(alignment, size)
+#define DEALLOCATE(ptr) free(ptr)
+
+#endif
+
+// Replacing operator new also keeps allocators linked in by the libraries
+// (e.g. tcmalloc brought in by HPX) from bypassing the counters.
+
+void *
+operator new(size_t size)
+{
+    void *ptr = ALLOCATE(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *
+operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *
+operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return ALLOCATE(size ? size : 1);
+}
+
+void *
+operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return ALLOCATE(size ? size : 1);
+}
+
+void
+operator delete(void *ptr) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+
+// The compiler calls these when it knows the size, which the counters
+// don't need: it is read back from the block.
+
+void
+operator delete(void *ptr, size_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr, size_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+#endif
+
+#if defined(__cpp_aligned_new)
+
+// Over-aligned types, which C++17 allocates apart.
+
+void *
+operator new(size_t size, std::align_val_t alignment)
+{
+    void *ptr = ALLOCATE_ALIGNED(static_cast<size_t>(alignment), size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *
+operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *
+operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return ALLOCATE_ALIGNED(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void *
+operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return ALLOCATE_ALIGNED(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void
+operator delete(void *ptr, std::align_val_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+void
+operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    DEALLOCATE(ptr);
+}
+
+#endif
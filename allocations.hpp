@@ -0,0 +1,24 @@
+#ifndef __ALLOCATIONS_HPP_INCLUDED__
+#define __ALLOCATIONS_HPP_INCLUDED__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Heap allocations made by the calling thread between begin_allocation_count()
+// and end_allocation_count(). The test binary interposes operator new and,
+// with glibc, the malloc family, and counts while tracking is enabled.
+struct AllocationCounts {
+    uint64_t count; // number of allocations
+    uint64_t bytes; // bytes requested by them
+    int64_t  peak;  // highest number of bytes live at once above the starting point
+
+    AllocationCounts() : count(0), bytes(0), peak(0) {}
+};
+
+void set_allocation_tracking(bool enabled);
+bool allocation_tracking();
+
+void begin_allocation_count();
+AllocationCounts end_allocation_count();
+
+#endif
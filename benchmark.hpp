@@ -0,0 +1,696 @@
+#ifndef __BENCHMARK_HPP_INCLUDED__
+#define __BENCHMARK_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <condition_variable>
+
+#include <stdint.h>
+
+#include "options.hpp"
+#include "histogram.hpp"
+#include "statistics.hpp"
+#include "perf_counters.hpp"
+#include "allocations.hpp"
+#include "results.hpp"
+#include "topology.hpp"
+#include "timer.hpp"
+
+// Heap allocations summed over the operations of one phase.
+struct AllocationTotals {
+    uint64_t operations;
+    uint64_t count;
+    uint64_t bytes;
+    int64_t  peak; // highest of the operations' peaks
+
+    AllocationTotals() : operations(0), count(0), bytes(0), peak(0) {}
+
+    // `counts` were made by `batch` operations in a row
+    void add(const AllocationCounts &counts, uint64_t batch = 1) {
+        operations += batch;
+        count += counts.count;
+        bytes += counts.bytes;
+        peak = std::max(peak, counts.peak);
+    }
+
+    void merge(const AllocationTotals &other) {
+        operations += other.operations;
+        count += other.count;
+        bytes += other.bytes;
+        peak = std::max(peak, other.peak);
+    }
+};
+
+// Time spent in the encode and the decode half of a serialize-deserialize
+// loop, summed over the iterations of every measured run, along with the
+// latency distribution of the individual operations in nanoseconds and,
+// with --counters, the hardware events counted over all measured runs and,
+// with --allocations, the heap allocations made by each phase.
+struct Timings {
+    size_t iterations;
+
+    std::vector<std::chrono::nanoseconds> encode;
+    std::vector<std::chrono::nanoseconds> decode;
+
+    Histogram encode_latency;
+    Histogram decode_latency;
+
+    CounterValues counters;
+
+    AllocationTotals encode_allocations;
+    AllocationTotals decode_allocations;
+
+    Timings() : iterations(0) {}
+
+    // Adds the runs of `other`, e.g. the same test on another thread.
+    void merge(const Timings &other) {
+        iterations = other.iterations;
+        encode.insert(encode.end(), other.encode.begin(), other.encode.end());
+        decode.insert(decode.end(), other.decode.begin(), other.decode.end());
+        encode_latency.merge(other.encode_latency);
+        decode_latency.merge(other.decode_latency);
+        for (int i = 0; i < CounterValues::EventCount; i++) {
+            counters.measured[i] = counters.measured[i] || other.counters.measured[i];
+            counters.values[i] += other.counters.values[i];
+        }
+        encode_allocations.merge(other.encode_allocations);
+        decode_allocations.merge(other.decode_allocations);
+    }
+
+    // Round trips measured, over all runs and threads.
+    uint64_t round_trips() const {
+        return static_cast<uint64_t>(iterations) * encode.size();
+    }
+
+    std::vector<std::chrono::nanoseconds> total() const {
+        std::vector<std::chrono::nanoseconds> result;
+        for (size_t i = 0; i < encode.size(); i++) {
+            result.push_back(encode[i] + decode[i]);
+        }
+        return result;
+    }
+};
+
+// Blocks the threads calling wait() until `count` of them have arrived.
+class Barrier {
+public:
+
+    explicit Barrier(size_t count) : count_(count), waiting_(0) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (++waiting_ == count_) {
+            condition_.notify_all();
+        } else {
+            condition_.wait(lock, [this] { return waiting_ >= count_; });
+        }
+    }
+
+private:
+
+    size_t count_;
+    size_t waiting_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+// Where a test running on one of several threads (see scaling.hpp) leaves
+// its results instead of printing them. measure() waits on `start` after
+// the warm-up so that all threads time the same period.
+struct Collector {
+    Barrier    *start;
+    bool        started;
+    bool        reported;
+    std::string version;
+    size_t      size;
+    Timings     timings;
+
+    explicit Collector(Barrier *start = NULL) : start(start), started(false), reported(false), size(0) {}
+};
+
+inline Collector *&
+collector()
+{
+    static thread_local Collector *instance = NULL;
+    return instance;
+}
+
+// CPUs the encode and the decode half of every round trip run on in the
+// placement mode (see placement.hpp).
+struct Placement {
+    std::vector<int> encode_cpus;
+    std::vector<int> decode_cpus;
+};
+
+inline const Placement *&
+placement()
+{
+    static const Placement *instance = NULL;
+    return instance;
+}
+
+// Opens the hardware counters when --counters is given. When the host does
+// not provide them the reason is reported once and the tests go on with
+// timing only.
+inline std::unique_ptr<PerfCounters>
+open_counters()
+{
+    static bool warned = false;
+
+    std::unique_ptr<PerfCounters> counters;
+
+    if (options().counters) {
+        counters.reset(new PerfCounters());
+        if (!counters->available()) {
+            if (!warned) {
+                std::cout << "hardware counters unavailable (" << counters->error()
+                          << "), reporting timings only" << std::endl << std::endl;
+                warned = true;
+            }
+            counters.reset();
+        }
+    }
+
+    return counters;
+}
+
+// Keeps the compiler from discarding `value`, and the work that went into
+// it, as unused: the empty asm statement claims to read it from a register
+// or from memory.
+template <typename T>
+inline void
+do_not_optimize(const T &value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char *sink = &reinterpret_cast<const volatile char &>(value);
+    (void)*sink;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Makes the compiler assume that any memory may be read and written here,
+// so that the stores an operation made to its buffers and to the variables
+// its lambda captured can't be dropped or sunk out of the timed section.
+inline void
+clobber_memory()
+{
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Round trips between two calls to the `check` given to measure().
+const size_t kCheckPeriod = 1024;
+
+// measure() for the placement mode: `encode` runs on a thread pinned to
+// the placement's encode CPUs and `decode` on one pinned to its decode
+// CPUs. The threads take turns, so every message is encoded on one side and
+// handed over to be decoded on the other. Each side times only its own
+// operations, the hand-over itself is not counted.
+template <typename Encode, typename Decode, typename Check>
+Timings
+measure_pipeline(size_t iterations, Encode encode, Decode decode, Check check, const Placement &cpus)
+{
+    const Options &opts = options();
+    const Timer timer(opts.timer == "tsc");
+    const size_t total = opts.warmup + opts.runs * iterations;
+    const bool track_allocations = allocation_tracking();
+
+    Timings timings;
+    timings.iterations = iterations;
+    timings.encode.assign(opts.runs, std::chrono::nanoseconds(0));
+    timings.decode.assign(opts.runs, std::chrono::nanoseconds(0));
+
+    // odd values are the decoder's turn
+    std::atomic<size_t> turn(0);
+    std::string encode_error;
+    std::string decode_error;
+
+    auto wait_for = [&turn](size_t value) {
+        for (size_t spins = 0; turn.load(std::memory_order_acquire) != value; spins++) {
+            if (spins > 1000) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::thread encoder([&] {
+        if (!pin_current_thread(cpus.encode_cpus)) {
+            encode_error = "can't pin the encoding thread to " + describe_cpus(cpus.encode_cpus);
+        }
+        for (size_t i = 0; i < total; i++) {
+            wait_for(2 * i);
+            if (i >= opts.warmup) {
+                if (track_allocations) {
+                    begin_allocation_count();
+                }
+                uint64_t start = timer.start();
+                encode();
+                clobber_memory();
+                uint64_t finish = timer.stop();
+                if (track_allocations) {
+                    timings.encode_allocations.add(end_allocation_count());
+                }
+                std::chrono::nanoseconds time = timer.elapsed(start, finish);
+                timings.encode[(i - opts.warmup) / iterations] += time;
+                timings.encode_latency.record(time.count());
+            } else {
+                encode();
+            }
+            turn.store(2 * i + 1, std::memory_order_release);
+        }
+    });
+
+    std::thread decoder([&] {
+        if (!pin_current_thread(cpus.decode_cpus)) {
+            decode_error = "can't pin the decoding thread to " + describe_cpus(cpus.decode_cpus);
+        }
+        for (size_t i = 0; i < total; i++) {
+            wait_for(2 * i + 1);
+            if (i >= opts.warmup) {
+                if (track_allocations) {
+                    begin_allocation_count();
+                }
+                uint64_t start = timer.start();
+                decode();
+                clobber_memory();
+                uint64_t finish = timer.stop();
+                if (track_allocations) {
+                    timings.decode_allocations.add(end_allocation_count());
+                }
+                std::chrono::nanoseconds time = timer.elapsed(start, finish);
+                timings.decode[(i - opts.warmup) / iterations] += time;
+                timings.decode_latency.record(time.count());
+            } else {
+                decode();
+            }
+            // before the encoder moves on to the next record
+            if ((i + 1) % kCheckPeriod == 0 && decode_error.empty()) {
+                try {
+                    check();
+                } catch (std::exception &exc) {
+                    decode_error = exc.what();
+                }
+            }
+            turn.store(2 * i + 2, std::memory_order_release);
+        }
+    });
+
+    encoder.join();
+    decoder.join();
+
+    if (!encode_error.empty() || !decode_error.empty()) {
+        throw std::runtime_error(encode_error.empty() ? decode_error : encode_error);
+    }
+
+    return timings;
+}
+
+// Runs options().warmup untimed round trips, then options().runs times
+// `iterations` round trips, calling `encode` and then `decode` on every
+// iteration and timing each of them separately. With --batch=B, B encodes
+// in a row are timed together and then B decodes, which keeps the clock's
+// own overhead out of operations taking a few nanoseconds; the latency
+// histograms then hold the mean operation time of each batch. Allocation
+// counting, when enabled, is kept outside of the timed sections, and so is
+// the cache flush --flush makes before every batch of encodes and of
+// decodes.
+//
+// Timestamps come from the steady clock, or from the time stamp counter
+// with --timer=tsc (see timer.hpp).
+//
+// Every operation is followed by a compiler barrier, so that what it
+// wrote is kept even when nothing reads it, and every kCheckPeriod round
+// trips (or the first batch past them) `check` is called, untimed and with
+// the counters paused, to throw if the last decode didn't reproduce the
+// last record encoded.
+template <typename Encode, typename Decode, typename Check>
+Timings
+measure(size_t iterations, Encode encode, Decode decode, Check check)
+{
+    if (placement()) {
+        return measure_pipeline(iterations, encode, decode, check, *placement());
+    }
+
+    const Options &opts = options();
+    const Timer timer(opts.timer == "tsc");
+
+    for (size_t i = 0; i < opts.warmup; i++) {
+        encode();
+        decode();
+        clobber_memory();
+    }
+
+    if (Collector *shared = collector()) {
+        shared->started = true;
+        shared->start->wait();
+    }
+
+    Timings timings;
+    timings.iterations = iterations;
+
+    std::unique_ptr<PerfCounters> counters = open_counters();
+
+    const bool track_allocations = allocation_tracking();
+    const size_t batch = std::max<size_t>(opts.batch, 1);
+    size_t unchecked = 0;
+
+    // --flush: start every batch of encodes and of decodes on cold caches
+    auto pause_and_flush = [&] {
+        if (counters) {
+            counters->stop(timings.counters);
+        }
+        flush_caches();
+        if (counters) {
+            counters->start();
+        }
+    };
+
+    for (size_t run = 0; run < opts.runs; run++) {
+        std::chrono::nanoseconds encode_total(0);
+        std::chrono::nanoseconds decode_total(0);
+
+        if (counters) {
+            counters->start();
+        }
+
+        for (size_t i = 0; i < iterations; i += batch) {
+            const size_t count = std::min(batch, iterations - i);
+
+            if (opts.flush) {
+                pause_and_flush();
+            }
+
+            if (track_allocations) {
+                begin_allocation_count();
+            }
+
+            uint64_t start = timer.start();
+            for (size_t j = 0; j < count; j++) {
+                encode();
+                clobber_memory();
+            }
+            uint64_t encoded = timer.stop();
+            auto decode_start = encoded;
+
+            if (track_allocations) {
+                timings.encode_allocations.add(end_allocation_count(), count);
+            }
+
+            if (opts.flush) {
+                pause_and_flush();
+            }
+
+            if (track_allocations) {
+                begin_allocation_count();
+            }
+
+            if (track_allocations || opts.flush) {
+                decode_start = timer.start();
+            }
+
+            for (size_t j = 0; j < count; j++) {
+                decode();
+                clobber_memory();
+            }
+            uint64_t finish = timer.stop();
+
+            if (track_allocations) {
+                timings.decode_allocations.add(end_allocation_count(), count);
+            }
+
+            std::chrono::nanoseconds encode_time = timer.elapsed(start, encoded);
+            std::chrono::nanoseconds decode_time = timer.elapsed(decode_start, finish);
+
+            encode_total += encode_time;
+            decode_total += decode_time;
+
+            timings.encode_latency.record(encode_time.count() / count);
+            timings.decode_latency.record(decode_time.count() / count);
+
+            unchecked += count;
+            if (unchecked >= kCheckPeriod) {
+                if (counters) {
+                    counters->stop(timings.counters);
+                }
+                check();
+                if (counters) {
+                    counters->start();
+                }
+                unchecked = 0;
+            }
+        }
+
+        if (counters) {
+            counters->stop(timings.counters);
+        }
+
+        timings.encode.push_back(encode_total);
+        timings.decode.push_back(decode_total);
+    }
+
+    return timings;
+}
+
+inline Summary
+summarize_milliseconds(const std::vector<std::chrono::nanoseconds> &runs)
+{
+    std::vector<double> values;
+    for (size_t i = 0; i < runs.size(); i++) {
+        values.push_back(std::chrono::duration<double, std::milli>(runs[i]).count());
+    }
+    return summarize(values);
+}
+
+inline Percentiles
+percentiles(const Histogram &latency)
+{
+    Percentiles result;
+    result.p50 = latency.percentile(50.0);
+    result.p90 = latency.percentile(90.0);
+    result.p99 = latency.percentile(99.0);
+    result.p999 = latency.percentile(99.9);
+    result.max = latency.max();
+    return result;
+}
+
+inline void
+print_latency(const std::string &name, const std::string &phase, const Histogram &latency)
+{
+    std::cout << name << ": " << phase << " latency ="
+              << " p50 " << latency.percentile(50.0)
+              << ", p90 " << latency.percentile(90.0)
+              << ", p99 " << latency.percentile(99.0)
+              << ", p99.9 " << latency.percentile(99.9)
+              << ", max " << latency.max()
+              << " nanoseconds" << std::endl;
+}
+
+inline void
+print_summary(const std::string &name, const std::string &phase, const Summary &summary)
+{
+    std::cout << name << ": " << phase << " runs ="
+              << " mean " << summary.mean
+              << ", median " << summary.median
+              << ", stddev " << summary.stddev
+              << ", 95% CI [" << summary.ci_low << ", " << summary.ci_high << "]"
+              << " milliseconds over " << summary.samples << " runs";
+    if (summary.outliers > 0) {
+        std::cout << " (" << summary.outliers << " outliers dropped)";
+    }
+    std::cout << std::endl;
+
+    if (summary.relative_stddev() > options().max_cv) {
+        std::cout << name << ": WARNING: " << phase << " time varies by " << summary.relative_stddev()
+                  << "% between runs, too noisy to compare" << std::endl;
+    }
+}
+
+// Prints hardware events per round trip and per byte of the `size` bytes
+// long serialized message.
+inline void
+print_counters(const std::string &name, const CounterValues &counters, uint64_t round_trips, size_t size)
+{
+    if (round_trips == 0 || size == 0) {
+        return;
+    }
+
+    const char *scopes[] = {"per round trip", "per byte"};
+    const double divisors[] = {static_cast<double>(round_trips), static_cast<double>(round_trips) * size};
+
+    for (int scope = 0; scope < 2; scope++) {
+        std::cout << name << ": counters " << scopes[scope] << " =";
+
+        const char *separator = " ";
+        for (int event = 0; event < CounterValues::EventCount; event++) {
+            std::cout << separator << CounterValues::name(event) << " ";
+            if (counters.measured[event]) {
+                std::cout << counters.values[event] / divisors[scope];
+            } else {
+                std::cout << "n/a";
+            }
+            separator = ", ";
+        }
+
+        if (scope == 0) {
+            std::cout << ", IPC ";
+            if (counters.measured[CounterValues::Cycles] && counters.measured[CounterValues::Instructions] &&
+                counters.values[CounterValues::Cycles] > 0) {
+                std::cout << counters.values[CounterValues::Instructions] / counters.values[CounterValues::Cycles];
+            } else {
+                std::cout << "n/a";
+            }
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+inline void
+print_allocations(const std::string &name, const std::string &phase, const AllocationTotals &allocations)
+{
+    if (allocations.operations == 0) {
+        return;
+    }
+
+    double operations = static_cast<double>(allocations.operations);
+
+    std::cout << name << ": " << phase << " allocations = "
+              << allocations.count / operations << " per operation, "
+              << allocations.bytes / operations << " bytes per operation, peak "
+              << allocations.peak << " bytes live" << std::endl;
+}
+
+// Fails serializers listed in --allocation-free that allocated on the heap
+// during the measured runs.
+inline void
+check_allocation_free(const std::string &name, const Timings &timings)
+{
+    if (options().allocation_free.count(name) == 0) {
+        return;
+    }
+
+    uint64_t count = timings.encode_allocations.count + timings.decode_allocations.count;
+    if (count > 0) {
+        std::ostringstream message;
+        message << name << "'s case: " << count << " allocations in steady state, expected none";
+        throw std::logic_error(message.str());
+    }
+}
+
+inline Result
+make_result(const std::string &name, const std::string &version, const Timings &timings, size_t size)
+{
+    Result result;
+    result.name = name;
+    result.version = version;
+    result.size = size;
+    result.iterations = timings.iterations;
+    result.encode = summarize_milliseconds(timings.encode);
+    result.decode = summarize_milliseconds(timings.decode);
+    result.total = summarize_milliseconds(timings.total());
+    result.encode_latency = percentiles(timings.encode_latency);
+    result.decode_latency = percentiles(timings.decode_latency);
+    return result;
+}
+
+// Prints the mean time per run of each phase and, when the loop was
+// repeated, the statistics of the runs, and keeps them for the JSON and CSV
+// reports. `version` is the serialization library's version and `size` is
+// the size of the serialized message in bytes.
+inline void
+print_timings(const std::string &name, const std::string &version, const Timings &timings, size_t size)
+{
+    if (Collector *shared = collector()) {
+        shared->version = version;
+        shared->size = size;
+        shared->timings = timings;
+        shared->reported = true;
+        return;
+    }
+
+    if (!version.empty()) {
+        std::cout << name << ": version = " << version << std::endl;
+    }
+    std::cout << name << ": size = " << size << " bytes" << std::endl;
+
+    Result result = make_result(name, version, timings, size);
+
+    const Summary &encode = result.encode;
+    const Summary &decode = result.decode;
+    const Summary &total = result.total;
+
+    std::cout << name << ": encode time = " << encode.mean << " milliseconds" << std::endl;
+    std::cout << name << ": decode time = " << decode.mean << " milliseconds" << std::endl;
+    std::cout << name << ": time = " << total.mean << " milliseconds" << std::endl;
+
+    if (timings.encode.size() > 1) {
+        print_summary(name, "encode", encode);
+        print_summary(name, "decode", decode);
+        print_summary(name, "total", total);
+    }
+
+    print_latency(name, "encode", timings.encode_latency);
+    print_latency(name, "decode", timings.decode_latency);
+
+    if (timings.counters.any()) {
+        print_counters(name, timings.counters, timings.round_trips(), size);
+    }
+
+    print_allocations(name, "encode", timings.encode_allocations);
+    print_allocations(name, "decode", timings.decode_allocations);
+    std::cout << std::endl;
+
+    add_result(result);
+
+    check_allocation_free(name, timings);
+}
+
+// print_timings() for a test cycling through several records, `sizes`
+// being the size of each serialized record: prints their distribution
+// and reports the mean size.
+inline void
+print_timings(const std::string &name, const std::string &version, const Timings &timings,
+              const std::vector<size_t> &sizes)
+{
+    if (sizes.size() == 1) {
+        print_timings(name, version, timings, sizes[0]);
+        return;
+    }
+
+    std::vector<double> sorted(sizes.begin(), sizes.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        total += sorted[i];
+    }
+    size_t mean = sorted.empty() ? 0 : static_cast<size_t>(total / sorted.size() + 0.5);
+
+    if (!collector() && !sorted.empty()) {
+        std::cout << name << ": sizes = min " << sorted.front()
+                  << ", p50 " << quantile(sorted, 0.5)
+                  << ", p90 " << quantile(sorted, 0.9)
+                  << ", p99 " << quantile(sorted, 0.99)
+                  << ", max " << sorted.back()
+                  << ", mean " << mean
+                  << " bytes over " << sorted.size() << " records" << std::endl;
+    }
+
+    print_timings(name, version, timings, mean);
+}
+
+#endif
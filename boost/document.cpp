@@ -0,0 +1,23 @@
+#include "boost/document.hpp"
+
+namespace boost_test {
+
+void
+to_string(const Document &document, std::string &data)
+{
+    std::ostringstream stream;
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << document;
+
+    data = stream.str();
+}
+
+void
+from_string(Document &document, const std::string &data)
+{
+    std::stringstream stream(data);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> document;
+}
+
+} // namespace
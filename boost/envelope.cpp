@@ -0,0 +1,23 @@
+#include "boost/envelope.hpp"
+
+namespace boost_test {
+
+void
+to_string(const Envelope &envelope, std::string &data)
+{
+    std::ostringstream stream;
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << envelope;
+
+    data = stream.str();
+}
+
+void
+from_string(Envelope &envelope, const std::string &data)
+{
+    std::stringstream stream(data);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> envelope;
+}
+
+} // namespace
@@ -0,0 +1,106 @@
+#ifndef __BOOST_ENVELOPE_HPP_INCLUDED__
+#define __BOOST_ENVELOPE_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <boost/variant.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/variant.hpp>
+
+namespace boost_test {
+
+// One class per message type, which the variant tells apart.
+template <int Type>
+class Message {
+public:
+
+    int64_t              id;
+    std::string          name;
+    std::vector<int64_t> values;
+
+    Message() : id(0) {}
+
+    bool operator==(const Message &other) const {
+        return (id == other.id &&
+                name == other.name &&
+                values == other.values);
+    }
+
+    bool operator!=(const Message &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & id;
+        ar & name;
+        ar & values;
+    }
+};
+
+typedef boost::variant<Message<0>,
+                       Message<1>,
+                       Message<2>,
+                       Message<3>,
+                       Message<4>,
+                       Message<5>,
+                       Message<6>,
+                       Message<7>,
+                       Message<8>,
+                       Message<9>,
+                       Message<10>,
+                       Message<11>,
+                       Message<12>,
+                       Message<13>,
+                       Message<14>,
+                       Message<15>> Body;
+
+class Envelope {
+public:
+
+    int64_t sequence;
+    Body    body;
+
+    Envelope() : sequence(0) {}
+
+    bool operator==(const Envelope &other) const {
+        return (sequence == other.sequence &&
+                body == other.body);
+    }
+
+    bool operator!=(const Envelope &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & sequence;
+        ar & body;
+    }
+};
+
+void to_string(const Envelope &envelope, std::string &data);
+void from_string(Envelope &envelope, const std::string &data);
+
+} // namespace
+
+#endif
@@ -0,0 +1,62 @@
+#include "boost/graph.hpp"
+
+BOOST_CLASS_EXPORT_GUID(boost_test::WeightNode<true>, "WeightNode")
+BOOST_CLASS_EXPORT_GUID(boost_test::TextNode<true>, "TextNode")
+BOOST_CLASS_EXPORT_GUID(boost_test::SeriesNode<true>, "SeriesNode")
+BOOST_CLASS_EXPORT_GUID(boost_test::WeightNode<false>, "UntrackedWeightNode")
+BOOST_CLASS_EXPORT_GUID(boost_test::TextNode<false>, "UntrackedTextNode")
+BOOST_CLASS_EXPORT_GUID(boost_test::SeriesNode<false>, "UntrackedSeriesNode")
+
+namespace boost_test {
+
+namespace {
+
+template <typename Graph>
+void
+save(const Graph &graph, std::string &data)
+{
+    std::ostringstream stream;
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << graph;
+
+    data = stream.str();
+}
+
+template <typename Graph>
+void
+load(Graph &graph, const std::string &data)
+{
+    graph.clear();
+
+    std::stringstream stream(data);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> graph;
+}
+
+} // namespace
+
+void
+to_string(const Graph<true> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+to_string(const Graph<false> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+from_string(Graph<true> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+void
+from_string(Graph<false> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+} // namespace
@@ -0,0 +1,175 @@
+#ifndef __BOOST_GRAPH_HPP_INCLUDED__
+#define __BOOST_GRAPH_HPP_INCLUDED__
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <type_traits>
+
+#include <stdint.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/unique_ptr.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/tracking.hpp>
+
+namespace boost_test {
+
+// A node of the object graph, serialized through a pointer to Node and
+// told apart from the other kinds by its exported class. A tracked node
+// (Tracked set) holds its children and its links to other nodes as shared
+// pointers, so that a node may be reached several times and a link may
+// point back to an ancestor. An untracked one owns its children through
+// unique pointers, refers to other nodes by id and is never tracked.
+template <bool Tracked>
+class Node {
+public:
+
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, std::unique_ptr<Node> >::type Pointer;
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, int64_t>::type Link;
+
+    int64_t              id;
+    std::vector<Pointer> children;
+    std::vector<Link>    links;
+
+    Node() : id(0) {}
+    virtual ~Node() {}
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & id;
+        ar & children;
+        ar & links;
+    }
+};
+
+template <bool Tracked>
+class WeightNode : public Node<Tracked> {
+public:
+
+    double weight;
+
+    WeightNode() : weight(0) {}
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & boost::serialization::base_object<Node<Tracked> >(*this);
+        ar & weight;
+    }
+};
+
+template <bool Tracked>
+class TextNode : public Node<Tracked> {
+public:
+
+    std::string text;
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & boost::serialization::base_object<Node<Tracked> >(*this);
+        ar & text;
+    }
+};
+
+template <bool Tracked>
+class SeriesNode : public Node<Tracked> {
+public:
+
+    std::vector<int64_t> values;
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & boost::serialization::base_object<Node<Tracked> >(*this);
+        ar & values;
+    }
+};
+
+template <bool Tracked>
+class Graph {
+public:
+
+    typedef Node<Tracked>       NodeType;
+    typedef WeightNode<Tracked> WeightType;
+    typedef TextNode<Tracked>   TextType;
+    typedef SeriesNode<Tracked> SeriesType;
+
+    typedef typename NodeType::Pointer Pointer;
+
+    Pointer root;
+
+    Graph() {}
+
+    ~Graph() {
+        clear();
+    }
+
+    // The links are dropped before the nodes, as those of a tracked graph
+    // make cycles of shared pointers.
+    void clear() {
+        if (root) {
+            release(*root);
+        }
+        root.reset();
+    }
+
+private:
+
+    Graph(const Graph &);
+    Graph &operator=(const Graph &);
+
+    static void release(NodeType &node) {
+        node.links.clear();
+        for (size_t i = 0; i < node.children.size(); i++) {
+            release(*node.children[i]);
+        }
+    }
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & root;
+    }
+};
+
+void to_string(const Graph<true> &graph, std::string &data);
+void to_string(const Graph<false> &graph, std::string &data);
+void from_string(Graph<true> &graph, const std::string &data);
+void from_string(Graph<false> &graph, const std::string &data);
+
+} // namespace
+
+BOOST_CLASS_TRACKING(boost_test::Node<false>, boost::serialization::track_never)
+BOOST_CLASS_TRACKING(boost_test::WeightNode<false>, boost::serialization::track_never)
+BOOST_CLASS_TRACKING(boost_test::TextNode<false>, boost::serialization::track_never)
+BOOST_CLASS_TRACKING(boost_test::SeriesNode<false>, boost::serialization::track_never)
+
+#endif
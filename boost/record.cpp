@@ -1,4 +1,5 @@
 #include "boost/record.hpp"
+#include "string_buffer.hpp"
 
 namespace boost_test {
 
@@ -20,4 +21,24 @@ from_string(Record &record, const std::string &data)
     archiver >> record;
 }
 
+void
+to_buffer(const Record &record, std::string &data)
+{
+    data.clear();
+
+    StringOutputBuffer buffer(data);
+    std::ostream stream(&buffer);
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << record;
+}
+
+void
+from_buffer(Record &record, const std::string &data)
+{
+    StringInputBuffer buffer(data);
+    std::istream stream(&buffer);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> record;
+}
+
 } // namespace
@@ -54,6 +54,12 @@ private:
 void to_string(const Record &record, std::string &data);
 void from_string(Record &record, const std::string &data);
 
+// Same as to_string() and from_string(), but the archive writes straight
+// into `data`, which keeps its capacity from one call to the next, and
+// reads from it in place.
+void to_buffer(const Record &record, std::string &data);
+void from_buffer(Record &record, const std::string &data);
+
 } // namespace
 
 #endif
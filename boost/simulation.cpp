@@ -0,0 +1,23 @@
+#include "boost/simulation.hpp"
+
+namespace boost_test {
+
+void
+to_string(const Simulation &simulation, std::string &data)
+{
+    std::ostringstream stream;
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << simulation;
+
+    data = stream.str();
+}
+
+void
+from_string(Simulation &simulation, const std::string &data)
+{
+    std::stringstream stream(data);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> simulation;
+}
+
+} // namespace
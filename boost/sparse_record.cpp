@@ -0,0 +1,23 @@
+#include "boost/sparse_record.hpp"
+
+namespace boost_test {
+
+void
+to_string(const SparseRecord &record, std::string &data)
+{
+    std::ostringstream stream;
+    boost::archive::binary_oarchive archiver(stream);
+    archiver << record;
+
+    data = stream.str();
+}
+
+void
+from_string(SparseRecord &record, const std::string &data)
+{
+    std::stringstream stream(data);
+    boost::archive::binary_iarchive archiver(stream);
+    archiver >> record;
+}
+
+} // namespace
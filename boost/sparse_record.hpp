@@ -0,0 +1,87 @@
+#ifndef __BOOST_SPARSE_RECORD_HPP_INCLUDED__
+#define __BOOST_SPARSE_RECORD_HPP_INCLUDED__
+
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <boost/serialization/string.hpp>
+
+namespace boost_test {
+
+// 64 optional fields: field n is integers[n / 4] when n % 4 is 0,
+// strings[n / 4] when 1, doubles[n / 4] when 2 and flags[n / 4] when 3.
+// Only the fields that are set are written, after the mask of those set.
+class SparseRecord {
+public:
+
+    static const size_t kSlots = 16;
+
+    uint64_t    present; // bit n is set when field n is
+    int64_t     integers[kSlots];
+    std::string strings[kSlots];
+    double      doubles[kSlots];
+    bool        flags[kSlots];
+
+    SparseRecord() : present(0), integers(), doubles(), flags() {}
+
+    bool has(size_t field) const {
+        return (present >> field) & 1;
+    }
+
+    bool operator==(const SparseRecord &other) const {
+        if (present != other.present) {
+            return false;
+        }
+
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if ((has(4 * slot) && integers[slot] != other.integers[slot]) ||
+                (has(4 * slot + 1) && strings[slot] != other.strings[slot]) ||
+                (has(4 * slot + 2) && doubles[slot] != other.doubles[slot]) ||
+                (has(4 * slot + 3) && flags[slot] != other.flags[slot])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const SparseRecord &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & present;
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if (has(4 * slot)) {
+                ar & integers[slot];
+            }
+            if (has(4 * slot + 1)) {
+                ar & strings[slot];
+            }
+            if (has(4 * slot + 2)) {
+                ar & doubles[slot];
+            }
+            if (has(4 * slot + 3)) {
+                ar & flags[slot];
+            }
+        }
+    }
+};
+
+void to_string(const SparseRecord &record, std::string &data);
+void from_string(SparseRecord &record, const std::string &data);
+
+} // namespace
+
+#endif
@@ -0,0 +1,22 @@
+#include "cereal/document.hpp"
+
+namespace cereal_test {
+
+void
+to_string(const Document &document, std::string &data)
+{
+    std::ostringstream stream;
+    cereal::BinaryOutputArchive archive(stream);
+    archive(document);
+    data = stream.str();
+}
+
+void
+from_string(Document &document, const std::string &data)
+{
+    std::stringstream stream(data);
+    cereal::BinaryInputArchive archive(stream);
+    archive(document);
+}
+
+} // namespace
@@ -0,0 +1,125 @@
+#ifndef __CEREAL_DOCUMENT_HPP_INCLUDED__
+#define __CEREAL_DOCUMENT_HPP_INCLUDED__
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/map.hpp>
+
+namespace cereal_test {
+
+class Paragraph {
+public:
+
+    std::string                   text;
+    bool                          highlighted;
+    std::vector<int64_t>          offsets;
+    std::map<std::string, double> weights;
+
+    Paragraph() : highlighted(false) {}
+
+    bool operator==(const Paragraph &other) const {
+        return (text == other.text &&
+                highlighted == other.highlighted &&
+                offsets == other.offsets &&
+                weights == other.weights);
+    }
+
+    bool operator!=(const Paragraph &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(text, highlighted, offsets, weights);
+    }
+};
+
+class Section {
+public:
+
+    std::string                    name;
+    double                         weight;
+    bool                           visible;
+    std::map<std::string, int64_t> counters;
+    std::vector<Paragraph>         paragraphs;
+
+    Section() : weight(0), visible(false) {}
+
+    bool operator==(const Section &other) const {
+        return (name == other.name &&
+                weight == other.weight &&
+                visible == other.visible &&
+                counters == other.counters &&
+                paragraphs == other.paragraphs);
+    }
+
+    bool operator!=(const Section &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(name, weight, visible, counters, paragraphs);
+    }
+};
+
+class Document {
+public:
+
+    int64_t                            id;
+    std::string                        title;
+    bool                               published;
+    double                             score;
+    std::map<std::string, std::string> attributes;
+    std::vector<Section>               sections;
+
+    Document() : id(0), published(false), score(0) {}
+
+    bool operator==(const Document &other) const {
+        return (id == other.id &&
+                title == other.title &&
+                published == other.published &&
+                score == other.score &&
+                attributes == other.attributes &&
+                sections == other.sections);
+    }
+
+    bool operator!=(const Document &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(id, title, published, score, attributes, sections);
+    }
+};
+
+void to_string(const Document &document, std::string &data);
+void from_string(Document &document, const std::string &data);
+
+} // namespace
+
+#endif
@@ -0,0 +1,22 @@
+#include "cereal/envelope.hpp"
+
+namespace cereal_test {
+
+void
+to_string(const Envelope &envelope, std::string &data)
+{
+    std::ostringstream stream;
+    cereal::BinaryOutputArchive archive(stream);
+    archive(envelope);
+    data = stream.str();
+}
+
+void
+from_string(Envelope &envelope, const std::string &data)
+{
+    std::stringstream stream(data);
+    cereal::BinaryInputArchive archive(stream);
+    archive(envelope);
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+#ifndef __CEREAL_ENVELOPE_HPP_INCLUDED__
+#define __CEREAL_ENVELOPE_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <boost/variant.hpp>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/boost_variant.hpp>
+
+namespace cereal_test {
+
+// One class per message type, which the variant tells apart.
+template <int Type>
+class Message {
+public:
+
+    int64_t              id;
+    std::string          name;
+    std::vector<int64_t> values;
+
+    Message() : id(0) {}
+
+    bool operator==(const Message &other) const {
+        return (id == other.id &&
+                name == other.name &&
+                values == other.values);
+    }
+
+    bool operator!=(const Message &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(id);
+        archive(name);
+        archive(values);
+    }
+};
+
+typedef boost::variant<Message<0>,
+                       Message<1>,
+                       Message<2>,
+                       Message<3>,
+                       Message<4>,
+                       Message<5>,
+                       Message<6>,
+                       Message<7>,
+                       Message<8>,
+                       Message<9>,
+                       Message<10>,
+                       Message<11>,
+                       Message<12>,
+                       Message<13>,
+                       Message<14>,
+                       Message<15>> Body;
+
+class Envelope {
+public:
+
+    int64_t sequence;
+    Body    body;
+
+    Envelope() : sequence(0) {}
+
+    bool operator==(const Envelope &other) const {
+        return (sequence == other.sequence &&
+                body == other.body);
+    }
+
+    bool operator!=(const Envelope &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(sequence);
+        archive(body);
+    }
+};
+
+void to_string(const Envelope &envelope, std::string &data);
+void from_string(Envelope &envelope, const std::string &data);
+
+} // namespace
+
+#endif
@@ -0,0 +1,61 @@
+#include "cereal/graph.hpp"
+
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::WeightNode<true>, "WeightNode")
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::TextNode<true>, "TextNode")
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::SeriesNode<true>, "SeriesNode")
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::WeightNode<false>, "UntrackedWeightNode")
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::TextNode<false>, "UntrackedTextNode")
+CEREAL_REGISTER_TYPE_WITH_NAME(cereal_test::SeriesNode<false>, "UntrackedSeriesNode")
+
+namespace cereal_test {
+
+namespace {
+
+template <typename Graph>
+void
+save(const Graph &graph, std::string &data)
+{
+    std::ostringstream stream;
+    cereal::BinaryOutputArchive archive(stream);
+    archive(graph);
+    data = stream.str();
+}
+
+template <typename Graph>
+void
+load(Graph &graph, const std::string &data)
+{
+    graph.clear();
+
+    std::stringstream stream(data);
+    cereal::BinaryInputArchive archive(stream);
+    archive(graph);
+}
+
+} // namespace
+
+void
+to_string(const Graph<true> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+to_string(const Graph<false> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+from_string(Graph<true> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+void
+from_string(Graph<false> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+} // namespace
@@ -0,0 +1,167 @@
+#ifndef __CEREAL_GRAPH_HPP_INCLUDED__
+#define __CEREAL_GRAPH_HPP_INCLUDED__
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <type_traits>
+
+#include <stdint.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/base_class.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/memory.hpp>
+#include <cereal/types/polymorphic.hpp>
+
+namespace cereal_test {
+
+// A node of the object graph, serialized through a pointer to Node and
+// told apart from the other kinds by its registered name. A tracked node
+// (Tracked set) holds its children and its links to other nodes as shared
+// pointers, which cereal tracks, so that a node may be reached several
+// times and a link may point back to an ancestor. An untracked one owns its
+// children through unique pointers, which cereal never tracks, and refers
+// to other nodes by id.
+template <bool Tracked>
+class Node {
+public:
+
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, std::unique_ptr<Node> >::type Pointer;
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, int64_t>::type Link;
+
+    int64_t              id;
+    std::vector<Pointer> children;
+    std::vector<Link>    links;
+
+    Node() : id(0) {}
+    virtual ~Node() {}
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(id);
+        archive(children);
+        archive(links);
+    }
+};
+
+template <bool Tracked>
+class WeightNode : public Node<Tracked> {
+public:
+
+    double weight;
+
+    WeightNode() : weight(0) {}
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(cereal::base_class<Node<Tracked> >(this));
+        archive(weight);
+    }
+};
+
+template <bool Tracked>
+class TextNode : public Node<Tracked> {
+public:
+
+    std::string text;
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(cereal::base_class<Node<Tracked> >(this));
+        archive(text);
+    }
+};
+
+template <bool Tracked>
+class SeriesNode : public Node<Tracked> {
+public:
+
+    std::vector<int64_t> values;
+
+private:
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(cereal::base_class<Node<Tracked> >(this));
+        archive(values);
+    }
+};
+
+template <bool Tracked>
+class Graph {
+public:
+
+    typedef Node<Tracked>       NodeType;
+    typedef WeightNode<Tracked> WeightType;
+    typedef TextNode<Tracked>   TextType;
+    typedef SeriesNode<Tracked> SeriesType;
+
+    typedef typename NodeType::Pointer Pointer;
+
+    Pointer root;
+
+    Graph() {}
+
+    ~Graph() {
+        clear();
+    }
+
+    // The links are dropped before the nodes, as those of a tracked graph
+    // make cycles of shared pointers.
+    void clear() {
+        if (root) {
+            release(*root);
+        }
+        root.reset();
+    }
+
+private:
+
+    Graph(const Graph &);
+    Graph &operator=(const Graph &);
+
+    static void release(NodeType &node) {
+        node.links.clear();
+        for (size_t i = 0; i < node.children.size(); i++) {
+            release(*node.children[i]);
+        }
+    }
+
+    friend class cereal::access;
+
+    template<typename Archive>
+    void serialize(Archive &archive)
+    {
+        archive(root);
+    }
+};
+
+void to_string(const Graph<true> &graph, std::string &data);
+void to_string(const Graph<false> &graph, std::string &data);
+void from_string(Graph<true> &graph, const std::string &data);
+void from_string(Graph<false> &graph, const std::string &data);
+
+} // namespace
+
+#endif
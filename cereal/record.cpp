@@ -1,4 +1,5 @@
 #include "cereal/record.hpp"
+#include "string_buffer.hpp"
 
 namespace cereal_test {
 
@@ -19,4 +20,24 @@ from_string(Record &record, const std::string &data)
     archive(record);
 }
 
+void
+to_buffer(const Record &record, std::string &data)
+{
+    data.clear();
+
+    StringOutputBuffer buffer(data);
+    std::ostream stream(&buffer);
+    cereal::BinaryOutputArchive archive(stream);
+    archive(record);
+}
+
+void
+from_buffer(Record &record, const std::string &data)
+{
+    StringInputBuffer buffer(data);
+    std::istream stream(&buffer);
+    cereal::BinaryInputArchive archive(stream);
+    archive(record);
+}
+
 } // namespace
@@ -0,0 +1,22 @@
+#include "cereal/simulation.hpp"
+
+namespace cereal_test {
+
+void
+to_string(const Simulation &simulation, std::string &data)
+{
+    std::ostringstream stream;
+    cereal::BinaryOutputArchive archive(stream);
+    archive(simulation);
+    data = stream.str();
+}
+
+void
+from_string(Simulation &simulation, const std::string &data)
+{
+    std::stringstream stream(data);
+    cereal::BinaryInputArchive archive(stream);
+    archive(simulation);
+}
+
+} // namespace
@@ -0,0 +1,22 @@
+#include "cereal/sparse_record.hpp"
+
+namespace cereal_test {
+
+void
+to_string(const SparseRecord &record, std::string &data)
+{
+    std::ostringstream stream;
+    cereal::BinaryOutputArchive archive(stream);
+    archive(record);
+    data = stream.str();
+}
+
+void
+from_string(SparseRecord &record, const std::string &data)
+{
+    std::stringstream stream(data);
+    cereal::BinaryInputArchive archive(stream);
+    archive(record);
+}
+
+} // namespace
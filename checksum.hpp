@@ -0,0 +1,60 @@
+#ifndef __CHECKSUM_HPP_INCLUDED__
+#define __CHECKSUM_HPP_INCLUDED__
+
+#include <string>
+
+#include <stdint.h>
+
+// A checksum of the ids and string bytes a decoder hands out, which forces
+// every one of them to be read. The bytes of a string are summed, so that
+// the loop vectorizes, and the sums are mixed in FNV-1a style with the ids
+// and the string lengths, so that the order of the values counts.
+class Checksum {
+public:
+
+    Checksum() : value_(14695981039346656037ULL) {}
+
+    void add(int64_t id) {
+        mix(static_cast<uint64_t>(id));
+    }
+
+    void add(const char *data, size_t size) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; i++) {
+            sum += static_cast<unsigned char>(data[i]);
+        }
+        mix(sum);
+        mix(size);
+    }
+
+    uint64_t value() const {
+        return value_;
+    }
+
+private:
+
+    void mix(uint64_t value) {
+        value_ = (value_ ^ value) * 1099511628211ULL;
+    }
+
+    uint64_t value_;
+};
+
+// The checksum of the ids and then the strings of `record`, a Payload or
+// any record keeping them in vectors, which a decoder reading them in order
+// must reproduce.
+template <typename Record>
+inline uint64_t
+checksum(const Record &record)
+{
+    Checksum result;
+    for (size_t i = 0; i < record.ids.size(); i++) {
+        result.add(record.ids[i]);
+    }
+    for (size_t i = 0; i < record.strings.size(); i++) {
+        result.add(record.strings[i].data(), record.strings[i].size());
+    }
+    return result.value();
+}
+
+#endif
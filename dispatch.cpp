@@ -0,0 +1,665 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+
+#include <hpx/config.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/variant.hpp>
+#include <boost/mpl/at.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/envelope_types.h"
+#include "thrift/gen-cpp/envelope_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/envelope.pb.h"
+#include "capnproto/envelope.capnp.h"
+#include "boost/envelope.hpp"
+#include "cereal/envelope.hpp"
+#include "avro/envelope.hpp"
+#include "hpx/envelope.hpp"
+#include "hpx/version.hpp"
+#include "yas/envelope.hpp"
+#include "flatbuffers/envelope_generated.h"
+
+#include "dispatch.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "tests.hpp"
+
+size_t
+EnvelopePayload::bytes() const
+{
+    return 2 * sizeof(int64_t) + name.size() + values.size() * sizeof(int64_t);
+}
+
+std::vector<EnvelopePayload>
+generate_envelopes(size_t count, uint64_t seed)
+{
+    Random random(seed);
+
+    std::vector<EnvelopePayload> result(count);
+
+    for (size_t i = 0; i < count; i++) {
+        EnvelopePayload &envelope = result[i];
+        envelope.sequence = i;
+        envelope.type = random.between(0, kEnvelopeTypes - 1);
+        envelope.id = random.between(0, 1000000000);
+        envelope.name = random.text(8 + envelope.type);
+
+        for (size_t j = 0; j <= envelope.type; j++) {
+            envelope.values.push_back(random.between(-1000000, 1000000));
+        }
+    }
+
+    return result;
+}
+
+std::vector<EnvelopePayload> &
+envelopes()
+{
+    static std::vector<EnvelopePayload> instance;
+    return instance;
+}
+
+size_t
+average_envelope_bytes()
+{
+    if (envelopes().empty()) {
+        return 0;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < envelopes().size(); i++) {
+        total += envelopes()[i].bytes();
+    }
+    return total / envelopes().size();
+}
+
+bool
+Dispatched::operator==(const Dispatched &other) const
+{
+    for (size_t i = 0; i < kEnvelopeTypes; i++) {
+        if (counts[i] != other.counts[i]) {
+            return false;
+        }
+    }
+    return checksum == other.checksum;
+}
+
+Dispatched
+expected_dispatch(const std::vector<EnvelopePayload> &envelopes)
+{
+    Dispatched result;
+
+    for (size_t i = 0; i < envelopes.size(); i++) {
+        const EnvelopePayload &envelope = envelopes[i];
+
+        int64_t sum = 0;
+        for (size_t j = 0; j < envelope.values.size(); j++) {
+            sum += envelope.values[j];
+        }
+
+        result.add(envelope.type, envelope.id, envelope.name.size(), sum);
+    }
+
+    return result;
+}
+
+namespace {
+
+// Runs a backend's test: encode(i) serializes the i-th envelope,
+// decode(i, dispatched) deserializes it and hands its message to the
+// handler of its type, size(i) is its serialized size. Encoding and
+// decoding each cycle through all the envelopes, so that the decoder sees
+// the types in random order.
+template <typename Encode, typename Decode, typename Size>
+void
+envelope_test(size_t iterations, const std::string &name, const std::string &version,
+              Encode encode, Decode decode, Size size)
+{
+    const size_t count = envelopes().size();
+
+    for (size_t i = 0; i < count; i++) {
+        encode(i);
+    }
+
+    Dispatched dispatched;
+    size_t encoded = 0;
+    size_t decoded = 0;
+
+    // the envelope decoded last, dispatched again on its own
+    auto check_last = [&] {
+        size_t last = decoded > 0 ? decoded - 1 : count - 1;
+
+        Dispatched again;
+        decode(last, again);
+
+        if (again != expected_dispatch(std::vector<EnvelopePayload>(1, envelopes()[last]))) {
+            throw std::logic_error(name + "'s case: dispatch failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            encode(encoded);
+            encoded = encoded + 1 < count ? encoded + 1 : 0;
+        },
+        [&] {
+            decode(decoded, dispatched);
+            decoded = decoded + 1 < count ? decoded + 1 : 0;
+        },
+        check_last);
+
+    Dispatched check;
+    for (size_t i = 0; i < count; i++) {
+        decode(i, check);
+    }
+
+    if (check != expected_dispatch(envelopes())) {
+        throw std::logic_error(name + "'s case: dispatch failed");
+    }
+
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < count; i++) {
+        sizes.push_back(size(i));
+    }
+
+    print_timings(name, version, timings, sizes);
+}
+
+// Copies an envelope's message into a message type with id, name and
+// values members.
+template <typename Message>
+Message
+message_of(const EnvelopePayload &envelope)
+{
+    Message message;
+    message.id = envelope.id;
+    message.name = envelope.name;
+    message.values.assign(envelope.values.begin(), envelope.values.end());
+    return message;
+}
+
+// The handler of thrift's, avro's and the hand-written serializers'
+// messages, which have id, name and values members.
+template <typename Message>
+void
+handle(Dispatched &dispatched, size_t type, const Message &message)
+{
+    int64_t sum = 0;
+    for (size_t i = 0; i < message.values.size(); i++) {
+        sum += message.values[i];
+    }
+
+    dispatched.add(type, message.id, message.name.size(), sum);
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+void
+thrift_envelope_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    std::vector<Envelope> natives(envelopes().size());
+    std::vector<std::string> serialized(natives.size());
+
+    for (size_t i = 0; i < natives.size(); i++) {
+        const EnvelopePayload &envelope = envelopes()[i];
+        natives[i].sequence = envelope.sequence;
+
+        switch (envelope.type) {
+#define THRIFT_SET(k) \
+        case k: natives[i].body.__set_m##k(message_of<Message##k>(envelope)); break;
+        ENVELOPE_TYPES(THRIFT_SET)
+#undef THRIFT_SET
+        }
+    }
+
+    std::string tag = proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    Envelope envelope;
+
+    envelope_test(iterations, tag, VERSION,
+        [&](size_t i) {
+            buffer1->resetBuffer();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                natives[i].write(&binary_protocol1);
+            } else {
+                natives[i].write(&compact_protocol1);
+            }
+
+            serialized[i] = buffer1->getBufferAsString();
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            buffer2->resetBuffer((uint8_t*)serialized[i].data(), serialized[i].length());
+
+            // a union's read doesn't clear the member set by an earlier one
+            envelope.body.__isset = _Body__isset();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                envelope.read(&binary_protocol2);
+            } else {
+                envelope.read(&compact_protocol2);
+            }
+
+            // a thrift union is a struct of optional fields, the one set
+            // is found by testing them in turn
+#define THRIFT_CASE(k) \
+            if (envelope.body.__isset.m##k) { handle(dispatched, k, envelope.body.m##k); } else
+            ENVELOPE_TYPES(THRIFT_CASE)
+#undef THRIFT_CASE
+            {
+                throw std::logic_error("thrift's case: empty union");
+            }
+        },
+        [&](size_t i) {
+            return serialized[i].size();
+        });
+}
+
+template <typename Message>
+void
+fill_protobuf(Message *message, const EnvelopePayload &envelope)
+{
+    message->set_id(envelope.id);
+    message->set_name(envelope.name);
+
+    for (size_t j = 0; j < envelope.values.size(); j++) {
+        message->add_values(envelope.values[j]);
+    }
+}
+
+template <typename Message>
+void
+handle_protobuf(Dispatched &dispatched, size_t type, const Message &message)
+{
+    int64_t sum = 0;
+    for (int j = 0; j < message.values_size(); j++) {
+        sum += message.values(j);
+    }
+
+    dispatched.add(type, message.id(), message.name().size(), sum);
+}
+
+void
+protobuf_envelope_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    std::vector<Envelope> natives(envelopes().size());
+    std::vector<std::string> serialized(natives.size());
+
+    for (size_t i = 0; i < natives.size(); i++) {
+        const EnvelopePayload &envelope = envelopes()[i];
+        natives[i].set_sequence(envelope.sequence);
+
+        switch (envelope.type) {
+#define PROTOBUF_SET(k) \
+        case k: fill_protobuf(natives[i].mutable_m##k(), envelope); break;
+        ENVELOPE_TYPES(PROTOBUF_SET)
+#undef PROTOBUF_SET
+        }
+    }
+
+    Envelope envelope;
+
+    envelope_test(iterations, "protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION),
+        [&](size_t i) {
+            serialized[i].clear();
+            natives[i].SerializeToString(&serialized[i]);
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            envelope.ParseFromString(serialized[i]);
+
+            switch (envelope.body_case()) {
+#define PROTOBUF_CASE(k) \
+            case Envelope::kM##k: handle_protobuf(dispatched, k, envelope.m##k()); break;
+            ENVELOPE_TYPES(PROTOBUF_CASE)
+#undef PROTOBUF_CASE
+            default:
+                throw std::logic_error("protobuf's case: empty oneof");
+            }
+        },
+        [&](size_t i) {
+            return serialized[i].size();
+        });
+}
+
+template <typename Reader>
+void
+handle_capnp(Dispatched &dispatched, size_t type, Reader message)
+{
+    int64_t sum = 0;
+    for (auto value : message.getValues()) {
+        sum += value;
+    }
+
+    dispatched.add(type, message.getId(), message.getName().size(), sum);
+}
+
+template <typename Builder>
+void
+fill_capnp(Builder message, const EnvelopePayload &envelope)
+{
+    message.setId(envelope.id);
+    message.setName(envelope.name);
+
+    auto values = message.initValues(envelope.values.size());
+    for (size_t j = 0; j < envelope.values.size(); j++) {
+        values.set(j, envelope.values[j]);
+    }
+}
+
+void
+capnproto_envelope_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    typedef kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> Segments;
+
+    std::vector<std::unique_ptr<capnp::MallocMessageBuilder>> messages;
+    std::vector<Segments> serialized(envelopes().size());
+
+    for (size_t i = 0; i < envelopes().size(); i++) {
+        const EnvelopePayload &envelope = envelopes()[i];
+
+        messages.emplace_back(new capnp::MallocMessageBuilder());
+        Envelope::Builder builder = messages.back()->initRoot<Envelope>();
+        builder.setSequence(envelope.sequence);
+
+        switch (envelope.type) {
+#define CAPNP_SET(k) \
+        case k: fill_capnp(builder.initM##k(), envelope); break;
+        ENVELOPE_TYPES(CAPNP_SET)
+#undef CAPNP_SET
+        }
+    }
+
+    // as in the Record test, encoding is getting the segments of a built
+    // message
+    envelope_test(iterations, "capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION),
+        [&](size_t i) {
+            serialized[i] = messages[i]->getSegmentsForOutput();
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            capnp::SegmentArrayMessageReader reader(serialized[i]);
+            Envelope::Reader envelope = reader.getRoot<Envelope>();
+
+            switch (envelope.which()) {
+#define CAPNP_CASE(k) \
+            case Envelope::M##k: handle_capnp(dispatched, k, envelope.getM##k()); break;
+            ENVELOPE_TYPES(CAPNP_CASE)
+#undef CAPNP_CASE
+            default:
+                throw std::logic_error("capnproto's case: unknown union member");
+            }
+        },
+        [&](size_t i) {
+            size_t size = 0;
+            for (auto segment: serialized[i]) {
+                size += segment.asBytes().size();
+            }
+            return size;
+        });
+}
+
+class VariantHandler : public boost::static_visitor<> {
+public:
+
+    VariantHandler(Dispatched &dispatched, size_t type) : dispatched_(dispatched), type_(type) {}
+
+    template <typename Message>
+    void operator()(const Message &message) const {
+        handle(dispatched_, type_, message);
+    }
+
+private:
+
+    Dispatched &dispatched_;
+    size_t type_;
+};
+
+// Runs the test of a hand-written serializer, whose Body is a
+// boost::variant of Message<0> .. Message<15>.
+template <typename Envelope, typename ToString, typename FromString>
+void
+variant_envelope_test(size_t iterations, const std::string &name, const std::string &version,
+                      ToString to_string, FromString from_string)
+{
+    typedef typename decltype(Envelope().body)::types Types;
+
+    std::vector<Envelope> natives(envelopes().size());
+    std::vector<std::string> serialized(natives.size());
+
+    for (size_t i = 0; i < natives.size(); i++) {
+        const EnvelopePayload &envelope = envelopes()[i];
+        natives[i].sequence = envelope.sequence;
+
+        switch (envelope.type) {
+#define VARIANT_SET(k) \
+        case k: natives[i].body = message_of<typename boost::mpl::at_c<Types, k>::type>(envelope); break;
+        ENVELOPE_TYPES(VARIANT_SET)
+#undef VARIANT_SET
+        }
+    }
+
+    Envelope envelope;
+
+    envelope_test(iterations, name, version,
+        [&](size_t i) {
+            serialized[i].clear();
+            to_string(natives[i], serialized[i]);
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            from_string(envelope, serialized[i]);
+            boost::apply_visitor(VariantHandler(dispatched, envelope.body.which()), envelope.body);
+        },
+        [&](size_t i) {
+            return serialized[i].size();
+        });
+}
+
+void
+boost_envelope_test(size_t iterations)
+{
+    variant_envelope_test<boost_test::Envelope>(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION),
+        [](const boost_test::Envelope &e, std::string &s) { boost_test::to_string(e, s); },
+        [](boost_test::Envelope &e, const std::string &s) { boost_test::from_string(e, s); });
+}
+
+void
+cereal_envelope_test(size_t iterations)
+{
+    variant_envelope_test<cereal_test::Envelope>(iterations, "cereal", "",
+        [](const cereal_test::Envelope &e, std::string &s) { cereal_test::to_string(e, s); },
+        [](cereal_test::Envelope &e, const std::string &s) { cereal_test::from_string(e, s); });
+}
+
+void
+hpx_envelope_test(size_t iterations)
+{
+    variant_envelope_test<hpx_test::Envelope>(iterations, "hpx", hpx::full_version_as_string(),
+        [](const hpx_test::Envelope &e, std::string &s) { hpx_test::to_string(e, s); },
+        [](hpx_test::Envelope &e, const std::string &s) { hpx_test::from_string(e, s); });
+}
+
+void
+yas_envelope_test(size_t iterations)
+{
+    variant_envelope_test<yas_test::Envelope>(iterations, "yas", "",
+        [](const yas_test::Envelope &e, std::string &s) { yas_test::to_string(e, s); },
+        [](yas_test::Envelope &e, const std::string &s) { yas_test::from_string(e, s); });
+}
+
+void
+avro_envelope_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    std::vector<Envelope> natives(envelopes().size());
+    std::vector<std::unique_ptr<avro::OutputStream>> serialized(natives.size());
+
+    for (size_t i = 0; i < natives.size(); i++) {
+        const EnvelopePayload &envelope = envelopes()[i];
+        natives[i].sequence = envelope.sequence;
+
+        switch (envelope.type) {
+#define AVRO_SET(k) \
+        case k: natives[i].body.set_Message##k(message_of<Message##k>(envelope)); break;
+        ENVELOPE_TYPES(AVRO_SET)
+#undef AVRO_SET
+        }
+    }
+
+    Envelope envelope;
+
+    envelope_test(iterations, "avro", "",
+        [&](size_t i) {
+            serialized[i].reset(avro::memoryOutputStream().release());
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*serialized[i]);
+            avro::encode(*encoder, natives[i]);
+            encoder->flush();
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            auto in = avro::memoryInputStream(*serialized[i]);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+            avro::decode(*decoder, envelope);
+
+            switch (envelope.body.idx()) {
+#define AVRO_CASE(k) \
+            case k: handle(dispatched, k, envelope.body.get_Message##k()); break;
+            ENVELOPE_TYPES(AVRO_CASE)
+#undef AVRO_CASE
+            default:
+                throw std::logic_error("avro's case: unknown union branch");
+            }
+        },
+        [&](size_t i) {
+            return serialized[i]->byteCount();
+        });
+}
+
+template <typename Message>
+void
+handle_flatbuffers(Dispatched &dispatched, size_t type, const void *table)
+{
+    const Message *message = static_cast<const Message*>(table);
+
+    int64_t sum = 0;
+    for (flatbuffers::uoffset_t j = 0; j < message->values()->size(); j++) {
+        sum += message->values()->Get(j);
+    }
+
+    dispatched.add(type, message->id(), message->name()->size(), sum);
+}
+
+void
+flatbuffers_envelope_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<std::vector<char>> serialized(envelopes().size());
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // as in the Record test, encoding is building the message and copying
+    // it out
+    envelope_test(iterations, "flatbuffers", version,
+        [&](size_t i) {
+            const EnvelopePayload &envelope = envelopes()[i];
+
+            builder.Clear();
+
+            auto name = builder.CreateString(envelope.name);
+            auto values = builder.CreateVector(envelope.values);
+
+            flatbuffers::Offset<void> body;
+            switch (envelope.type) {
+#define FLATBUFFERS_SET(k) \
+            case k: body = CreateMessage##k(builder, envelope.id, name, values).Union(); break;
+            ENVELOPE_TYPES(FLATBUFFERS_SET)
+#undef FLATBUFFERS_SET
+            }
+
+            builder.Finish(CreateEnvelope(builder, envelope.sequence,
+                                          static_cast<Body>(Body_Message0 + envelope.type), body));
+
+            auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+            auto sz = builder.GetSize();
+            serialized[i].assign(p, p + sz);
+
+            builder.ReleaseBufferPointer();
+        },
+        [&](size_t i, Dispatched &dispatched) {
+            auto envelope = GetEnvelope(serialized[i].data());
+
+            switch (envelope->body_type()) {
+#define FLATBUFFERS_CASE(k) \
+            case Body_Message##k: handle_flatbuffers<Message##k>(dispatched, k, envelope->body()); break;
+            ENVELOPE_TYPES(FLATBUFFERS_CASE)
+#undef FLATBUFFERS_CASE
+            default:
+                throw std::logic_error("flatbuffer's case: unknown union type");
+            }
+        },
+        [&](size_t i) {
+            return serialized[i].size();
+        });
+}
+
+} // namespace
+
+Tests
+envelope_tests()
+{
+    Tests tests = {
+        {"thrift-binary",
+         [](size_t n) { thrift_envelope_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_envelope_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_envelope_test, true},
+        {"capnproto", capnproto_envelope_test, true},
+        {"boost", boost_envelope_test, true},
+        {"cereal", cereal_envelope_test, true},
+        {"avro", avro_envelope_test, true},
+        {"hpx", hpx_envelope_test, true},
+        {"yas", yas_envelope_test, true},
+        {"flatbuffers", flatbuffers_envelope_test, true},
+    };
+
+    return tests;
+}
@@ -0,0 +1,71 @@
+#ifndef __DISPATCH_HPP_INCLUDED__
+#define __DISPATCH_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// The envelope schema's tests (--schema=envelope) decode envelopes holding
+// one of 16 message types, in a random order, and dispatch each message to
+// the handler of its type. Message types k = 0 .. 15 are named Message<k>
+// in the IDLs and their union members m<k>.
+const size_t kEnvelopeTypes = 16;
+
+// Number of envelopes the tests cycle through.
+const size_t kEnvelopes = 1024;
+
+// Expands X(k) for every message type k, for the code that has to name
+// each member of the generated unions.
+#define ENVELOPE_TYPES(X) \
+    X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) \
+    X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15)
+
+struct EnvelopePayload {
+    int64_t              sequence;
+    size_t               type;
+    int64_t              id;
+    std::string          name;
+    std::vector<int64_t> values;
+
+    EnvelopePayload() : sequence(0), type(0), id(0) {}
+
+    // Size of the raw data: 8 bytes per integer plus the name's characters.
+    size_t bytes() const;
+};
+
+// Generates `count` envelopes of random types from `seed`. Messages of
+// type k have a name of 8 + k characters and k + 1 values.
+std::vector<EnvelopePayload> generate_envelopes(size_t count, uint64_t seed);
+
+// The envelopes shared by the envelope schema's tests.
+std::vector<EnvelopePayload> &envelopes();
+
+// Mean raw size of envelopes().
+size_t average_envelope_bytes();
+
+// What the handlers saw: the number of messages of every type and a sum of
+// the fields they read.
+struct Dispatched {
+    uint64_t counts[kEnvelopeTypes];
+    uint64_t checksum;
+
+    Dispatched() : counts(), checksum(0) {}
+
+    // Called by the handler of every type with the fields it read.
+    void add(size_t type, int64_t id, size_t name_size, int64_t values_sum) {
+        counts[type]++;
+        checksum += static_cast<uint64_t>(id) + name_size + static_cast<uint64_t>(values_sum);
+    }
+
+    bool operator==(const Dispatched &other) const;
+
+    bool operator!=(const Dispatched &other) const {
+        return !(*this == other);
+    }
+};
+
+// What dispatching every envelope of `envelopes` once adds up to.
+Dispatched expected_dispatch(const std::vector<EnvelopePayload> &envelopes);
+
+#endif
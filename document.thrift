@@ -0,0 +1,25 @@
+namespace cpp thrift_test
+
+struct Paragraph {
+    1: required string              text,
+    2: required bool                highlighted,
+    3: required list<i64>           offsets,
+    4: required map<string, double> weights
+}
+
+struct Section {
+    1: required string              name,
+    2: required double              weight,
+    3: required bool                visible,
+    4: required map<string, i64>    counters,
+    5: required list<Paragraph>     paragraphs
+}
+
+struct Document {
+    1: required i64                 id,
+    2: required string              title,
+    3: required bool                published,
+    4: required double              score,
+    5: required map<string, string> attributes,
+    6: required list<Section>       sections
+}
@@ -0,0 +1,125 @@
+namespace cpp thrift_test
+
+// Message types share their fields, what differs from one to the next is
+// the length of the name and of the values in the generated workload.
+
+struct Message0 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message1 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message2 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message3 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message4 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message5 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message6 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message7 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message8 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message9 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message10 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message11 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message12 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message13 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message14 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+struct Message15 {
+    1: required i64       id,
+    2: required string    name,
+    3: required list<i64> values
+}
+
+// Thrift unions are structs of optional fields of which one is set.
+union Body {
+    1: Message0 m0,
+    2: Message1 m1,
+    3: Message2 m2,
+    4: Message3 m3,
+    5: Message4 m4,
+    6: Message5 m5,
+    7: Message6 m6,
+    8: Message7 m7,
+    9: Message8 m8,
+    10: Message9 m9,
+    11: Message10 m10,
+    12: Message11 m11,
+    13: Message12 m12,
+    14: Message13 m13,
+    15: Message14 m14,
+    16: Message15 m15
+}
+
+struct Envelope {
+    1: required i64  sequence,
+    2: required Body body
+}
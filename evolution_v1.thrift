@@ -0,0 +1,12 @@
+namespace cpp thrift_v1
+
+// The first version of an evolving record. Fields that come and go between
+// versions have to be optional, a missing required field fails the read.
+
+struct Record {
+    1: required i64          id,
+    2: required string       name,
+    3: required list<i64>    ids,
+    4: required list<string> strings,
+    5: optional i32          legacy
+}
@@ -0,0 +1,15 @@
+namespace cpp thrift_v2
+
+// The second version of the evolving record: legacy (5) is gone, timestamp
+// and tags are new and the remaining fields are declared in another order,
+// which the wire doesn't show as fields are written by id. A reader skips
+// the fields it doesn't know.
+
+struct Record {
+    4: required list<string> strings,
+    3: required list<i64>    ids,
+    2: required string       name,
+    1: required i64          id,
+    6: optional i64          timestamp,
+    7: optional list<string> tags
+}
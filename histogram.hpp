@@ -0,0 +1,114 @@
+#ifndef __HISTOGRAM_HPP_INCLUDED__
+#define __HISTOGRAM_HPP_INCLUDED__
+
+#include <algorithm>
+#include <cmath>
+
+#include <stdint.h>
+#include <string.h>
+
+// Log-linear latency histogram in the spirit of HdrHistogram. Values below
+// 64 get a bucket each, above that every power of two is split into 32
+// linear sub-buckets, so a recorded value is known to within ~3%. Values are
+// tracked up to 2^40 (about 18 minutes in nanoseconds) in 1152 counters,
+// and recording touches a single counter, which keeps the histogram out of
+// the way of the code being measured.
+class Histogram {
+public:
+
+    static const unsigned kSubBucketBits = 5;
+    static const unsigned kMaxValueBits  = 40;
+    static const uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+    static const uint64_t kMaxValue = (uint64_t(1) << kMaxValueBits) - 1;
+    static const size_t   kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+    Histogram() {
+        reset();
+    }
+
+    void reset() {
+        memset(counts_, 0, sizeof(counts_));
+        count_ = 0;
+        min_ = kMaxValue;
+        max_ = 0;
+    }
+
+    void record(uint64_t value) {
+        if (value > kMaxValue) {
+            value = kMaxValue;
+        }
+        counts_[index_of(value)]++;
+        count_++;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const Histogram &other) {
+        for (size_t i = 0; i < kBucketCount; i++) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const {
+        return count_;
+    }
+
+    uint64_t min() const {
+        return count_ == 0 ? 0 : min_;
+    }
+
+    uint64_t max() const {
+        return max_;
+    }
+
+    // Smallest recorded value (rounded up to its bucket's upper bound) that
+    // is greater than or equal to `percentile` percent of all values.
+    uint64_t percentile(double percentile) const {
+        if (count_ == 0) {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; i++) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highest_equivalent(i), max_);
+            }
+        }
+
+        return max_;
+    }
+
+private:
+
+    static size_t index_of(uint64_t value) {
+        if (value < 2 * kSubBucketCount) {
+            return static_cast<size_t>(value);
+        }
+        unsigned msb = 63 - __builtin_clzll(value);
+        unsigned shift = msb - kSubBucketBits;
+        return shift * kSubBucketCount + static_cast<size_t>(value >> shift);
+    }
+
+    static uint64_t highest_equivalent(size_t index) {
+        if (index < 2 * kSubBucketCount) {
+            return index;
+        }
+        unsigned shift = static_cast<unsigned>(index / kSubBucketCount) - 1;
+        uint64_t top = index % kSubBucketCount + kSubBucketCount;
+        return ((top + 1) << shift) - 1;
+    }
+
+    uint64_t counts_[kBucketCount];
+    uint64_t count_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+#endif
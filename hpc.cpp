@@ -0,0 +1,689 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <string.h>
+
+#include <hpx/config.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/simulation_types.h"
+#include "thrift/gen-cpp/simulation_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/simulation.pb.h"
+#include "capnproto/simulation.capnp.h"
+#include "boost/simulation.hpp"
+#include "msgpack/simulation.hpp"
+#include "cereal/simulation.hpp"
+#include "avro/simulation.hpp"
+#include "hpx/simulation.hpp"
+#include "hpx_zero_copy/simulation.hpp"
+#include "hpx/version.hpp"
+#ifdef WITH_MPI
+#include "mpi/simulation.hpp"
+#endif
+#include "yas/simulation.hpp"
+#include "reflect/simulation.hpp"
+#include "flatbuffers/simulation_generated.h"
+
+#include "hpc.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "tests.hpp"
+
+size_t
+SimulationPayload::bytes() const
+{
+    return samples.size() * sizeof(double) +
+           particles.size() * (3 * sizeof(double) + sizeof(int32_t)) +
+           matrix.size() * sizeof(float) + sizeof(rows) + sizeof(columns);
+}
+
+SimulationPayload
+generate_simulation(uint64_t seed)
+{
+    Random random(seed);
+
+    SimulationPayload result;
+
+    result.samples.resize(kSamples);
+    for (size_t i = 0; i < kSamples; i++) {
+        result.samples[i] = random.fraction() * 2 - 1;
+    }
+
+    result.particles.resize(kParticles);
+    for (size_t i = 0; i < kParticles; i++) {
+        ParticlePayload &particle = result.particles[i];
+        particle.x = random.fraction() * 100;
+        particle.y = random.fraction() * 100;
+        particle.z = random.fraction() * 100;
+        particle.id = i;
+    }
+
+    result.rows = kMatrixRows;
+    result.columns = kMatrixColumns;
+    result.matrix.resize(kMatrixRows * kMatrixColumns);
+    for (size_t i = 0; i < result.matrix.size(); i++) {
+        result.matrix[i] = static_cast<float>(random.fraction());
+    }
+
+    return result;
+}
+
+SimulationPayload &
+simulation()
+{
+    static SimulationPayload instance;
+    return instance;
+}
+
+namespace {
+
+// Copies a simulation step into, and back out of, the types of thrift, avro
+// and the hand-written serializers, which all share the field names of
+// SimulationPayload with the matrix kept apart. Thrift's matrix is made of
+// doubles, which hold the floats exactly.
+template <typename Simulation>
+void
+assign(Simulation &simulation, const SimulationPayload &data)
+{
+    simulation.samples.assign(data.samples.begin(), data.samples.end());
+
+    simulation.particles.resize(data.particles.size());
+    for (size_t i = 0; i < data.particles.size(); i++) {
+        simulation.particles[i].x = data.particles[i].x;
+        simulation.particles[i].y = data.particles[i].y;
+        simulation.particles[i].z = data.particles[i].z;
+        simulation.particles[i].id = data.particles[i].id;
+    }
+
+    simulation.matrix.rows = data.rows;
+    simulation.matrix.columns = data.columns;
+    simulation.matrix.values.assign(data.matrix.begin(), data.matrix.end());
+}
+
+template <typename Simulation>
+SimulationPayload
+payload_of(const Simulation &simulation)
+{
+    SimulationPayload result;
+
+    result.samples.assign(simulation.samples.begin(), simulation.samples.end());
+
+    result.particles.resize(simulation.particles.size());
+    for (size_t i = 0; i < simulation.particles.size(); i++) {
+        result.particles[i].x = simulation.particles[i].x;
+        result.particles[i].y = simulation.particles[i].y;
+        result.particles[i].z = simulation.particles[i].z;
+        result.particles[i].id = simulation.particles[i].id;
+    }
+
+    result.rows = simulation.matrix.rows;
+    result.columns = simulation.matrix.columns;
+    result.matrix.assign(simulation.matrix.values.begin(), simulation.matrix.values.end());
+
+    return result;
+}
+
+// The baseline: every array copied with memcpy() after its size, into a
+// buffer that is reused from one iteration to the next, and back.
+template <typename T>
+void
+put(std::string &buffer, size_t &offset, const std::vector<T> &values)
+{
+    uint64_t size = values.size();
+    memcpy(&buffer[offset], &size, sizeof(size));
+    memcpy(&buffer[offset + sizeof(size)], values.data(), size * sizeof(T));
+    offset += sizeof(size) + size * sizeof(T);
+}
+
+template <typename T>
+void
+get(const std::string &buffer, size_t &offset, std::vector<T> &values)
+{
+    uint64_t size = 0;
+    memcpy(&size, &buffer[offset], sizeof(size));
+    values.resize(size);
+    memcpy(values.data(), &buffer[offset + sizeof(size)], size * sizeof(T));
+    offset += sizeof(size) + size * sizeof(T);
+}
+
+void
+memcpy_hpc_test(size_t iterations)
+{
+    const SimulationPayload &data = simulation();
+    SimulationPayload result;
+
+    std::string serialized(3 * sizeof(uint64_t) + data.samples.size() * sizeof(double) +
+                           data.particles.size() * sizeof(ParticlePayload) + 2 * sizeof(uint32_t) +
+                           data.matrix.size() * sizeof(float), '\0');
+
+    auto check = [&] {
+        if (result != data) {
+            throw std::logic_error("memcpy's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            size_t offset = 0;
+            put(serialized, offset, data.samples);
+            put(serialized, offset, data.particles);
+            memcpy(&serialized[offset], &data.rows, sizeof(data.rows));
+            memcpy(&serialized[offset + sizeof(data.rows)], &data.columns, sizeof(data.columns));
+            offset += sizeof(data.rows) + sizeof(data.columns);
+            put(serialized, offset, data.matrix);
+        },
+        [&] {
+            size_t offset = 0;
+            get(serialized, offset, result.samples);
+            get(serialized, offset, result.particles);
+            memcpy(&result.rows, &serialized[offset], sizeof(result.rows));
+            memcpy(&result.columns, &serialized[offset + sizeof(result.rows)], sizeof(result.columns));
+            offset += sizeof(result.rows) + sizeof(result.columns);
+            get(serialized, offset, result.matrix);
+        },
+        check);
+
+    check();
+
+    print_timings("memcpy", "", timings, serialized.size());
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+void
+thrift_hpc_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Simulation s1, s2;
+    assign(s1, simulation());
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (payload_of(s2) != simulation()) {
+            throw std::logic_error("thrift's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            buffer1->resetBuffer();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                s1.write(&binary_protocol1);
+            } else {
+                s1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&] {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (proto == ThriftSerializationProto::Binary) {
+                s2.read(&binary_protocol2);
+            } else {
+                s2.read(&compact_protocol2);
+            }
+        },
+        check);
+
+    check();
+
+    std::string tag = proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    print_timings(tag, VERSION, timings, serialized.size());
+}
+
+void
+protobuf_hpc_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    const SimulationPayload &data = simulation();
+
+    Simulation s1, s2;
+
+    s1.mutable_samples()->Reserve(data.samples.size());
+    for (size_t i = 0; i < data.samples.size(); i++) {
+        s1.add_samples(data.samples[i]);
+    }
+
+    for (size_t i = 0; i < data.particles.size(); i++) {
+        Particle *particle = s1.add_particles();
+        particle->set_x(data.particles[i].x);
+        particle->set_y(data.particles[i].y);
+        particle->set_z(data.particles[i].z);
+        particle->set_id(data.particles[i].id);
+    }
+
+    Matrix *matrix = s1.mutable_matrix();
+    matrix->set_rows(data.rows);
+    matrix->set_columns(data.columns);
+    matrix->mutable_values()->Reserve(data.matrix.size());
+    for (size_t i = 0; i < data.matrix.size(); i++) {
+        matrix->add_values(data.matrix[i]);
+    }
+
+    std::string serialized;
+
+    auto check = [&] {
+        SimulationPayload result;
+        result.samples.assign(s2.samples().begin(), s2.samples().end());
+        result.particles.resize(s2.particles_size());
+        for (int i = 0; i < s2.particles_size(); i++) {
+            result.particles[i].x = s2.particles(i).x();
+            result.particles[i].y = s2.particles(i).y();
+            result.particles[i].z = s2.particles(i).z();
+            result.particles[i].id = s2.particles(i).id();
+        }
+        result.rows = s2.matrix().rows();
+        result.columns = s2.matrix().columns();
+        result.matrix.assign(s2.matrix().values().begin(), s2.matrix().values().end());
+
+        if (result != data) {
+            throw std::logic_error("protobuf's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            s1.SerializeToString(&serialized);
+        },
+        [&] {
+            s2.ParseFromString(serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), timings, serialized.size());
+}
+
+void
+capnproto_hpc_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    const SimulationPayload &data = simulation();
+
+    capnp::MallocMessageBuilder message;
+    Simulation::Builder s1 = message.initRoot<Simulation>();
+
+    auto samples = s1.initSamples(data.samples.size());
+    for (size_t i = 0; i < data.samples.size(); i++) {
+        samples.set(i, data.samples[i]);
+    }
+
+    auto particles = s1.initParticles(data.particles.size());
+    for (size_t i = 0; i < data.particles.size(); i++) {
+        Particle::Builder particle = particles[i];
+        particle.setX(data.particles[i].x);
+        particle.setY(data.particles[i].y);
+        particle.setZ(data.particles[i].z);
+        particle.setId(data.particles[i].id);
+    }
+
+    Matrix::Builder matrix = s1.initMatrix();
+    matrix.setRows(data.rows);
+    matrix.setColumns(data.columns);
+    auto values = matrix.initValues(data.matrix.size());
+    for (size_t i = 0; i < data.matrix.size(); i++) {
+        values.set(i, data.matrix[i]);
+    }
+
+    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized =
+        message.getSegmentsForOutput();
+
+    size_t size = 0;
+    for (auto segment: serialized) {
+      size += segment.asBytes().size();
+    }
+
+    // as in the Record test, decoding is opening a reader and reaching the
+    // root's lists
+    size_t decoded = 0;
+
+    auto check = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        Simulation::Reader s2 = reader.getRoot<Simulation>();
+        if (decoded != data.samples.size() + data.particles.size() + data.matrix.size() ||
+            s2.getSamples()[0] != data.samples[0] || s2.getParticles()[0].getX() != data.particles[0].x ||
+            s2.getMatrix().getValues()[0] != data.matrix[0]) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized = message.getSegmentsForOutput();
+        },
+        [&] {
+            capnp::SegmentArrayMessageReader reader(serialized);
+            Simulation::Reader s2 = reader.getRoot<Simulation>();
+            decoded = s2.getSamples().size() + s2.getParticles().size() + s2.getMatrix().getValues().size();
+        },
+        check);
+
+    check();
+
+    print_timings("capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION), timings, size);
+}
+
+template <typename Simulation, typename ToString, typename FromString>
+void
+archive_hpc_test(size_t iterations, const std::string &name, const std::string &version,
+                 ToString to_string, FromString from_string)
+{
+    Simulation s1, s2;
+    assign(s1, simulation());
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (s1 != s2) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            to_string(s1, serialized);
+        },
+        [&] {
+            from_string(s2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings(name, version, timings, serialized.size());
+}
+
+void
+boost_hpc_test(size_t iterations)
+{
+    archive_hpc_test<boost_test::Simulation>(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION),
+        [](const boost_test::Simulation &s, std::string &d) { boost_test::to_string(s, d); },
+        [](boost_test::Simulation &s, const std::string &d) { boost_test::from_string(s, d); });
+}
+
+void
+cereal_hpc_test(size_t iterations)
+{
+    archive_hpc_test<cereal_test::Simulation>(iterations, "cereal", "",
+        [](const cereal_test::Simulation &s, std::string &d) { cereal_test::to_string(s, d); },
+        [](cereal_test::Simulation &s, const std::string &d) { cereal_test::from_string(s, d); });
+}
+
+void
+hpx_hpc_test(size_t iterations)
+{
+    archive_hpc_test<hpx_test::Simulation>(iterations, "hpx", hpx::full_version_as_string(),
+        [](const hpx_test::Simulation &s, std::string &d) { hpx_test::to_string(s, d); },
+        [](hpx_test::Simulation &s, const std::string &d) { hpx_test::from_string(s, d); });
+}
+
+// The arrays stay in the chunks rather than in the archive's buffer, so the
+// reported size is that of the sizes and dimensions only.
+void
+hpx_zero_copy_hpc_test(size_t iterations)
+{
+    archive_hpc_test<hpx_zero_copy_test::Simulation>(iterations, "hpx_zero_copy", hpx::full_version_as_string(),
+        [](const hpx_zero_copy_test::Simulation &s, std::string &d) { hpx_zero_copy_test::to_string(s, d); },
+        [](hpx_zero_copy_test::Simulation &s, const std::string &d) { hpx_zero_copy_test::from_string(s, d); });
+}
+
+void
+yas_hpc_test(size_t iterations)
+{
+    archive_hpc_test<yas_test::Simulation>(iterations, "yas", "",
+        [](const yas_test::Simulation &s, std::string &d) { yas_test::to_string(s, d); },
+        [](yas_test::Simulation &s, const std::string &d) { yas_test::from_string(s, d); });
+}
+
+void
+reflect_hpc_test(size_t iterations)
+{
+    archive_hpc_test<reflect_test::Simulation>(iterations, "reflect", "",
+        [](const reflect_test::Simulation &s, std::string &d) { reflect::to_string(s, d); },
+        [](reflect_test::Simulation &s, const std::string &d) { reflect::from_string(s, d); });
+}
+
+#ifdef WITH_MPI
+void
+mpi_hpc_test(size_t iterations)
+{
+    using namespace mpi_test;
+
+    Simulation s1, s2;
+    assign(s1, simulation());
+
+    std::string serialized(determine_pack_size(s1), ' ');
+
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
+
+    auto check = [&] {
+        if (s1 != s2) {
+            throw std::logic_error("mpi's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            to_string(s1, serialized);
+        },
+        [&] {
+            from_string(s2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("mpi", version, timings, serialized.size());
+}
+#endif
+
+void
+msgpack_hpc_test(size_t iterations)
+{
+    using namespace msgpack_test;
+
+    Simulation s1, s2;
+    assign(s1, simulation());
+
+    msgpack::sbuffer sbuf;
+
+    auto check = [&] {
+        if (s1 != s2) {
+            throw std::logic_error("msgpack's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            sbuf.clear();
+            msgpack::pack(sbuf, s1);
+        },
+        [&] {
+            msgpack::unpacked msg;
+            msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+            msgpack::object obj = msg.get();
+            obj.convert(&s2);
+        },
+        check);
+
+    check();
+
+    print_timings("msgpack", msgpack_version(), timings, sbuf.size());
+}
+
+void
+avro_hpc_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    Simulation s1, s2;
+    assign(s1, simulation());
+
+    std::auto_ptr<avro::OutputStream> out;
+
+    auto check = [&] {
+        if (payload_of(s2) != simulation()) {
+            throw std::logic_error("avro's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, s1);
+            encoder->flush();
+        },
+        [&] {
+            auto in = avro::memoryInputStream(*out);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+            avro::decode(*decoder, s2);
+        },
+        check);
+
+    check();
+
+    print_timings("avro", "", timings, out->byteCount());
+}
+
+void
+flatbuffers_hpc_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    const SimulationPayload &data = simulation();
+
+    // the generated struct has no padding member to fill, so the particles
+    // are converted once, ahead of the measured loop
+    std::vector<Particle> particles;
+    particles.reserve(data.particles.size());
+    for (size_t i = 0; i < data.particles.size(); i++) {
+        const ParticlePayload &p = data.particles[i];
+        particles.push_back(Particle(p.x, p.y, p.z, p.id));
+    }
+
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    auto build = [&] {
+        builder.Clear();
+
+        auto samples = builder.CreateVector(data.samples);
+        auto particles_vec = builder.CreateVectorOfStructs(particles);
+        auto values = builder.CreateVector(data.matrix);
+        auto matrix = CreateMatrix(builder, data.rows, data.columns, values);
+        builder.Finish(CreateSimulation(builder, samples, particles_vec, matrix));
+
+        auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+        auto sz = builder.GetSize();
+        buf.assign(p, p + sz);
+
+        builder.ReleaseBufferPointer();
+    };
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // as in the Record test, encoding is building the message and copying
+    // it out, decoding is getting the root table and reaching its lists
+    size_t decoded = 0;
+
+    auto check = [&] {
+        auto s2 = GetSimulation(buf.data());
+        if (decoded != data.samples.size() + data.particles.size() + data.matrix.size() ||
+            s2->samples()->Get(0) != data.samples[0] || s2->particles()->Get(0)->x() != data.particles[0].x ||
+            s2->matrix()->values()->Get(0) != data.matrix[0]) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        build,
+        [&] {
+            auto s2 = GetSimulation(buf.data());
+            decoded = s2->samples()->size() + s2->particles()->size() + s2->matrix()->values()->size();
+        },
+        check);
+
+    check();
+
+    print_timings("flatbuffers", version, timings, buf.size());
+}
+
+} // namespace
+
+Tests
+hpc_tests()
+{
+    Tests tests = {
+        {"memcpy", memcpy_hpc_test, true},
+        {"thrift-binary",
+         [](size_t n) { thrift_hpc_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_hpc_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_hpc_test, true},
+        {"capnproto", capnproto_hpc_test, true},
+        {"boost", boost_hpc_test, true},
+        {"msgpack", msgpack_hpc_test, true},
+        {"cereal", cereal_hpc_test, true},
+        {"avro", avro_hpc_test, true},
+        {"hpx", hpx_hpc_test, true},
+        {"hpx_zero_copy", hpx_zero_copy_hpc_test, false},
+#ifdef WITH_MPI
+        {"mpi", mpi_hpc_test, false},
+#endif
+        {"yas", yas_hpc_test, true},
+        {"reflect", reflect_hpc_test, true},
+        {"flatbuffers", flatbuffers_hpc_test, true},
+    };
+
+    return tests;
+}
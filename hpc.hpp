@@ -0,0 +1,60 @@
+#ifndef __HPC_HPP_INCLUDED__
+#define __HPC_HPP_INCLUDED__
+
+#include <vector>
+
+#include <stdint.h>
+
+// The HPC schema's tests (--schema=hpc) ship the bulk arrays of a
+// simulation step, some 5 MB in all: a field sampled as doubles, particles
+// as small POD structs and a matrix of floats. They tell the serializers
+// copying such arrays in bulk from those walking them element by element,
+// so their throughput is also given next to memcpy's.
+const size_t kSamples = 262144;
+const size_t kParticles = 65536;
+const size_t kMatrixRows = 512;
+const size_t kMatrixColumns = 512;
+
+struct ParticlePayload {
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    ParticlePayload() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const ParticlePayload &other) const {
+        return x == other.x && y == other.y && z == other.z && id == other.id;
+    }
+};
+
+struct SimulationPayload {
+    std::vector<double>          samples;
+    std::vector<ParticlePayload> particles;
+    uint32_t                     rows;
+    uint32_t                     columns;
+    std::vector<float>           matrix; // row after row
+
+    SimulationPayload() : rows(0), columns(0) {}
+
+    bool operator==(const SimulationPayload &other) const {
+        return samples == other.samples && particles == other.particles && rows == other.rows &&
+               columns == other.columns && matrix == other.matrix;
+    }
+
+    bool operator!=(const SimulationPayload &other) const {
+        return !(*this == other);
+    }
+
+    // Size of the raw data: 8 bytes per sample, 28 per particle, 4 per
+    // matrix element and 4 per dimension.
+    size_t bytes() const;
+};
+
+// Generates a simulation step from `seed`.
+SimulationPayload generate_simulation(uint64_t seed);
+
+// The simulation step shared by the HPC schema's tests.
+SimulationPayload &simulation();
+
+#endif
@@ -0,0 +1,19 @@
+#include "hpx/document.hpp"
+
+namespace hpx_test {
+
+void
+to_string(const Document &document, std::string& data)
+{
+    hpx::serialization::output_archive archiver(data);
+    archiver << document;
+}
+
+void
+from_string(Document &document, const std::string& data)
+{
+    hpx::serialization::input_archive archiver(data);
+    archiver >> document;
+}
+
+} // namespace
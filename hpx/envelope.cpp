@@ -0,0 +1,19 @@
+#include "hpx/envelope.hpp"
+
+namespace hpx_test {
+
+void
+to_string(const Envelope &envelope, std::string& data)
+{
+    hpx::serialization::output_archive archiver(data);
+    archiver << envelope;
+}
+
+void
+from_string(Envelope &envelope, const std::string& data)
+{
+    hpx::serialization::input_archive archiver(data);
+    archiver >> envelope;
+}
+
+} // namespace
@@ -0,0 +1,51 @@
+#include "hpx/graph.hpp"
+
+namespace hpx_test {
+
+namespace {
+
+template <typename Graph>
+void
+save(const Graph &graph, std::string &data)
+{
+    hpx::serialization::output_archive archiver(data);
+    archiver << graph;
+}
+
+template <typename Graph>
+void
+load(Graph &graph, const std::string &data)
+{
+    graph.clear();
+
+    hpx::serialization::input_archive archiver(data);
+    archiver >> graph;
+}
+
+} // namespace
+
+void
+to_string(const Graph<true> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+to_string(const Graph<false> &graph, std::string &data)
+{
+    save(graph, data);
+}
+
+void
+from_string(Graph<true> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+void
+from_string(Graph<false> &graph, const std::string &data)
+{
+    load(graph, data);
+}
+
+} // namespace
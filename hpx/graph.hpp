@@ -0,0 +1,174 @@
+#ifndef __HPX_GRAPH_HPP_INCLUDED__
+#define __HPX_GRAPH_HPP_INCLUDED__
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <type_traits>
+
+#include <stdint.h>
+
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/base_object.hpp>
+#include <hpx/runtime/serialization/string.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/runtime/serialization/shared_ptr.hpp>
+#include <hpx/runtime/serialization/unique_ptr.hpp>
+
+namespace hpx_test {
+
+// A node of the object graph, serialized through a pointer to Node and
+// told apart from the other kinds by its registered name. A tracked node
+// (Tracked set) holds its children and its links to other nodes as shared
+// pointers, which hpx tracks, so that a node may be reached several times.
+// An untracked one owns its children through unique pointers, which hpx
+// doesn't track, and refers to other nodes by id.
+template <bool Tracked>
+class Node {
+public:
+
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, std::unique_ptr<Node> >::type Pointer;
+    typedef typename std::conditional<Tracked, std::shared_ptr<Node>, int64_t>::type Link;
+
+    int64_t              id;
+    std::vector<Pointer> children;
+    std::vector<Link>    links;
+
+    Node() : id(0) {}
+    virtual ~Node() {}
+
+    HPX_SERIALIZATION_POLYMORPHIC_TEMPLATE(Node);
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & id;
+        ar & children;
+        ar & links;
+    }
+};
+
+template <bool Tracked>
+class WeightNode : public Node<Tracked> {
+public:
+
+    double weight;
+
+    WeightNode() : weight(0) {}
+
+    HPX_SERIALIZATION_POLYMORPHIC_TEMPLATE(WeightNode);
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & hpx::serialization::base_object<Node<Tracked> >(*this);
+        ar & weight;
+    }
+};
+
+template <bool Tracked>
+class TextNode : public Node<Tracked> {
+public:
+
+    std::string text;
+
+    HPX_SERIALIZATION_POLYMORPHIC_TEMPLATE(TextNode);
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & hpx::serialization::base_object<Node<Tracked> >(*this);
+        ar & text;
+    }
+};
+
+template <bool Tracked>
+class SeriesNode : public Node<Tracked> {
+public:
+
+    std::vector<int64_t> values;
+
+    HPX_SERIALIZATION_POLYMORPHIC_TEMPLATE(SeriesNode);
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & hpx::serialization::base_object<Node<Tracked> >(*this);
+        ar & values;
+    }
+};
+
+template <bool Tracked>
+class Graph {
+public:
+
+    typedef Node<Tracked>       NodeType;
+    typedef WeightNode<Tracked> WeightType;
+    typedef TextNode<Tracked>   TextType;
+    typedef SeriesNode<Tracked> SeriesType;
+
+    typedef typename NodeType::Pointer Pointer;
+
+    Pointer root;
+
+    Graph() {}
+
+    ~Graph() {
+        clear();
+    }
+
+    // The links are dropped before the nodes, as those of a tracked graph
+    // make cycles of shared pointers.
+    void clear() {
+        if (root) {
+            release(*root);
+        }
+        root.reset();
+    }
+
+private:
+
+    Graph(const Graph &);
+    Graph &operator=(const Graph &);
+
+    static void release(NodeType &node) {
+        node.links.clear();
+        for (size_t i = 0; i < node.children.size(); i++) {
+            release(*node.children[i]);
+        }
+    }
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & root;
+    }
+};
+
+void to_string(const Graph<true> &graph, std::string &data);
+void to_string(const Graph<false> &graph, std::string &data);
+void from_string(Graph<true> &graph, const std::string &data);
+void from_string(Graph<false> &graph, const std::string &data);
+
+} // namespace
+
+#endif
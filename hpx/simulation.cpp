@@ -0,0 +1,19 @@
+#include "hpx/simulation.hpp"
+
+namespace hpx_test {
+
+void
+to_string(const Simulation &simulation, std::string& data)
+{
+    hpx::serialization::output_archive archiver(data);
+    archiver << simulation;
+}
+
+void
+from_string(Simulation &simulation, const std::string& data)
+{
+    hpx::serialization::input_archive archiver(data);
+    archiver >> simulation;
+}
+
+} // namespace
@@ -0,0 +1,121 @@
+#ifndef __HPX_SIMULATION_HPP_INCLUDED__
+#define __HPX_SIMULATION_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/traits/is_bitwise_serializable.hpp>
+
+namespace hpx_test {
+
+class Particle {
+public:
+
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    Particle() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const Particle &other) const {
+        return (x == other.x &&
+                y == other.y &&
+                z == other.z &&
+                id == other.id);
+    }
+
+    bool operator!=(const Particle &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & x;
+        ar & y;
+        ar & z;
+        ar & id;
+    }
+};
+
+class Matrix {
+public:
+
+    uint32_t           rows;
+    uint32_t           columns;
+    std::vector<float> values; // row after row
+
+    Matrix() : rows(0), columns(0) {}
+
+    bool operator==(const Matrix &other) const {
+        return (rows == other.rows &&
+                columns == other.columns &&
+                values == other.values);
+    }
+
+    bool operator!=(const Matrix &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & rows;
+        ar & columns;
+        ar & values;
+    }
+};
+
+class Simulation {
+public:
+
+    std::vector<double>   samples;
+    std::vector<Particle> particles;
+    Matrix                matrix;
+
+    bool operator==(const Simulation &other) const {
+        return (samples == other.samples &&
+                particles == other.particles &&
+                matrix == other.matrix);
+    }
+
+    bool operator!=(const Simulation &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & samples;
+        ar & particles;
+        ar & matrix;
+    }
+};
+
+void to_string(const Simulation &simulation, std::string &data);
+void from_string(Simulation &simulation, const std::string &data);
+
+} // namespace
+
+// Particles are copied in bulk, padding included.
+HPX_IS_BITWISE_SERIALIZABLE(hpx_test::Particle)
+
+#endif
@@ -0,0 +1,19 @@
+#include "hpx/sparse_record.hpp"
+
+namespace hpx_test {
+
+void
+to_string(const SparseRecord &record, std::string& data)
+{
+    hpx::serialization::output_archive archiver(data);
+    archiver << record;
+}
+
+void
+from_string(SparseRecord &record, const std::string& data)
+{
+    hpx::serialization::input_archive archiver(data);
+    archiver >> record;
+}
+
+} // namespace
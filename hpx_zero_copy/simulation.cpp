@@ -0,0 +1,22 @@
+#include "hpx_zero_copy/simulation.hpp"
+
+namespace hpx_zero_copy_test {
+
+static std::vector<hpx::serialization::serialization_chunk> chunks;
+
+void
+to_string(const Simulation &simulation, std::string& data)
+{
+    chunks.clear();
+    hpx::serialization::output_archive archiver(data, 0, &chunks);
+    archiver << simulation;
+}
+
+void
+from_string(Simulation &simulation, const std::string& data)
+{
+    hpx::serialization::input_archive archiver(data, 0u, &chunks);
+    archiver >> simulation;
+}
+
+} // namespace
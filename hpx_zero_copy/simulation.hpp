@@ -0,0 +1,157 @@
+#ifndef __HPX_ZERO_COPY_SIMULATION_HPP_INCLUDED__
+#define __HPX_ZERO_COPY_SIMULATION_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include <stdint.h>
+
+#include <hpx/runtime/serialization/serialize.hpp>
+#include <hpx/runtime/serialization/vector.hpp>
+#include <hpx/runtime/serialization/array.hpp>
+#include <hpx/traits/is_bitwise_serializable.hpp>
+
+namespace hpx_zero_copy_test {
+
+class Particle {
+public:
+
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    Particle() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const Particle &other) const {
+        return (x == other.x &&
+                y == other.y &&
+                z == other.z &&
+                id == other.id);
+    }
+
+    bool operator!=(const Particle &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & x;
+        ar & y;
+        ar & z;
+        ar & id;
+    }
+};
+
+class Matrix {
+public:
+
+    uint32_t           rows;
+    uint32_t           columns;
+    std::vector<float> values; // row after row
+
+    Matrix() : rows(0), columns(0) {}
+
+    bool operator==(const Matrix &other) const {
+        return (rows == other.rows &&
+                columns == other.columns &&
+                values == other.values);
+    }
+
+    bool operator!=(const Matrix &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar & rows;
+        ar & columns;
+        ar & values;
+    }
+};
+
+class Simulation {
+public:
+
+    std::vector<double>   samples;
+    std::vector<Particle> particles;
+    Matrix                matrix;
+
+    bool operator==(const Simulation &other) const {
+        return (samples == other.samples &&
+                particles == other.particles &&
+                matrix == other.matrix);
+    }
+
+    bool operator!=(const Simulation &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend class hpx::serialization::access;
+
+    // The arrays are written with make_array(), which the archive keeps as
+    // chunks pointing to the vectors' memory rather than copying them.
+    template<typename Archive>
+    void save(Archive &ar, unsigned int) const
+    {
+        ar & samples.size();
+        ar & hpx::serialization::make_array(samples.data(), samples.size());
+
+        ar & particles.size();
+        ar & hpx::serialization::make_array(particles.data(), particles.size());
+
+        ar & matrix.rows;
+        ar & matrix.columns;
+        ar & matrix.values.size();
+        ar & hpx::serialization::make_array(matrix.values.data(), matrix.values.size());
+    }
+
+    template <typename Archive>
+    void load(Archive& ar, unsigned)
+    {
+        {
+            std::vector<double>::size_type size;
+            ar & size; samples.resize(size);
+            ar & hpx::serialization::make_array(samples.data(), samples.size());
+        }
+
+        {
+            std::vector<Particle>::size_type size;
+            ar & size; particles.resize(size);
+            ar & hpx::serialization::make_array(particles.data(), particles.size());
+        }
+
+        {
+            ar & matrix.rows;
+            ar & matrix.columns;
+
+            std::vector<float>::size_type size;
+            ar & size; matrix.values.resize(size);
+            ar & hpx::serialization::make_array(matrix.values.data(), matrix.values.size());
+        }
+    }
+    HPX_SERIALIZATION_SPLIT_MEMBER();
+};
+
+void to_string(const Simulation &simulation, std::string &data);
+void from_string(Simulation &simulation, const std::string &data);
+
+} // namespace
+
+// Particles are copied in bulk, padding included.
+HPX_IS_BITWISE_SERIALIZABLE(hpx_zero_copy_test::Particle)
+
+#endif
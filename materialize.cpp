@@ -0,0 +1,531 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <hpx/config.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/test_types.h"
+#include "thrift/gen-cpp/test_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/test.pb.h"
+#include "capnproto/test.capnp.h"
+#include "boost/record.hpp"
+#include "msgpack/record.hpp"
+#include "cereal/record.hpp"
+#include "avro/record.hpp"
+#include "hpx/record.hpp"
+#include "hpx_zero_copy/record.hpp"
+#include "hpx/version.hpp"
+#ifdef WITH_MPI
+#include "mpi/record.hpp"
+#endif
+#include "yas/record.hpp"
+#include "flatbuffers/test_generated.h"
+#include "raw/record.hpp"
+#include "reflect/record.hpp"
+
+#include "workload.hpp"
+#include "checksum.hpp"
+#include "benchmark.hpp"
+#include "tests.hpp"
+
+namespace {
+
+// Runs a serializer on equal terms with the others: encode() builds its
+// message from the payload, as an application encoding its own domain
+// objects does, and decode() returns the checksum of every id and every
+// string byte it reads out of the message, so that the formats read in
+// place pay for the data they hand out like the parsing ones do. size()
+// is the size of the last message.
+template <typename Encode, typename Decode, typename Size>
+void
+materialized_test(size_t iterations, const std::string &name, const std::string &version,
+                  Encode encode, Decode decode, Size size)
+{
+    Records<Payload> records([](Payload &record, const Payload &data) {
+        record = data;
+    });
+
+    uint64_t sum = 0;
+
+    auto encode_next = [&] {
+        encode(records.next());
+    };
+
+    auto decode_last = [&] {
+        sum = decode();
+        do_not_optimize(sum);
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode_next();
+        decode_last();
+
+        if (sum != checksum(records.last())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+
+        sizes.push_back(size());
+    }
+
+    auto check = [&] {
+        if (sum != checksum(records.last())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode_next, decode_last, check);
+
+    check();
+
+    print_timings(name, version, timings, sizes);
+}
+
+// Fills the records of thrift, avro and the hand-written
+// serializers, which all keep the ids and strings in vectors.
+template <typename Record>
+void
+assign(Record &record, const Payload &data)
+{
+    record.ids.assign(data.ids.begin(), data.ids.end());
+    record.strings.assign(data.strings.begin(), data.strings.end());
+}
+
+void
+raw_materialized_test(size_t iterations, bool view)
+{
+    using namespace raw_test;
+
+    Record r1, r2;
+    RecordView v2;
+    std::string serialized;
+
+    materialized_test(iterations, view ? "raw-view" : "raw", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            to_string(r1, serialized);
+        },
+        [&] {
+            if (!view) {
+                from_string(r2, serialized);
+                return checksum(r2);
+            }
+
+            from_string(v2, serialized);
+            Checksum result;
+            for (size_t i = 0; i < v2.ids_size(); i++) {
+                result.add(v2.id(i));
+            }
+            for (size_t i = 0; i < v2.strings_size(); i++) {
+                result.add(v2.string_data(i), v2.string_size(i));
+            }
+            return result.value();
+        },
+        [&] { return serialized.size(); });
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+void
+thrift_materialized_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Record r1, r2;
+    std::string serialized;
+
+    std::string tag = proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    materialized_test(iterations, tag, VERSION,
+        [&](const Payload &data) {
+            assign(r1, data);
+            buffer1->resetBuffer();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                r1.write(&binary_protocol1);
+            } else {
+                r1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&] {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (proto == ThriftSerializationProto::Binary) {
+                r2.read(&binary_protocol2);
+            } else {
+                r2.read(&compact_protocol2);
+            }
+
+            return checksum(r2);
+        },
+        [&] { return serialized.size(); });
+}
+
+void
+protobuf_materialized_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    Record r1, r2;
+    std::string serialized;
+
+    materialized_test(iterations, "protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION),
+        [&](const Payload &data) {
+            r1.Clear();
+            for (size_t i = 0; i < data.ids.size(); i++) {
+                r1.add_ids(data.ids[i]);
+            }
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                r1.add_strings(data.strings[i]);
+            }
+
+            serialized.clear();
+            r1.SerializeToString(&serialized);
+        },
+        [&] {
+            r2.ParseFromString(serialized);
+
+            Checksum result;
+            for (int i = 0; i < r2.ids_size(); i++) {
+                result.add(r2.ids(i));
+            }
+            for (int i = 0; i < r2.strings_size(); i++) {
+                result.add(r2.strings(i).data(), r2.strings(i).size());
+            }
+            return result.value();
+        },
+        [&] { return serialized.size(); });
+}
+
+// The message is built anew every time, a builder can't be emptied, and
+// flattened into one array as it would be to be sent.
+void
+capnproto_materialized_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    kj::Array<capnp::word> serialized;
+
+    materialized_test(iterations, "capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION),
+        [&](const Payload &data) {
+            capnp::MallocMessageBuilder message;
+            Record::Builder r1 = message.initRoot<Record>();
+
+            auto ids = r1.initIds(data.ids.size());
+            for (size_t i = 0; i < data.ids.size(); i++) {
+                ids.set(i, data.ids[i]);
+            }
+
+            auto strings = r1.initStrings(data.strings.size());
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                strings.set(i, data.strings[i]);
+            }
+
+            serialized = capnp::messageToFlatArray(message);
+        },
+        [&] {
+            capnp::FlatArrayMessageReader reader(serialized);
+            Record::Reader r2 = reader.getRoot<Record>();
+
+            Checksum result;
+            for (auto id: r2.getIds()) {
+                result.add(id);
+            }
+            for (auto string: r2.getStrings()) {
+                result.add(string.begin(), string.size());
+            }
+            return result.value();
+        },
+        [&] { return serialized.size() * sizeof(capnp::word); });
+}
+
+void
+flatbuffers_materialized_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    materialized_test(iterations, "flatbuffers", version,
+        [&](const Payload &data) {
+            builder.Clear();
+            strings.clear();
+
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                strings.push_back(builder.CreateString(data.strings[i]));
+            }
+
+            auto ids_vec = builder.CreateVector(data.ids);
+            auto strings_vec = builder.CreateVector(strings);
+            builder.Finish(CreateRecord(builder, ids_vec, strings_vec));
+
+            auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+            auto sz = builder.GetSize();
+            buf.assign(p, p + sz);
+
+            builder.ReleaseBufferPointer();
+        },
+        [&] {
+            auto r2 = GetRecord(buf.data());
+
+            Checksum result;
+            for (size_t i = 0; i < r2->ids()->size(); i++) {
+                result.add(r2->ids()->Get(i));
+            }
+            for (size_t i = 0; i < r2->strings()->size(); i++) {
+                const flatbuffers::String *string = r2->strings()->Get(i);
+                result.add(string->c_str(), string->size());
+            }
+            return result.value();
+        },
+        [&] { return buf.size(); });
+}
+
+template <typename Record, typename ToString, typename FromString>
+void
+archive_materialized_test(size_t iterations, const std::string &name, const std::string &version,
+                          ToString to_string, FromString from_string)
+{
+    Record r1, r2;
+    std::string serialized;
+
+    materialized_test(iterations, name, version,
+        [&](const Payload &data) {
+            assign(r1, data);
+            serialized.clear();
+            to_string(r1, serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+            return checksum(r2);
+        },
+        [&] { return serialized.size(); });
+}
+
+void
+boost_materialized_test(size_t iterations)
+{
+    archive_materialized_test<boost_test::Record>(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION),
+        [](const boost_test::Record &r, std::string &s) { boost_test::to_string(r, s); },
+        [](boost_test::Record &r, const std::string &s) { boost_test::from_string(r, s); });
+}
+
+void
+cereal_materialized_test(size_t iterations)
+{
+    archive_materialized_test<cereal_test::Record>(iterations, "cereal", "",
+        [](const cereal_test::Record &r, std::string &s) { cereal_test::to_string(r, s); },
+        [](cereal_test::Record &r, const std::string &s) { cereal_test::from_string(r, s); });
+}
+
+void
+hpx_materialized_test(size_t iterations)
+{
+    archive_materialized_test<hpx_test::Record>(iterations, "hpx", hpx::full_version_as_string(),
+        [](const hpx_test::Record &r, std::string &s) { hpx_test::to_string(r, s); },
+        [](hpx_test::Record &r, const std::string &s) { hpx_test::from_string(r, s); });
+}
+
+void
+hpx_zero_copy_materialized_test(size_t iterations)
+{
+    archive_materialized_test<hpx_zero_copy_test::Record>(iterations, "hpx_zero_copy", hpx::full_version_as_string(),
+        [](const hpx_zero_copy_test::Record &r, std::string &s) { hpx_zero_copy_test::to_string(r, s); },
+        [](hpx_zero_copy_test::Record &r, const std::string &s) { hpx_zero_copy_test::from_string(r, s); });
+}
+
+#ifdef WITH_MPI
+void
+mpi_materialized_test(size_t iterations)
+{
+    using namespace mpi_test;
+
+    Record r1, r2;
+    std::string serialized;
+
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
+
+    materialized_test(iterations, "mpi", version,
+        [&](const Payload &data) {
+            assign(r1, data);
+            serialized.resize(determine_pack_size(r1));
+            to_string(r1, serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+            return checksum(r2);
+        },
+        [&] { return serialized.size(); });
+}
+#endif
+
+void
+msgpack_materialized_test(size_t iterations)
+{
+    using namespace msgpack_test;
+
+    Record r1, r2;
+    msgpack::sbuffer sbuf;
+
+    materialized_test(iterations, "msgpack", msgpack_version(),
+        [&](const Payload &data) {
+            assign(r1, data);
+            sbuf.clear();
+            msgpack::pack(sbuf, r1);
+        },
+        [&] {
+            msgpack::unpacked msg;
+            msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+            msgpack::object obj = msg.get();
+            obj.convert(&r2);
+            return checksum(r2);
+        },
+        [&] { return sbuf.size(); });
+}
+
+void
+avro_materialized_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    Record r1, r2;
+    std::auto_ptr<avro::OutputStream> out;
+
+    materialized_test(iterations, "avro", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, r1);
+            encoder->flush();
+        },
+        [&] {
+            auto in = avro::memoryInputStream(*out);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+            avro::decode(*decoder, r2);
+            return checksum(r2);
+        },
+        [&] { return static_cast<size_t>(out->byteCount()); });
+}
+
+void
+yas_materialized_test(size_t iterations)
+{
+    using namespace yas_test;
+
+    Record r1, r2;
+    std::unique_ptr<yas::mem_ostream> os;
+
+    materialized_test(iterations, "yas", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            os.reset(new yas::mem_ostream());
+            yas::binary_oarchive<yas::mem_ostream> oa(*os);
+            oa & r1;
+        },
+        [&] {
+            yas::mem_istream is(os->get_intrusive_buffer());
+            yas::binary_iarchive<yas::mem_istream> ia(is);
+            ia & r2;
+            return checksum(r2);
+        },
+        [&] { return os->get_intrusive_buffer().size; });
+}
+
+void
+reflect_materialized_test(size_t iterations)
+{
+    using namespace reflect_test;
+
+    Record r1, r2;
+    std::string serialized;
+
+    materialized_test(iterations, "reflect", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            reflect::to_string(r1, serialized);
+        },
+        [&] {
+            reflect::from_string(r2, serialized);
+            return checksum(r2);
+        },
+        [&] { return serialized.size(); });
+}
+
+} // namespace
+
+Tests
+materialized_tests()
+{
+    Tests tests = {
+        {"raw", [](size_t n) { raw_materialized_test(n, false); }, true},
+        {"raw-view", [](size_t n) { raw_materialized_test(n, true); }, true},
+        {"thrift-binary",
+         [](size_t n) { thrift_materialized_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_materialized_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_materialized_test, true},
+        {"capnproto", capnproto_materialized_test, true},
+        {"boost", boost_materialized_test, true},
+        {"msgpack", msgpack_materialized_test, true},
+        {"cereal", cereal_materialized_test, true},
+        {"avro", avro_materialized_test, true},
+        {"hpx", hpx_materialized_test, true},
+        {"hpx_zero_copy", hpx_zero_copy_materialized_test, false},
+#ifdef WITH_MPI
+        {"mpi", mpi_materialized_test, false},
+#endif
+        {"yas", yas_materialized_test, true},
+        {"reflect", reflect_materialized_test, true},
+        {"flatbuffers", flatbuffers_materialized_test, true},
+    };
+
+    return tests;
+}
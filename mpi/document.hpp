@@ -0,0 +1,260 @@
+#ifndef __MPI_DOCUMENT_HPP_INCLUDED__
+#define __MPI_DOCUMENT_HPP_INCLUDED__
+
+#include <map>
+#include <vector>
+#include <string>
+
+#include <stdint.h>
+
+#include "mpi/packer.hpp"
+
+namespace mpi_test {
+
+class Paragraph {
+public:
+
+    std::string                   text;
+    bool                          highlighted;
+    std::vector<int64_t>          offsets;
+    std::map<std::string, double> weights;
+
+    Paragraph() : highlighted(false) {}
+
+    bool operator==(const Paragraph &other) const {
+        return (text == other.text &&
+                highlighted == other.highlighted &&
+                offsets == other.offsets &&
+                weights == other.weights);
+    }
+
+    bool operator!=(const Paragraph &other) const {
+        return !(*this == other);
+    }
+};
+
+class Section {
+public:
+
+    std::string                    name;
+    double                         weight;
+    bool                           visible;
+    std::map<std::string, int64_t> counters;
+    std::vector<Paragraph>         paragraphs;
+
+    Section() : weight(0), visible(false) {}
+
+    bool operator==(const Section &other) const {
+        return (name == other.name &&
+                weight == other.weight &&
+                visible == other.visible &&
+                counters == other.counters &&
+                paragraphs == other.paragraphs);
+    }
+
+    bool operator!=(const Section &other) const {
+        return !(*this == other);
+    }
+};
+
+class Document {
+public:
+
+    int64_t                            id;
+    std::string                        title;
+    bool                               published;
+    double                             score;
+    std::map<std::string, std::string> attributes;
+    std::vector<Section>               sections;
+
+    Document() : id(0), published(false), score(0) {}
+
+    bool operator==(const Document &other) const {
+        return (id == other.id &&
+                title == other.title &&
+                published == other.published &&
+                score == other.score &&
+                attributes == other.attributes &&
+                sections == other.sections);
+    }
+
+    bool operator!=(const Document &other) const {
+        return !(*this == other);
+    }
+};
+
+// Every string, list and map is packed as its int length followed by its
+// contents, booleans are packed as ints.
+
+int determine_pack_size(const Paragraph &paragraph)
+{
+    int total_size = string_pack_size(paragraph.text);
+    total_size += scalar_pack_size(MPI_INT);
+
+    total_size += scalar_pack_size(MPI_INT);
+    total_size += scalar_pack_size(MPI_INT64_T, paragraph.offsets.size());
+
+    total_size += scalar_pack_size(MPI_INT);
+    for (auto it = paragraph.weights.begin(); it != paragraph.weights.end(); ++it) {
+        total_size += string_pack_size(it->first);
+        total_size += scalar_pack_size(MPI_DOUBLE);
+    }
+
+    return total_size;
+}
+
+int determine_pack_size(const Section &section)
+{
+    int total_size = string_pack_size(section.name);
+    total_size += scalar_pack_size(MPI_DOUBLE);
+    total_size += scalar_pack_size(MPI_INT);
+
+    total_size += scalar_pack_size(MPI_INT);
+    for (auto it = section.counters.begin(); it != section.counters.end(); ++it) {
+        total_size += string_pack_size(it->first);
+        total_size += scalar_pack_size(MPI_INT64_T);
+    }
+
+    total_size += scalar_pack_size(MPI_INT);
+    for (size_t i = 0; i < section.paragraphs.size(); i++) {
+        total_size += determine_pack_size(section.paragraphs[i]);
+    }
+
+    return total_size;
+}
+
+int determine_pack_size(const Document &document)
+{
+    int total_size = scalar_pack_size(MPI_INT64_T);
+    total_size += string_pack_size(document.title);
+    total_size += scalar_pack_size(MPI_INT);
+    total_size += scalar_pack_size(MPI_DOUBLE);
+
+    total_size += scalar_pack_size(MPI_INT);
+    for (auto it = document.attributes.begin(); it != document.attributes.end(); ++it) {
+        total_size += string_pack_size(it->first);
+        total_size += string_pack_size(it->second);
+    }
+
+    total_size += scalar_pack_size(MPI_INT);
+    for (size_t i = 0; i < document.sections.size(); i++) {
+        total_size += determine_pack_size(document.sections[i]);
+    }
+
+    return total_size;
+}
+
+void pack(Packer &packer, const Paragraph &paragraph)
+{
+    packer.pack_string(paragraph.text);
+    packer.pack_int(paragraph.highlighted);
+
+    packer.pack_int(paragraph.offsets.size());
+    packer.pack(paragraph.offsets.data(), paragraph.offsets.size(), MPI_INT64_T);
+
+    packer.pack_int(paragraph.weights.size());
+    for (auto it = paragraph.weights.begin(); it != paragraph.weights.end(); ++it) {
+        packer.pack_string(it->first);
+        packer.pack(&it->second, 1, MPI_DOUBLE);
+    }
+}
+
+void unpack(Packer &packer, Paragraph &paragraph)
+{
+    packer.unpack_string(paragraph.text);
+    paragraph.highlighted = packer.unpack_int() != 0;
+
+    paragraph.offsets.resize(packer.unpack_int());
+    packer.unpack(paragraph.offsets.data(), paragraph.offsets.size(), MPI_INT64_T);
+
+    paragraph.weights.clear();
+    for (int i = packer.unpack_int(); i > 0; i--) {
+        std::string key;
+        packer.unpack_string(key);
+        packer.unpack(&paragraph.weights[key], 1, MPI_DOUBLE);
+    }
+}
+
+void pack(Packer &packer, const Section &section)
+{
+    packer.pack_string(section.name);
+    packer.pack(&section.weight, 1, MPI_DOUBLE);
+    packer.pack_int(section.visible);
+
+    packer.pack_int(section.counters.size());
+    for (auto it = section.counters.begin(); it != section.counters.end(); ++it) {
+        packer.pack_string(it->first);
+        packer.pack(&it->second, 1, MPI_INT64_T);
+    }
+
+    packer.pack_int(section.paragraphs.size());
+    for (size_t i = 0; i < section.paragraphs.size(); i++) {
+        pack(packer, section.paragraphs[i]);
+    }
+}
+
+void unpack(Packer &packer, Section &section)
+{
+    packer.unpack_string(section.name);
+    packer.unpack(&section.weight, 1, MPI_DOUBLE);
+    section.visible = packer.unpack_int() != 0;
+
+    section.counters.clear();
+    for (int i = packer.unpack_int(); i > 0; i--) {
+        std::string key;
+        packer.unpack_string(key);
+        packer.unpack(&section.counters[key], 1, MPI_INT64_T);
+    }
+
+    section.paragraphs.resize(packer.unpack_int());
+    for (size_t i = 0; i < section.paragraphs.size(); i++) {
+        unpack(packer, section.paragraphs[i]);
+    }
+}
+
+void to_string(const Document &document, std::string &data)
+{
+    Packer packer(&data[0], data.size());
+
+    packer.pack(&document.id, 1, MPI_INT64_T);
+    packer.pack_string(document.title);
+    packer.pack_int(document.published);
+    packer.pack(&document.score, 1, MPI_DOUBLE);
+
+    packer.pack_int(document.attributes.size());
+    for (auto it = document.attributes.begin(); it != document.attributes.end(); ++it) {
+        packer.pack_string(it->first);
+        packer.pack_string(it->second);
+    }
+
+    packer.pack_int(document.sections.size());
+    for (size_t i = 0; i < document.sections.size(); i++) {
+        pack(packer, document.sections[i]);
+    }
+}
+
+void from_string(Document &document, const std::string &data)
+{
+    Packer packer(const_cast<char*>(&data[0]), data.size());
+
+    packer.unpack(&document.id, 1, MPI_INT64_T);
+    packer.unpack_string(document.title);
+    document.published = packer.unpack_int() != 0;
+    packer.unpack(&document.score, 1, MPI_DOUBLE);
+
+    document.attributes.clear();
+    for (int i = packer.unpack_int(); i > 0; i--) {
+        std::string key;
+        packer.unpack_string(key);
+        packer.unpack_string(document.attributes[key]);
+    }
+
+    document.sections.resize(packer.unpack_int());
+    for (size_t i = 0; i < document.sections.size(); i++) {
+        unpack(packer, document.sections[i]);
+    }
+}
+
+} // namespace
+
+#endif
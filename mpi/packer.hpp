@@ -0,0 +1,75 @@
+#ifndef __MPI_PACKER_HPP_INCLUDED__
+#define __MPI_PACKER_HPP_INCLUDED__
+
+#include <string>
+
+#include <mpi.h>
+
+namespace mpi_test {
+
+inline int string_pack_size(const std::string &value)
+{
+    int total_size = 0;
+    int partial_size;
+
+    MPI_Pack_size(1, MPI_INT, MPI_COMM_WORLD, &partial_size);
+    total_size += partial_size;
+
+    MPI_Pack_size(value.size(), MPI_CHAR, MPI_COMM_WORLD, &partial_size);
+    total_size += partial_size;
+
+    return total_size;
+}
+
+inline int scalar_pack_size(MPI_Datatype type, int count = 1)
+{
+    int partial_size;
+    MPI_Pack_size(count, type, MPI_COMM_WORLD, &partial_size);
+    return partial_size;
+}
+
+// Packs and unpacks a buffer of `size` bytes, `position` being where the
+// next value goes.
+class Packer {
+public:
+
+    Packer(char *buffer, int size) : buffer_(buffer), size_(size), position_(0) {}
+
+    void pack(const void *value, int count, MPI_Datatype type) {
+        MPI_Pack(value, count, type, buffer_, size_, &position_, MPI_COMM_WORLD);
+    }
+
+    void unpack(void *value, int count, MPI_Datatype type) {
+        MPI_Unpack(buffer_, size_, &position_, value, count, type, MPI_COMM_WORLD);
+    }
+
+    void pack_int(int value) {
+        pack(&value, 1, MPI_INT);
+    }
+
+    int unpack_int() {
+        int value;
+        unpack(&value, 1, MPI_INT);
+        return value;
+    }
+
+    void pack_string(const std::string &value) {
+        pack_int(value.size());
+        pack(value.data(), value.size(), MPI_CHAR);
+    }
+
+    void unpack_string(std::string &value) {
+        value.resize(unpack_int());
+        unpack(&value[0], value.size(), MPI_CHAR);
+    }
+
+private:
+
+    char *buffer_;
+    int size_;
+    int position_;
+};
+
+} // namespace
+
+#endif
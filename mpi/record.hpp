@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <mpi.h>
+
 namespace mpi_test {
 
 typedef std::vector<int64_t>     Integers;
@@ -27,7 +29,7 @@ public:
     }
 };
 
-int determine_pack_size(const Record &record)
+inline int determine_pack_size(const Record &record)
 {
     int total_size = 0;
     int partial_size;
@@ -36,7 +38,7 @@ int determine_pack_size(const Record &record)
     MPI_Pack_size(1, MPI_INT, MPI_COMM_WORLD, &partial_size);
     total_size += partial_size;
 
-    MPI_Pack_size(record.ids.size(), MPI_INT, MPI_COMM_WORLD, &partial_size);
+    MPI_Pack_size(record.ids.size(), MPI_INT64_T, MPI_COMM_WORLD, &partial_size);
     total_size += partial_size;
 
     MPI_Pack_size(1, MPI_INT, MPI_COMM_WORLD, &partial_size);
@@ -54,7 +56,7 @@ int determine_pack_size(const Record &record)
     return total_size;
 }
 
-void to_string(const Record &record, std::string& data)
+inline void to_string(const Record &record, std::string& data)
 {
     char *data_ptr = &data[0];
     int position = 0;
@@ -63,7 +65,7 @@ void to_string(const Record &record, std::string& data)
     MPI_Pack(&num_ints, 1, MPI_INT,
              data_ptr, data.size(), &position, MPI_COMM_WORLD);
 
-    MPI_Pack(&record.ids[0], record.ids.size(), MPI_INT,
+    MPI_Pack(record.ids.data(), record.ids.size(), MPI_INT64_T,
              data_ptr, data.size(), &position, MPI_COMM_WORLD);
 
     int num_strings = record.strings.size();
@@ -81,7 +83,7 @@ void to_string(const Record &record, std::string& data)
     }
 }
 
-void from_string(Record &record, const std::string& data)
+inline void from_string(Record &record, const std::string& data)
 {
     char *data_ptr = const_cast<char*>(&data[0]);
     int position = 0;
@@ -93,7 +95,7 @@ void from_string(Record &record, const std::string& data)
 
     record.ids.resize(num_ints);
     MPI_Unpack(data_ptr, data.size(), &position,
-               &record.ids[0], num_ints, MPI_INT,
+               record.ids.data(), num_ints, MPI_INT64_T,
                MPI_COMM_WORLD);
 
     int num_strings;
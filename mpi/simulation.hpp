@@ -0,0 +1,141 @@
+#ifndef __MPI_SIMULATION_HPP_INCLUDED__
+#define __MPI_SIMULATION_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+
+#include <stddef.h>
+
+#include <stdint.h>
+
+#include "mpi/packer.hpp"
+
+namespace mpi_test {
+
+class Particle {
+public:
+
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    Particle() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const Particle &other) const {
+        return (x == other.x &&
+                y == other.y &&
+                z == other.z &&
+                id == other.id);
+    }
+
+    bool operator!=(const Particle &other) const {
+        return !(*this == other);
+    }
+};
+
+class Matrix {
+public:
+
+    uint32_t           rows;
+    uint32_t           columns;
+    std::vector<float> values; // row after row
+
+    Matrix() : rows(0), columns(0) {}
+
+    bool operator==(const Matrix &other) const {
+        return (rows == other.rows &&
+                columns == other.columns &&
+                values == other.values);
+    }
+
+    bool operator!=(const Matrix &other) const {
+        return !(*this == other);
+    }
+};
+
+class Simulation {
+public:
+
+    std::vector<double>   samples;
+    std::vector<Particle> particles;
+    Matrix                matrix;
+
+    bool operator==(const Simulation &other) const {
+        return (samples == other.samples &&
+                particles == other.particles &&
+                matrix == other.matrix);
+    }
+
+    bool operator!=(const Simulation &other) const {
+        return !(*this == other);
+    }
+};
+
+// Sizes and dimensions are packed as ints and every array in a single
+// call, the particles through a datatype describing their layout, which
+// leaves their padding out.
+
+inline MPI_Datatype particle_type()
+{
+    static MPI_Datatype type = MPI_DATATYPE_NULL;
+
+    if (type == MPI_DATATYPE_NULL) {
+        int lengths[] = {1, 1, 1, 1};
+        MPI_Aint offsets[] = {offsetof(Particle, x), offsetof(Particle, y),
+                              offsetof(Particle, z), offsetof(Particle, id)};
+        MPI_Datatype types[] = {MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_INT32_T};
+
+        MPI_Datatype fields;
+        MPI_Type_create_struct(4, lengths, offsets, types, &fields);
+        MPI_Type_create_resized(fields, 0, sizeof(Particle), &type);
+        MPI_Type_free(&fields);
+        MPI_Type_commit(&type);
+    }
+
+    return type;
+}
+
+inline int determine_pack_size(const Simulation &simulation)
+{
+    return scalar_pack_size(MPI_INT) + scalar_pack_size(MPI_DOUBLE, simulation.samples.size()) +
+           scalar_pack_size(MPI_INT) + scalar_pack_size(particle_type(), simulation.particles.size()) +
+           scalar_pack_size(MPI_UINT32_T, 2) +
+           scalar_pack_size(MPI_INT) + scalar_pack_size(MPI_FLOAT, simulation.matrix.values.size());
+}
+
+inline void to_string(const Simulation &simulation, std::string &data)
+{
+    Packer packer(&data[0], data.size());
+
+    packer.pack_int(simulation.samples.size());
+    packer.pack(simulation.samples.data(), simulation.samples.size(), MPI_DOUBLE);
+
+    packer.pack_int(simulation.particles.size());
+    packer.pack(simulation.particles.data(), simulation.particles.size(), particle_type());
+
+    packer.pack(&simulation.matrix.rows, 1, MPI_UINT32_T);
+    packer.pack(&simulation.matrix.columns, 1, MPI_UINT32_T);
+    packer.pack_int(simulation.matrix.values.size());
+    packer.pack(simulation.matrix.values.data(), simulation.matrix.values.size(), MPI_FLOAT);
+}
+
+inline void from_string(Simulation &simulation, const std::string &data)
+{
+    Packer packer(const_cast<char*>(&data[0]), data.size());
+
+    simulation.samples.resize(packer.unpack_int());
+    packer.unpack(simulation.samples.data(), simulation.samples.size(), MPI_DOUBLE);
+
+    simulation.particles.resize(packer.unpack_int());
+    packer.unpack(simulation.particles.data(), simulation.particles.size(), particle_type());
+
+    packer.unpack(&simulation.matrix.rows, 1, MPI_UINT32_T);
+    packer.unpack(&simulation.matrix.columns, 1, MPI_UINT32_T);
+    simulation.matrix.values.resize(packer.unpack_int());
+    packer.unpack(simulation.matrix.values.data(), simulation.matrix.values.size(), MPI_FLOAT);
+}
+
+} // namespace
+
+#endif
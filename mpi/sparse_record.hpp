@@ -0,0 +1,125 @@
+#ifndef __MPI_SPARSE_RECORD_HPP_INCLUDED__
+#define __MPI_SPARSE_RECORD_HPP_INCLUDED__
+
+#include <string>
+
+#include <stdint.h>
+
+#include "mpi/packer.hpp"
+
+namespace mpi_test {
+
+// 64 optional fields: field n is integers[n / 4] when n % 4 is 0,
+// strings[n / 4] when 1, doubles[n / 4] when 2 and flags[n / 4] when 3.
+// Only the fields that are set are written, after the mask of those set.
+class SparseRecord {
+public:
+
+    static const size_t kSlots = 16;
+
+    uint64_t    present; // bit n is set when field n is
+    int64_t     integers[kSlots];
+    std::string strings[kSlots];
+    double      doubles[kSlots];
+    bool        flags[kSlots];
+
+    SparseRecord() : present(0), integers(), doubles(), flags() {}
+
+    bool has(size_t field) const {
+        return (present >> field) & 1;
+    }
+
+    bool operator==(const SparseRecord &other) const {
+        if (present != other.present) {
+            return false;
+        }
+
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if ((has(4 * slot) && integers[slot] != other.integers[slot]) ||
+                (has(4 * slot + 1) && strings[slot] != other.strings[slot]) ||
+                (has(4 * slot + 2) && doubles[slot] != other.doubles[slot]) ||
+                (has(4 * slot + 3) && flags[slot] != other.flags[slot])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const SparseRecord &other) const {
+        return !(*this == other);
+    }
+};
+
+// The mask is packed as an int64, booleans as ints and strings as their
+// int length followed by their characters.
+
+inline int determine_pack_size(const SparseRecord &record)
+{
+    int total_size = scalar_pack_size(MPI_UINT64_T);
+
+    for (size_t slot = 0; slot < SparseRecord::kSlots; slot++) {
+        if (record.has(4 * slot)) {
+            total_size += scalar_pack_size(MPI_INT64_T);
+        }
+        if (record.has(4 * slot + 1)) {
+            total_size += string_pack_size(record.strings[slot]);
+        }
+        if (record.has(4 * slot + 2)) {
+            total_size += scalar_pack_size(MPI_DOUBLE);
+        }
+        if (record.has(4 * slot + 3)) {
+            total_size += scalar_pack_size(MPI_INT);
+        }
+    }
+
+    return total_size;
+}
+
+inline void to_string(const SparseRecord &record, std::string &data)
+{
+    Packer packer(&data[0], data.size());
+
+    packer.pack(&record.present, 1, MPI_UINT64_T);
+
+    for (size_t slot = 0; slot < SparseRecord::kSlots; slot++) {
+        if (record.has(4 * slot)) {
+            packer.pack(&record.integers[slot], 1, MPI_INT64_T);
+        }
+        if (record.has(4 * slot + 1)) {
+            packer.pack_string(record.strings[slot]);
+        }
+        if (record.has(4 * slot + 2)) {
+            packer.pack(&record.doubles[slot], 1, MPI_DOUBLE);
+        }
+        if (record.has(4 * slot + 3)) {
+            packer.pack_int(record.flags[slot]);
+        }
+    }
+}
+
+inline void from_string(SparseRecord &record, const std::string &data)
+{
+    Packer packer(const_cast<char*>(&data[0]), data.size());
+
+    packer.unpack(&record.present, 1, MPI_UINT64_T);
+
+    for (size_t slot = 0; slot < SparseRecord::kSlots; slot++) {
+        if (record.has(4 * slot)) {
+            packer.unpack(&record.integers[slot], 1, MPI_INT64_T);
+        }
+        if (record.has(4 * slot + 1)) {
+            packer.unpack_string(record.strings[slot]);
+        }
+        if (record.has(4 * slot + 2)) {
+            packer.unpack(&record.doubles[slot], 1, MPI_DOUBLE);
+        }
+        if (record.has(4 * slot + 3)) {
+            record.flags[slot] = packer.unpack_int() != 0;
+        }
+    }
+}
+
+} // namespace
+
+#endif
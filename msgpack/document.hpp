@@ -0,0 +1,94 @@
+#ifndef __MSGPACK_DOCUMENT_HPP_INCLUDED__
+#define __MSGPACK_DOCUMENT_HPP_INCLUDED__
+
+#include <map>
+#include <vector>
+#include <string>
+
+#include <stdint.h>
+
+#include <msgpack.hpp>
+
+namespace msgpack_test {
+
+class Paragraph {
+public:
+
+    std::string                   text;
+    bool                          highlighted;
+    std::vector<int64_t>          offsets;
+    std::map<std::string, double> weights;
+
+    Paragraph() : highlighted(false) {}
+
+    bool operator==(const Paragraph &other) const {
+        return (text == other.text &&
+                highlighted == other.highlighted &&
+                offsets == other.offsets &&
+                weights == other.weights);
+    }
+
+    bool operator!=(const Paragraph &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(text, highlighted, offsets, weights);
+};
+
+class Section {
+public:
+
+    std::string                    name;
+    double                         weight;
+    bool                           visible;
+    std::map<std::string, int64_t> counters;
+    std::vector<Paragraph>         paragraphs;
+
+    Section() : weight(0), visible(false) {}
+
+    bool operator==(const Section &other) const {
+        return (name == other.name &&
+                weight == other.weight &&
+                visible == other.visible &&
+                counters == other.counters &&
+                paragraphs == other.paragraphs);
+    }
+
+    bool operator!=(const Section &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(name, weight, visible, counters, paragraphs);
+};
+
+class Document {
+public:
+
+    int64_t                            id;
+    std::string                        title;
+    bool                               published;
+    double                             score;
+    std::map<std::string, std::string> attributes;
+    std::vector<Section>               sections;
+
+    Document() : id(0), published(false), score(0) {}
+
+    bool operator==(const Document &other) const {
+        return (id == other.id &&
+                title == other.title &&
+                published == other.published &&
+                score == other.score &&
+                attributes == other.attributes &&
+                sections == other.sections);
+    }
+
+    bool operator!=(const Document &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(id, title, published, score, attributes, sections);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef __MSGPACK_SIMULATION_HPP_INCLUDED__
+#define __MSGPACK_SIMULATION_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+
+#include <stdint.h>
+
+#include <msgpack.hpp>
+
+namespace msgpack_test {
+
+class Particle {
+public:
+
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    Particle() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const Particle &other) const {
+        return (x == other.x &&
+                y == other.y &&
+                z == other.z &&
+                id == other.id);
+    }
+
+    bool operator!=(const Particle &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(x, y, z, id);
+};
+
+class Matrix {
+public:
+
+    uint32_t           rows;
+    uint32_t           columns;
+    std::vector<float> values; // row after row
+
+    Matrix() : rows(0), columns(0) {}
+
+    bool operator==(const Matrix &other) const {
+        return (rows == other.rows &&
+                columns == other.columns &&
+                values == other.values);
+    }
+
+    bool operator!=(const Matrix &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(rows, columns, values);
+};
+
+class Simulation {
+public:
+
+    std::vector<double>   samples;
+    std::vector<Particle> particles;
+    Matrix                matrix;
+
+    bool operator==(const Simulation &other) const {
+        return (samples == other.samples &&
+                particles == other.particles &&
+                matrix == other.matrix);
+    }
+
+    bool operator!=(const Simulation &other) const {
+        return !(*this == other);
+    }
+
+    MSGPACK_DEFINE(samples, particles, matrix);
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __MSGPACK_SPARSE_RECORD_HPP_INCLUDED__
+#define __MSGPACK_SPARSE_RECORD_HPP_INCLUDED__
+
+#include <string>
+
+#include <stdint.h>
+
+#include <msgpack.hpp>
+
+namespace msgpack_test {
+
+// 64 optional fields: field n is integers[n / 4] when n % 4 is 0,
+// strings[n / 4] when 1, doubles[n / 4] when 2 and flags[n / 4] when 3.
+// Only the fields that are set are written, after the mask of those set.
+class SparseRecord {
+public:
+
+    static const size_t kSlots = 16;
+
+    uint64_t    present; // bit n is set when field n is
+    int64_t     integers[kSlots];
+    std::string strings[kSlots];
+    double      doubles[kSlots];
+    bool        flags[kSlots];
+
+    SparseRecord() : present(0), integers(), doubles(), flags() {}
+
+    bool has(size_t field) const {
+        return (present >> field) & 1;
+    }
+
+    bool operator==(const SparseRecord &other) const {
+        if (present != other.present) {
+            return false;
+        }
+
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if ((has(4 * slot) && integers[slot] != other.integers[slot]) ||
+                (has(4 * slot + 1) && strings[slot] != other.strings[slot]) ||
+                (has(4 * slot + 2) && doubles[slot] != other.doubles[slot]) ||
+                (has(4 * slot + 3) && flags[slot] != other.flags[slot])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const SparseRecord &other) const {
+        return !(*this == other);
+    }
+
+    size_t count() const {
+        size_t result = 0;
+        for (size_t field = 0; field < 4 * kSlots; field++) {
+            result += has(field);
+        }
+        return result;
+    }
+
+    // An array of the mask followed by the fields that are set, in place
+    // of MSGPACK_DEFINE which always writes every field.
+    template <typename Packer>
+    void msgpack_pack(Packer &pk) const
+    {
+        pk.pack_array(1 + count());
+        pk.pack(present);
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if (has(4 * slot)) {
+                pk.pack(integers[slot]);
+            }
+            if (has(4 * slot + 1)) {
+                pk.pack(strings[slot]);
+            }
+            if (has(4 * slot + 2)) {
+                pk.pack(doubles[slot]);
+            }
+            if (has(4 * slot + 3)) {
+                pk.pack(flags[slot]);
+            }
+        }
+    }
+
+    void msgpack_unpack(const msgpack::object &o)
+    {
+        if (o.type != msgpack::type::ARRAY || o.via.array.size == 0) {
+            throw msgpack::type_error();
+        }
+
+        const msgpack::object *item = o.via.array.ptr;
+        (item++)->convert(&present);
+
+        if (o.via.array.size != 1 + count()) {
+            throw msgpack::type_error();
+        }
+
+        for (size_t slot = 0; slot < kSlots; slot++) {
+            if (has(4 * slot)) {
+                (item++)->convert(&integers[slot]);
+            }
+            if (has(4 * slot + 1)) {
+                (item++)->convert(&strings[slot]);
+            }
+            if (has(4 * slot + 2)) {
+                (item++)->convert(&doubles[slot]);
+            }
+            if (has(4 * slot + 3)) {
+                (item++)->convert(&flags[slot]);
+            }
+        }
+    }
+};
+
+} // namespace
+
+#endif
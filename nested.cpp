@@ -0,0 +1,773 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <hpx/config.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/document_types.h"
+#include "thrift/gen-cpp/document_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/document.pb.h"
+#include "capnproto/document.capnp.h"
+#include "boost/document.hpp"
+#include "msgpack/document.hpp"
+#include "cereal/document.hpp"
+#include "avro/document.hpp"
+#include "hpx/document.hpp"
+#include "hpx/version.hpp"
+#ifdef WITH_MPI
+#include "mpi/document.hpp"
+#endif
+#include "yas/document.hpp"
+#include "flatbuffers/document_generated.h"
+
+#include "nested.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "tests.hpp"
+
+bool
+ParagraphPayload::operator==(const ParagraphPayload &other) const
+{
+    return text == other.text && highlighted == other.highlighted &&
+           offsets == other.offsets && weights == other.weights;
+}
+
+bool
+SectionPayload::operator==(const SectionPayload &other) const
+{
+    return name == other.name && weight == other.weight && visible == other.visible &&
+           counters == other.counters && paragraphs == other.paragraphs;
+}
+
+bool
+DocumentPayload::operator==(const DocumentPayload &other) const
+{
+    return id == other.id && title == other.title && published == other.published &&
+           score == other.score && attributes == other.attributes && sections == other.sections;
+}
+
+size_t
+DocumentPayload::bytes() const
+{
+    size_t total = sizeof(id) + title.size() + 1 + sizeof(score);
+
+    for (auto it = attributes.begin(); it != attributes.end(); ++it) {
+        total += it->first.size() + it->second.size();
+    }
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        const SectionPayload &section = sections[i];
+        total += section.name.size() + sizeof(section.weight) + 1;
+
+        for (auto it = section.counters.begin(); it != section.counters.end(); ++it) {
+            total += it->first.size() + sizeof(it->second);
+        }
+
+        for (size_t j = 0; j < section.paragraphs.size(); j++) {
+            const ParagraphPayload &paragraph = section.paragraphs[j];
+            total += paragraph.text.size() + 1 + paragraph.offsets.size() * sizeof(int64_t);
+
+            for (auto it = paragraph.weights.begin(); it != paragraph.weights.end(); ++it) {
+                total += it->first.size() + sizeof(it->second);
+            }
+        }
+    }
+
+    return total;
+}
+
+DocumentPayload
+generate_document(uint64_t seed)
+{
+    Random random(seed);
+
+    DocumentPayload result;
+    result.id = static_cast<int64_t>(random.next() >> 1);
+    result.title = random.text(32);
+    result.published = true;
+    result.score = random.fraction() * 100;
+
+    for (int i = 0; i < 8; i++) {
+        result.attributes[random.text(8)] = random.text(24);
+    }
+
+    result.sections.resize(8);
+    for (size_t i = 0; i < result.sections.size(); i++) {
+        SectionPayload &section = result.sections[i];
+        section.name = random.text(16);
+        section.weight = random.fraction();
+        section.visible = random.next() % 2 == 0;
+
+        for (int j = 0; j < 4; j++) {
+            section.counters[random.text(8)] = random.between(0, 1000000);
+        }
+
+        section.paragraphs.resize(8);
+        for (size_t j = 0; j < section.paragraphs.size(); j++) {
+            ParagraphPayload &paragraph = section.paragraphs[j];
+            paragraph.text = random.text(random.between(32, 128));
+            paragraph.highlighted = random.next() % 4 == 0;
+
+            for (int k = 0; k < 4; k++) {
+                paragraph.offsets.push_back(random.between(0, 100000));
+                paragraph.weights[random.text(6)] = random.fraction();
+            }
+        }
+    }
+
+    return result;
+}
+
+DocumentPayload &
+document()
+{
+    static DocumentPayload instance;
+    return instance;
+}
+
+namespace {
+
+// Copies a document into, and back out of, the document types of thrift,
+// avro and the hand-written serializers, which all share the field names
+// of DocumentPayload.
+template <typename Document>
+void
+assign(Document &document, const DocumentPayload &data)
+{
+    typedef typename decltype(document.sections)::value_type Section;
+    typedef typename decltype(Section().paragraphs)::value_type Paragraph;
+
+    document.id = data.id;
+    document.title = data.title;
+    document.published = data.published;
+    document.score = data.score;
+    document.attributes.insert(data.attributes.begin(), data.attributes.end());
+
+    document.sections.resize(data.sections.size());
+    for (size_t i = 0; i < data.sections.size(); i++) {
+        Section &section = document.sections[i];
+        section.name = data.sections[i].name;
+        section.weight = data.sections[i].weight;
+        section.visible = data.sections[i].visible;
+        section.counters.insert(data.sections[i].counters.begin(), data.sections[i].counters.end());
+
+        section.paragraphs.resize(data.sections[i].paragraphs.size());
+        for (size_t j = 0; j < section.paragraphs.size(); j++) {
+            const ParagraphPayload &source = data.sections[i].paragraphs[j];
+            Paragraph &paragraph = section.paragraphs[j];
+            paragraph.text = source.text;
+            paragraph.highlighted = source.highlighted;
+            paragraph.offsets.assign(source.offsets.begin(), source.offsets.end());
+            paragraph.weights.insert(source.weights.begin(), source.weights.end());
+        }
+    }
+}
+
+template <typename Document>
+DocumentPayload
+payload_of(const Document &document)
+{
+    DocumentPayload result;
+
+    result.id = document.id;
+    result.title = document.title;
+    result.published = document.published;
+    result.score = document.score;
+    result.attributes.insert(document.attributes.begin(), document.attributes.end());
+
+    result.sections.resize(document.sections.size());
+    for (size_t i = 0; i < document.sections.size(); i++) {
+        SectionPayload &section = result.sections[i];
+        section.name = document.sections[i].name;
+        section.weight = document.sections[i].weight;
+        section.visible = document.sections[i].visible;
+        section.counters.insert(document.sections[i].counters.begin(), document.sections[i].counters.end());
+
+        section.paragraphs.resize(document.sections[i].paragraphs.size());
+        for (size_t j = 0; j < section.paragraphs.size(); j++) {
+            ParagraphPayload &paragraph = section.paragraphs[j];
+            paragraph.text = document.sections[i].paragraphs[j].text;
+            paragraph.highlighted = document.sections[i].paragraphs[j].highlighted;
+            paragraph.offsets.assign(document.sections[i].paragraphs[j].offsets.begin(),
+                                     document.sections[i].paragraphs[j].offsets.end());
+            paragraph.weights.insert(document.sections[i].paragraphs[j].weights.begin(),
+                                     document.sections[i].paragraphs[j].weights.end());
+        }
+    }
+
+    return result;
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+void
+thrift_nested_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Document d1, d2;
+    assign(d1, document());
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (payload_of(d2) != document()) {
+            throw std::logic_error("thrift's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            buffer1->resetBuffer();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                d1.write(&binary_protocol1);
+            } else {
+                d1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&] {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (proto == ThriftSerializationProto::Binary) {
+                d2.read(&binary_protocol2);
+            } else {
+                d2.read(&compact_protocol2);
+            }
+        },
+        check);
+
+    check();
+
+    std::string tag = proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    print_timings(tag, VERSION, timings, serialized.size());
+}
+
+void
+protobuf_nested_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    const DocumentPayload &data = document();
+
+    Document d1, d2;
+
+    d1.set_id(data.id);
+    d1.set_title(data.title);
+    d1.set_published(data.published);
+    d1.set_score(data.score);
+
+    for (auto it = data.attributes.begin(); it != data.attributes.end(); ++it) {
+        StringEntry *entry = d1.add_attributes();
+        entry->set_key(it->first);
+        entry->set_value(it->second);
+    }
+
+    for (size_t i = 0; i < data.sections.size(); i++) {
+        const SectionPayload &source = data.sections[i];
+        Section *section = d1.add_sections();
+        section->set_name(source.name);
+        section->set_weight(source.weight);
+        section->set_visible(source.visible);
+
+        for (auto it = source.counters.begin(); it != source.counters.end(); ++it) {
+            IntegerEntry *entry = section->add_counters();
+            entry->set_key(it->first);
+            entry->set_value(it->second);
+        }
+
+        for (size_t j = 0; j < source.paragraphs.size(); j++) {
+            const ParagraphPayload &text = source.paragraphs[j];
+            Paragraph *paragraph = section->add_paragraphs();
+            paragraph->set_text(text.text);
+            paragraph->set_highlighted(text.highlighted);
+
+            for (size_t k = 0; k < text.offsets.size(); k++) {
+                paragraph->add_offsets(text.offsets[k]);
+            }
+
+            for (auto it = text.weights.begin(); it != text.weights.end(); ++it) {
+                DoubleEntry *entry = paragraph->add_weights();
+                entry->set_key(it->first);
+                entry->set_value(it->second);
+            }
+        }
+    }
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (d2.SerializeAsString() != serialized || d2.sections_size() != static_cast<int>(data.sections.size())) {
+            throw std::logic_error("protobuf's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            d1.SerializeToString(&serialized);
+        },
+        [&] {
+            d2.ParseFromString(serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), timings, serialized.size());
+}
+
+void
+capnproto_nested_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    const DocumentPayload &data = document();
+
+    capnp::MallocMessageBuilder message;
+    Document::Builder d1 = message.initRoot<Document>();
+
+    d1.setId(data.id);
+    d1.setTitle(data.title);
+    d1.setPublished(data.published);
+    d1.setScore(data.score);
+
+    auto attributes = d1.initAttributes(data.attributes.size());
+    size_t index = 0;
+    for (auto it = data.attributes.begin(); it != data.attributes.end(); ++it, ++index) {
+        attributes[index].setKey(it->first);
+        attributes[index].setValue(it->second);
+    }
+
+    auto sections = d1.initSections(data.sections.size());
+    for (size_t i = 0; i < data.sections.size(); i++) {
+        const SectionPayload &source = data.sections[i];
+        Section::Builder section = sections[i];
+        section.setName(source.name);
+        section.setWeight(source.weight);
+        section.setVisible(source.visible);
+
+        auto counters = section.initCounters(source.counters.size());
+        index = 0;
+        for (auto it = source.counters.begin(); it != source.counters.end(); ++it, ++index) {
+            counters[index].setKey(it->first);
+            counters[index].setValue(it->second);
+        }
+
+        auto paragraphs = section.initParagraphs(source.paragraphs.size());
+        for (size_t j = 0; j < source.paragraphs.size(); j++) {
+            const ParagraphPayload &text = source.paragraphs[j];
+            Paragraph::Builder paragraph = paragraphs[j];
+            paragraph.setText(text.text);
+            paragraph.setHighlighted(text.highlighted);
+
+            auto offsets = paragraph.initOffsets(text.offsets.size());
+            for (size_t k = 0; k < text.offsets.size(); k++) {
+                offsets.set(k, text.offsets[k]);
+            }
+
+            auto weights = paragraph.initWeights(text.weights.size());
+            index = 0;
+            for (auto it = text.weights.begin(); it != text.weights.end(); ++it, ++index) {
+                weights[index].setKey(it->first);
+                weights[index].setValue(it->second);
+            }
+        }
+    }
+
+    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized =
+        message.getSegmentsForOutput();
+
+    size_t size = 0;
+    for (auto segment: serialized) {
+      size += segment.asBytes().size();
+    }
+
+    // as in the Record test, decoding is opening a reader and reaching the
+    // root's lists
+    size_t decoded = 0;
+
+    auto check = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        Document::Reader d2 = reader.getRoot<Document>();
+        if (decoded != data.attributes.size() + data.sections.size() || d2.getId() != data.id ||
+            d2.getSections()[0].getParagraphs()[0].getText() != data.sections[0].paragraphs[0].text.c_str()) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized = message.getSegmentsForOutput();
+        },
+        [&] {
+            capnp::SegmentArrayMessageReader reader(serialized);
+            Document::Reader d2 = reader.getRoot<Document>();
+            decoded = d2.getAttributes().size() + d2.getSections().size();
+        },
+        check);
+
+    check();
+
+    print_timings("capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION), timings, size);
+}
+
+template <typename Document, typename ToString, typename FromString>
+void
+archive_nested_test(size_t iterations, const std::string &name, const std::string &version,
+                    ToString to_string, FromString from_string)
+{
+    Document d1, d2;
+    assign(d1, document());
+
+    std::string serialized;
+
+    to_string(d1, serialized);
+    from_string(d2, serialized);
+
+    if (d1 != d2) {
+        throw std::logic_error(name + "'s case: deserialization failed");
+    }
+
+    auto check = [&] {
+        if (d1 != d2) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            to_string(d1, serialized);
+        },
+        [&] {
+            from_string(d2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings(name, version, timings, serialized.size());
+}
+
+void
+boost_nested_test(size_t iterations)
+{
+    archive_nested_test<boost_test::Document>(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION),
+        [](const boost_test::Document &d, std::string &s) { boost_test::to_string(d, s); },
+        [](boost_test::Document &d, const std::string &s) { boost_test::from_string(d, s); });
+}
+
+void
+cereal_nested_test(size_t iterations)
+{
+    archive_nested_test<cereal_test::Document>(iterations, "cereal", "",
+        [](const cereal_test::Document &d, std::string &s) { cereal_test::to_string(d, s); },
+        [](cereal_test::Document &d, const std::string &s) { cereal_test::from_string(d, s); });
+}
+
+void
+hpx_nested_test(size_t iterations)
+{
+    archive_nested_test<hpx_test::Document>(iterations, "hpx", hpx::full_version_as_string(),
+        [](const hpx_test::Document &d, std::string &s) { hpx_test::to_string(d, s); },
+        [](hpx_test::Document &d, const std::string &s) { hpx_test::from_string(d, s); });
+}
+
+#ifdef WITH_MPI
+void
+mpi_nested_test(size_t iterations)
+{
+    using namespace mpi_test;
+
+    Document d1, d2;
+    assign(d1, document());
+
+    std::string serialized(determine_pack_size(d1), ' ');
+
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
+
+    auto check = [&] {
+        if (d1 != d2) {
+            throw std::logic_error("mpi's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            to_string(d1, serialized);
+        },
+        [&] {
+            from_string(d2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("mpi", version, timings, serialized.size());
+}
+#endif
+
+void
+msgpack_nested_test(size_t iterations)
+{
+    using namespace msgpack_test;
+
+    Document d1, d2;
+    assign(d1, document());
+
+    msgpack::sbuffer sbuf;
+
+    auto check = [&] {
+        if (d1 != d2) {
+            throw std::logic_error("msgpack's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            sbuf.clear();
+            msgpack::pack(sbuf, d1);
+        },
+        [&] {
+            msgpack::unpacked msg;
+            msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+            msgpack::object obj = msg.get();
+            obj.convert(&d2);
+        },
+        check);
+
+    check();
+
+    print_timings("msgpack", msgpack_version(), timings, sbuf.size());
+}
+
+void
+avro_nested_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    Document d1, d2;
+    assign(d1, document());
+
+    std::auto_ptr<avro::OutputStream> out;
+
+    auto check = [&] {
+        if (payload_of(d2) != document()) {
+            throw std::logic_error("avro's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, d1);
+            encoder->flush();
+        },
+        [&] {
+            auto in = avro::memoryInputStream(*out);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+            avro::decode(*decoder, d2);
+        },
+        check);
+
+    check();
+
+    print_timings("avro", "", timings, out->byteCount());
+}
+
+void
+yas_nested_test(size_t iterations)
+{
+    using namespace yas_test;
+
+    Document d1, d2;
+    assign(d1, document());
+
+    std::unique_ptr<yas::mem_ostream> os;
+
+    auto check = [&] {
+        if (d1 != d2) {
+            throw std::logic_error("yas' case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            os.reset(new yas::mem_ostream());
+            yas::binary_oarchive<yas::mem_ostream> oa(*os);
+            oa & d1;
+        },
+        [&] {
+            yas::mem_istream is(os->get_intrusive_buffer());
+            yas::binary_iarchive<yas::mem_istream> ia(is);
+            ia & d2;
+        },
+        check);
+
+    check();
+
+    print_timings("yas", "", timings, os->get_intrusive_buffer().size);
+}
+
+void
+flatbuffers_nested_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    const DocumentPayload &data = document();
+
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    // children are built before their parents, as FlatBuffers requires
+    auto build = [&] {
+        builder.Clear();
+
+        std::vector<flatbuffers::Offset<StringEntry>> attributes;
+        for (auto it = data.attributes.begin(); it != data.attributes.end(); ++it) {
+            auto key = builder.CreateString(it->first);
+            auto value = builder.CreateString(it->second);
+            attributes.push_back(CreateStringEntry(builder, key, value));
+        }
+
+        std::vector<flatbuffers::Offset<Section>> sections;
+        for (size_t i = 0; i < data.sections.size(); i++) {
+            const SectionPayload &source = data.sections[i];
+
+            std::vector<flatbuffers::Offset<IntegerEntry>> counters;
+            for (auto it = source.counters.begin(); it != source.counters.end(); ++it) {
+                counters.push_back(CreateIntegerEntry(builder, builder.CreateString(it->first), it->second));
+            }
+
+            std::vector<flatbuffers::Offset<Paragraph>> paragraphs;
+            for (size_t j = 0; j < source.paragraphs.size(); j++) {
+                const ParagraphPayload &text = source.paragraphs[j];
+
+                std::vector<flatbuffers::Offset<DoubleEntry>> weights;
+                for (auto it = text.weights.begin(); it != text.weights.end(); ++it) {
+                    weights.push_back(CreateDoubleEntry(builder, builder.CreateString(it->first), it->second));
+                }
+
+                auto string = builder.CreateString(text.text);
+                auto offsets = builder.CreateVector(text.offsets);
+                auto weights_vec = builder.CreateVector(weights);
+                paragraphs.push_back(CreateParagraph(builder, string, text.highlighted, offsets, weights_vec));
+            }
+
+            auto name = builder.CreateString(source.name);
+            auto counters_vec = builder.CreateVector(counters);
+            auto paragraphs_vec = builder.CreateVector(paragraphs);
+            sections.push_back(CreateSection(builder, name, source.weight, source.visible,
+                                             counters_vec, paragraphs_vec));
+        }
+
+        auto title = builder.CreateString(data.title);
+        auto attributes_vec = builder.CreateVector(attributes);
+        auto sections_vec = builder.CreateVector(sections);
+        builder.Finish(CreateDocument(builder, data.id, title, data.published, data.score,
+                                      attributes_vec, sections_vec));
+
+        auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+        auto sz = builder.GetSize();
+        buf.assign(p, p + sz);
+
+        builder.ReleaseBufferPointer();
+    };
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // as in the Record test, encoding is building the message and copying
+    // it out, decoding is getting the root table and reaching its lists
+    size_t decoded = 0;
+
+    auto check = [&] {
+        auto d2 = GetDocument(buf.data());
+        if (decoded != data.attributes.size() + data.sections.size() || d2->id() != data.id ||
+            d2->sections()->Get(0)->paragraphs()->Get(0)->text()->str() != data.sections[0].paragraphs[0].text) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        build,
+        [&] {
+            auto d2 = GetDocument(buf.data());
+            decoded = d2->attributes()->size() + d2->sections()->size();
+        },
+        check);
+
+    check();
+
+    print_timings("flatbuffers", version, timings, buf.size());
+}
+
+} // namespace
+
+Tests
+nested_tests()
+{
+    Tests tests = {
+        {"thrift-binary",
+         [](size_t n) { thrift_nested_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_nested_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_nested_test, true},
+        {"capnproto", capnproto_nested_test, true},
+        {"boost", boost_nested_test, true},
+        {"msgpack", msgpack_nested_test, true},
+        {"cereal", cereal_nested_test, true},
+        {"avro", avro_nested_test, true},
+        {"hpx", hpx_nested_test, true},
+#ifdef WITH_MPI
+        {"mpi", mpi_nested_test, false},
+#endif
+        {"yas", yas_nested_test, true},
+        {"flatbuffers", flatbuffers_nested_test, true},
+    };
+
+    return tests;
+}
@@ -0,0 +1,66 @@
+#ifndef __NESTED_HPP_INCLUDED__
+#define __NESTED_HPP_INCLUDED__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// The nested Document every serializer builds its own document from in the
+// nested schema's tests (--schema=nested): a document with a few
+// attributes and sections, each section holding counters and paragraphs,
+// each paragraph some offsets and weights. Unlike Record it is made of
+// small objects, maps, booleans and doubles, so per-object overhead shows
+// rather than the speed of bulk array copies.
+struct ParagraphPayload {
+    std::string                   text;
+    bool                          highlighted;
+    std::vector<int64_t>          offsets;
+    std::map<std::string, double> weights;
+
+    ParagraphPayload() : highlighted(false) {}
+
+    bool operator==(const ParagraphPayload &other) const;
+};
+
+struct SectionPayload {
+    std::string                    name;
+    double                         weight;
+    bool                           visible;
+    std::map<std::string, int64_t> counters;
+    std::vector<ParagraphPayload>  paragraphs;
+
+    SectionPayload() : weight(0), visible(false) {}
+
+    bool operator==(const SectionPayload &other) const;
+};
+
+struct DocumentPayload {
+    int64_t                            id;
+    std::string                        title;
+    bool                               published;
+    double                             score;
+    std::map<std::string, std::string> attributes;
+    std::vector<SectionPayload>        sections;
+
+    DocumentPayload() : id(0), published(false), score(0) {}
+
+    bool operator==(const DocumentPayload &other) const;
+
+    bool operator!=(const DocumentPayload &other) const {
+        return !(*this == other);
+    }
+
+    // Size of the raw data: 8 bytes per integer and double, 1 per boolean,
+    // plus the characters of the strings and keys.
+    size_t bytes() const;
+};
+
+// Generates a document of 8 sections of 8 paragraphs from `seed`.
+DocumentPayload generate_document(uint64_t seed);
+
+// The document shared by the nested schema's tests.
+DocumentPayload &document();
+
+#endif
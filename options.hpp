@@ -0,0 +1,266 @@
+#ifndef __OPTIONS_HPP_INCLUDED__
+#define __OPTIONS_HPP_INCLUDED__
+
+#include <set>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include <stdlib.h>
+
+#include "workload.hpp"
+
+// Settings shared by all the serializer tests, given on the command line
+// as --name=value.
+struct Options {
+    size_t warmup;  // untimed round trips run before measuring
+    size_t runs;    // times the measured loop is repeated
+    double max_cv;  // relative standard deviation (%) above which runs are flagged as noisy
+    std::string timer; // clock (the steady clock) or tsc (the time stamp counter), see timer.hpp
+    bool counters;  // collect hardware performance counters around the measured loops
+    bool allocations; // count heap allocations made by every encode and decode
+
+    // serializers expected not to allocate once warmed up
+    std::set<std::string> allocation_free;
+
+    std::string json;      // file to write the results to as JSON
+    std::string csv;       // file to write the results to as CSV
+    std::string baseline;  // CSV results of an earlier run to compare with
+    double      threshold; // slowdown (%) beyond which a significant difference is a regression
+
+    size_t threads; // run every serializer on 1..threads threads at once, 0 to run it once on the main thread
+
+    // placements of the encode and the decode thread to compare, see placement.hpp
+    std::vector<std::string> placements;
+
+    WorkloadSpec workload; // ids and strings the records are filled with
+
+    size_t batch; // round trips timed together, 0 when not given
+    bool   tiny;  // run the tiny message suite instead of the workload
+    bool   materialize; // build every message from the payload and read back every id and string byte
+    bool   projection;  // decode only strings[0] or ids.size() and compare with a full decode
+    bool   reuse;       // also run every serializer keeping its output buffers across messages
+
+    // bytes of raw data the records cycled through add up to, see working_set.hpp
+    std::vector<size_t> working_sets;
+    bool flush; // evict the caches before every batch of encodes and of decodes
+
+    Options() : warmup(0), runs(1), max_cv(5.0), timer("clock"), counters(false), allocations(false), threshold(5.0), threads(0),
+                batch(0), tiny(false), materialize(false), projection(false),
+                reuse(false), flush(false) {}
+};
+
+inline Options &
+options()
+{
+    static Options instance;
+    return instance;
+}
+
+inline size_t
+parse_count(const std::string &name, const std::string &value)
+{
+    char *end = NULL;
+    unsigned long long result = strtoull(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || value[0] == '-') {
+        throw std::invalid_argument("--" + name + " expects a non-negative integer, got '" + value + "'");
+    }
+    return static_cast<size_t>(result);
+}
+
+inline double
+parse_number(const std::string &name, const std::string &value)
+{
+    char *end = NULL;
+    double result = strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0') {
+        throw std::invalid_argument("--" + name + " expects a number, got '" + value + "'");
+    }
+    return result;
+}
+
+// Parses a size in bytes with an optional K, M or G suffix (powers of 1024),
+// e.g. 32K or 1GB.
+inline size_t
+parse_bytes(const std::string &name, const std::string &value)
+{
+    char *end = NULL;
+    unsigned long long result = strtoull(value.c_str(), &end, 10);
+    std::string suffix = end;
+
+    unsigned long long unit = 1;
+    if (!suffix.empty() && (suffix[0] == 'K' || suffix[0] == 'k')) {
+        unit = 1ULL << 10;
+    } else if (!suffix.empty() && (suffix[0] == 'M' || suffix[0] == 'm')) {
+        unit = 1ULL << 20;
+    } else if (!suffix.empty() && (suffix[0] == 'G' || suffix[0] == 'g')) {
+        unit = 1ULL << 30;
+    }
+    if (unit != 1) {
+        suffix.erase(0, 1);
+    }
+
+    if (value.empty() || end == value.c_str() || value[0] == '-' || (!suffix.empty() && suffix != "B")) {
+        throw std::invalid_argument("--" + name + " expects a size such as 32K, 2M or 1G, got '" + value + "'");
+    }
+    return static_cast<size_t>(result * unit);
+}
+
+// Applies a single "--name=value" argument to options(), throws
+// std::invalid_argument when it is not understood.
+inline void
+parse_option(const std::string &arg)
+{
+    size_t separator = arg.find('=');
+    std::string name = arg.substr(2, separator == std::string::npos ? std::string::npos : separator - 2);
+    std::string value = separator == std::string::npos ? std::string() : arg.substr(separator + 1);
+
+    Options &opts = options();
+
+    if (name == "warmup") {
+        opts.warmup = parse_count(name, value);
+    } else if (name == "runs") {
+        opts.runs = parse_count(name, value);
+        if (opts.runs == 0) {
+            throw std::invalid_argument("--runs must be at least 1");
+        }
+    } else if (name == "max-cv") {
+        opts.max_cv = parse_number(name, value);
+    } else if (name == "timer") {
+        if (value != "clock" && value != "tsc") {
+            throw std::invalid_argument("--timer expects clock or tsc, got '" + value + "'");
+        }
+        opts.timer = value;
+    } else if (name == "counters" && separator == std::string::npos) {
+        opts.counters = true;
+    } else if (name == "allocations" && separator == std::string::npos) {
+        opts.allocations = true;
+    } else if (name == "allocation-free") {
+        std::string list = value + ",";
+        for (size_t begin = 0, end; (end = list.find(',', begin)) != std::string::npos; begin = end + 1) {
+            if (end > begin) {
+                opts.allocation_free.insert(list.substr(begin, end - begin));
+            }
+        }
+        opts.allocations = true;
+    } else if (name == "json" && !value.empty()) {
+        opts.json = value;
+    } else if (name == "csv" && !value.empty()) {
+        opts.csv = value;
+    } else if (name == "baseline" && !value.empty()) {
+        opts.baseline = value;
+    } else if (name == "threshold") {
+        opts.threshold = parse_number(name, value);
+    } else if (name == "threads") {
+        opts.threads = parse_count(name, value);
+    } else if (name == "placement" || name == "pin") {
+        if (value.empty()) {
+            throw std::invalid_argument("--" + name + " expects a value");
+        }
+        if (name == "pin") {
+            opts.placements.push_back(value);
+        } else if (value == "all") {
+            const char *all[] = {"same-core", "smt", "same-socket", "cross-socket"};
+            opts.placements.insert(opts.placements.end(), all, all + 4);
+        } else {
+            std::string list = value + ",";
+            for (size_t begin = 0, end; (end = list.find(',', begin)) != std::string::npos; begin = end + 1) {
+                if (end > begin) {
+                    opts.placements.push_back(list.substr(begin, end - begin));
+                }
+            }
+        }
+    } else if (name == "ints") {
+        opts.workload.ints = parse_count(name, value);
+    } else if (name == "int-dist" && !value.empty()) {
+        opts.workload.int_distribution = value;
+    } else if (name == "strings") {
+        opts.workload.strings = parse_count(name, value);
+    } else if (name == "string-length" && !value.empty()) {
+        opts.workload.string_distribution = value;
+    } else if (name == "seed") {
+        opts.workload.seed = parse_count(name, value);
+    } else if (name == "corpus" && !value.empty()) {
+        opts.workload.corpus = value;
+    } else if (name == "schema") {
+        if (value != "record" && value != "nested" && value != "sparse" && value != "envelope" &&
+            value != "graph" && value != "hpc" && value != "evolution") {
+            throw std::invalid_argument("unknown schema '" + value + "'");
+        }
+        opts.workload.schema = value;
+    } else if (name == "fill") {
+        opts.workload.fills.clear();
+        std::string list = value + ",";
+        for (size_t begin = 0, end; (end = list.find(',', begin)) != std::string::npos; begin = end + 1) {
+            size_t fill = parse_count(name, list.substr(begin, end - begin));
+            if (fill > 100) {
+                throw std::invalid_argument("--fill expects percentages, got " + list.substr(begin, end - begin));
+            }
+            opts.workload.fills.push_back(fill);
+        }
+    } else if (name == "batch") {
+        opts.batch = parse_count(name, value);
+        if (opts.batch == 0) {
+            throw std::invalid_argument("--batch must be at least 1");
+        }
+    } else if (name == "tiny" && separator == std::string::npos) {
+        opts.tiny = true;
+    } else if (name == "materialize" && separator == std::string::npos) {
+        opts.materialize = true;
+    } else if (name == "projection" && separator == std::string::npos) {
+        opts.projection = true;
+    } else if (name == "reuse" && separator == std::string::npos) {
+        opts.reuse = true;
+    } else if (name == "working-set") {
+        opts.working_sets.clear();
+        std::string list = separator == std::string::npos ? std::string("32K,256K,2M,16M,128M,1G,") : value + ",";
+        for (size_t begin = 0, end; (end = list.find(',', begin)) != std::string::npos; begin = end + 1) {
+            size_t bytes = parse_bytes(name, list.substr(begin, end - begin));
+            if (bytes == 0) {
+                throw std::invalid_argument("--working-set sizes must be at least 1 byte");
+            }
+            opts.working_sets.push_back(bytes);
+        }
+    } else if (name == "flush" && separator == std::string::npos) {
+        opts.flush = true;
+    } else {
+        throw std::invalid_argument("unknown option '" + arg + "'");
+    }
+}
+
+inline void
+print_options_usage()
+{
+    std::cout << " --warmup=W  -- untimed iterations run before measuring (default 0)" << std::endl;
+    std::cout << " --runs=K    -- repeat the measured iterations K times and report statistics (default 1)" << std::endl;
+    std::cout << " --max-cv=P  -- flag results whose run-to-run standard deviation exceeds P% of the mean (default 5)" << std::endl;
+    std::cout << " --timer=T   -- time with the steady clock (clock, default) or the calibrated time stamp counter (tsc, x86 only)" << std::endl;
+    std::cout << " --counters  -- report hardware performance counters (Linux perf_event_open)" << std::endl;
+    std::cout << " --allocations -- report heap allocations per encode and decode" << std::endl;
+    std::cout << " --allocation-free=S1,S2 -- fail if serializers S1, S2 allocate in steady state (implies --allocations)" << std::endl;
+    std::cout << " --json=FILE -- write the results to FILE as JSON" << std::endl;
+    std::cout << " --csv=FILE  -- write the results to FILE as CSV" << std::endl;
+    std::cout << " --baseline=FILE -- compare with the CSV results in FILE, fail on regressions" << std::endl;
+    std::cout << " --threshold=P -- smallest slowdown in % counted as a regression (default 5)" << std::endl;
+    std::cout << " --threads=T -- run every serializer on 1, 2, ... T threads at once and report the scaling" << std::endl;
+    std::cout << " --placement=P1,P2 -- encode and decode on two threads placed on the same-core, smt, same-socket, cross-socket or cross-node (NUMA nodes of one socket) CPUs (or all)" << std::endl;
+    std::cout << " --pin=E/D   -- encode on CPUs E and decode on CPUs D, e.g. 0/8 or node0/node1" << std::endl;
+    std::cout << " --ints=N    -- number of ids in every record (default 1000)" << std::endl;
+    std::cout << " --int-dist=D -- ids drawn from data (data.hpp), small, uniform64, negative, monotonic or zipf" << std::endl;
+    std::cout << " --strings=N -- number of strings in every record (default 100)" << std::endl;
+    std::cout << " --string-length=L -- string lengths from data (data.hpp), sso (1-15), medium (16-256), kb (1-8 KB) or a fixed length" << std::endl;
+    std::cout << " --seed=S    -- seed of the generated ids and strings (default 1)" << std::endl;
+    std::cout << " --corpus=FILE -- cycle through the records in FILE (JSON lines if named *.json or *.jsonl, length-prefixed otherwise)" << std::endl;
+    std::cout << " --schema=S  -- record (ids and strings, default), nested (documents of sections, paragraphs and maps), sparse (64 optional fields), envelope (a union of 16 message types), graph (polymorphic nodes held by shared pointers), hpc (bulk arrays of doubles, particles and a float matrix) or evolution (a record written and read with two versions of its schema)" << std::endl;
+    std::cout << " --fill=P1,P2 -- percentages of the sparse schema's fields set (default 1,10,100)" << std::endl;
+    std::cout << " --batch=B   -- time B encodes and then B decodes at once, for operations near the clock's resolution (not with --corpus or --working-set)" << std::endl;
+    std::cout << " --tiny      -- measure the fixed per-message cost on empty, 1-int and 1-int-1-string records (batch of 100 by default)" << std::endl;
+    std::cout << " --materialize -- build every message from the payload and checksum every id and string byte after decoding" << std::endl;
+    std::cout << " --projection -- decode only strings[0], then only ids.size(), with the serializers that can skip the rest, relative to a full decode (batch of 100 by default)" << std::endl;
+    std::cout << " --reuse     -- also run every serializer that can keep its buffers from one message to the next that way, reported as NAME-reuse" << std::endl;
+    std::cout << " --working-set[=S1,S2] -- cycle through distinct records adding up to S1, then S2... bytes of raw data (default 32K,256K,2M,16M,128M,1G)" << std::endl;
+    std::cout << " --flush     -- evict the caches before every batch of encodes and every batch of decodes, untimed (not with --threads or --placement)" << std::endl;
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "perf_counters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#endif
+
+const char *
+CounterValues::name(int event)
+{
+    static const char *names[EventCount] = {
+        "cycles",
+        "instructions",
+        "L1d misses",
+        "LLC misses",
+        "branch misses",
+        "dTLB misses"
+    };
+    return names[event];
+}
+
+#ifdef __linux__
+
+namespace {
+
+uint64_t
+cache_event(uint64_t cache, uint64_t op, uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+int
+open_counter(uint32_t type, uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    // the leader starts and stops the whole group
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+    : leader_(-1), count_(0)
+{
+    const uint32_t types[CounterValues::EventCount] = {
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE
+    };
+    const uint64_t configs[CounterValues::EventCount] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)
+    };
+
+    // the first counter opened leads the group, the others join it
+    for (int i = 0; i < CounterValues::EventCount; i++) {
+        fds_[i] = open_counter(types[i], configs[i], leader_);
+        if (fds_[i] >= 0) {
+            if (leader_ < 0) {
+                leader_ = fds_[i];
+            }
+            members_[count_++] = i;
+        }
+    }
+
+    for (int i = 0; i < 3 + CounterValues::EventCount; i++) {
+        started_[i] = 0;
+    }
+
+    if (!available()) {
+        error_ = std::string("perf_event_open failed: ") + strerror(errno);
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    // members first, the leader last
+    for (int i = CounterValues::EventCount - 1; i >= 0; i--) {
+        if (fds_[i] >= 0) {
+            close(fds_[i]);
+        }
+    }
+}
+
+bool
+PerfCounters::available() const
+{
+    return leader_ >= 0;
+}
+
+bool
+PerfCounters::read_group(uint64_t *data) const
+{
+    ssize_t size = static_cast<ssize_t>((3 + count_) * sizeof(uint64_t));
+    return read(leader_, data, size) == size && data[0] == static_cast<uint64_t>(count_);
+}
+
+// RESET would zero the counts but not the times enabled and running, so
+// both are read at start() and stop() and only their changes are used.
+void
+PerfCounters::start()
+{
+    if (leader_ < 0) {
+        return;
+    }
+
+    if (!read_group(started_)) {
+        started_[0] = 0;
+    }
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void
+PerfCounters::stop(CounterValues &values)
+{
+    if (leader_ < 0) {
+        return;
+    }
+
+    ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t data[3 + CounterValues::EventCount];
+    if (started_[0] == 0 || !read_group(data)) {
+        return;
+    }
+
+    uint64_t enabled = data[1] - started_[1];
+    uint64_t running = data[2] - started_[2];
+    if (running == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count_; i++) {
+        int event = members_[i];
+        values.measured[event] = true;
+        values.values[event] += static_cast<double>(data[3 + i] - started_[3 + i]) * enabled / running;
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters()
+    : leader_(-1), count_(0), error_("hardware counters are only supported on Linux")
+{
+    for (int i = 0; i < CounterValues::EventCount; i++) {
+        fds_[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+}
+
+bool
+PerfCounters::available() const
+{
+    return false;
+}
+
+void
+PerfCounters::start()
+{
+}
+
+void
+PerfCounters::stop(CounterValues &)
+{
+}
+
+#endif
+
+const std::string &
+PerfCounters::error() const
+{
+    return error_;
+}
@@ -0,0 +1,79 @@
+#ifndef __PERF_COUNTERS_HPP_INCLUDED__
+#define __PERF_COUNTERS_HPP_INCLUDED__
+
+#include <string>
+
+#include <stdint.h>
+
+// Hardware event counts collected over one or more measured loops.
+struct CounterValues {
+    enum Event {
+        Cycles,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        BranchMisses,
+        DtlbMisses,
+        EventCount
+    };
+
+    bool   measured[EventCount];
+    double values[EventCount];
+
+    CounterValues() {
+        for (int i = 0; i < EventCount; i++) {
+            measured[i] = false;
+            values[i] = 0;
+        }
+    }
+
+    bool any() const {
+        for (int i = 0; i < EventCount; i++) {
+            if (measured[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static const char *name(int event);
+};
+
+// Linux perf_event_open counters for the calling thread, user space only,
+// opened as one group so that they are scheduled together and their counts
+// cover the same time. Counters the kernel or the hardware refuse (no PMU
+// in a container, perf_event_paranoid too strict, non-Linux host) are
+// simply left out, and when none can be opened available() is false and
+// error() tells why.
+class PerfCounters {
+public:
+
+    PerfCounters();
+    ~PerfCounters();
+
+    bool available() const;
+    const std::string &error() const;
+
+    void start();
+    // Stops counting and adds the counts since start(), scaled for the time
+    // the group was multiplexed out over that interval, to `values`.
+    void stop(CounterValues &values);
+
+private:
+
+    PerfCounters(const PerfCounters &);
+    PerfCounters &operator=(const PerfCounters &);
+
+    // Reads the group into `data`: number of counters, time enabled, time
+    // running, then the counts in the order of members_.
+    bool read_group(uint64_t *data) const;
+
+    int fds_[CounterValues::EventCount];
+    int leader_;
+    int members_[CounterValues::EventCount]; // events in the group's order
+    int count_;
+    uint64_t started_[3 + CounterValues::EventCount];
+    std::string error_;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __PLACEMENT_HPP_INCLUDED__
+#define __PLACEMENT_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <stdexcept>
+#include <functional>
+
+#include "benchmark.hpp"
+#include "topology.hpp"
+
+typedef std::vector<std::pair<std::string, Placement> > Placements;
+
+// Turns the --placement and --pin arguments into CPU sets. On a single
+// socket split into several NUMA nodes, cross-socket falls back to
+// cross-node and is reported under that name. Placements the host can't
+// provide, e.g. cross-socket on a single node machine, are kept with no CPUs
+// and reported as unavailable.
+inline Placements
+resolve_placements(const std::vector<std::string> &specs)
+{
+    Placements placements;
+
+    for (size_t i = 0; i < specs.size(); i++) {
+        Placement cpus;
+        std::string label = specs[i];
+        size_t slash = specs[i].find('/');
+
+        if (slash != std::string::npos) {
+            cpus.encode_cpus = parse_cpus(specs[i].substr(0, slash));
+            cpus.decode_cpus = parse_cpus(specs[i].substr(slash + 1));
+        } else if (!choose_placement(specs[i], cpus.encode_cpus, cpus.decode_cpus) &&
+                   specs[i] == "cross-socket" &&
+                   choose_placement("cross-node", cpus.encode_cpus, cpus.decode_cpus)) {
+            label = "cross-node";
+        }
+
+        placements.push_back(std::make_pair(label, cpus));
+    }
+
+    return placements;
+}
+
+// Runs `test` once per placement with its encode half on one pinned
+// thread and its decode half on another, handing every serialized message
+// over between them, and prints the time per encode and decode. The test
+// itself (records, buffers) is set up on the encode CPUs so that memory is
+// first touched there.
+inline void
+run_placements(const std::string &name, const std::function<void()> &test, const Placements &placements)
+{
+    std::vector<int> everywhere;
+    std::vector<Cpu> cpus = available_cpus();
+    for (size_t i = 0; i < cpus.size(); i++) {
+        everywhere.push_back(cpus[i].id);
+    }
+
+    for (size_t i = 0; i < placements.size(); i++) {
+        const std::string &label = placements[i].first;
+        const Placement &cpus = placements[i].second;
+
+        if (cpus.encode_cpus.empty() || cpus.decode_cpus.empty()) {
+            std::cout << name << ": placement " << label << " not available on this host" << std::endl;
+            continue;
+        }
+
+        Barrier start(1);
+        Collector results(&start);
+        std::string error;
+
+        pin_current_thread(cpus.encode_cpus);
+        placement() = &cpus;
+        collector() = &results;
+
+        try {
+            test();
+        } catch (std::exception &exc) {
+            error = exc.what();
+        }
+
+        collector() = NULL;
+        placement() = NULL;
+        pin_current_thread(everywhere);
+
+        std::cout << name << ": placement " << label << ", encode on " << describe_cpus(cpus.encode_cpus)
+                  << ", decode on " << describe_cpus(cpus.decode_cpus) << std::endl;
+
+        if (!error.empty()) {
+            std::cout << name << ": FAILED: " << error << std::endl;
+            continue;
+        }
+
+        const Timings &timings = results.timings;
+        Result result = make_result(name + "@" + label, results.version, timings, results.size);
+
+        double operations = static_cast<double>(timings.iterations);
+        if (operations > 0) {
+            std::cout << name << ": encode = " << 1e6 * result.encode.mean / operations << " ns/op ("
+                      << operations / result.encode.mean * 1e3 << " ops/s), decode = "
+                      << 1e6 * result.decode.mean / operations << " ns/op ("
+                      << operations / result.decode.mean * 1e3 << " ops/s)" << std::endl;
+        }
+        print_latency(name, "encode", timings.encode_latency);
+        print_latency(name, "decode", timings.decode_latency);
+        print_allocations(name, "encode", timings.encode_allocations);
+        print_allocations(name, "decode", timings.decode_allocations);
+
+        add_result(result);
+    }
+
+    std::cout << std::endl;
+}
+
+#endif
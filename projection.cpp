@@ -0,0 +1,718 @@
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/test_types.h"
+#include "thrift/gen-cpp/test_constants.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/test.pb.h"
+#include "capnproto/test.capnp.h"
+#include "msgpack/record.hpp"
+#include "avro/record.hpp"
+#include "flatbuffers/test_generated.h"
+#include "raw/record.hpp"
+
+#include "projection.hpp"
+#include "checksum.hpp"
+#include "benchmark.hpp"
+#include "variants.hpp"
+#include "results.hpp"
+#include "tests.hpp"
+
+Projection &
+projection()
+{
+    static Projection part = Projection::Full;
+    return part;
+}
+
+uint64_t
+project(const Payload &record, Projection part)
+{
+    switch (part) {
+    case Projection::Full:
+        return checksum(record);
+    case Projection::FirstString: {
+        Checksum result;
+        if (!record.strings.empty()) {
+            result.add(record.strings[0].data(), record.strings[0].size());
+        }
+        return result.value();
+    }
+    case Projection::IdCount:
+        return record.ids.size();
+    }
+
+    return 0;
+}
+
+void
+run_projection(const std::string &name, const std::function<void()> &test)
+{
+    static const Projection parts[] = {Projection::Full, Projection::FirstString, Projection::IdCount};
+
+    std::vector<std::string> labels;
+    labels.push_back("full");
+    labels.push_back("strings[0]");
+    labels.push_back("ids.size()");
+
+    run_variants(name, test, labels, [](size_t i) { projection() = parts[i]; });
+}
+
+void
+print_projection_table()
+{
+    static const char *labels[] = {"strings[0]", "ids.size()"};
+
+    std::vector<Result> all = results();
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << "decode time of a projection, relative to a full decode:" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const std::string &name = all[i].name;
+        std::string::size_type slash = name.rfind('/');
+        if (slash == std::string::npos || name.substr(slash + 1) != "full") {
+            continue;
+        }
+
+        const Result &full = all[i];
+        std::string serializer = name.substr(0, slash);
+
+        std::cout << "  " << serializer << ":" << std::fixed << std::setprecision(3);
+        for (size_t label = 0; label < 2; label++) {
+            std::cout << (label == 0 ? " " : ", ") << labels[label] << " ";
+
+            const Result *part = NULL;
+            for (size_t j = 0; j < all.size(); j++) {
+                if (all[j].name == serializer + "/" + labels[label]) {
+                    part = &all[j];
+                }
+            }
+
+            if (part == NULL || full.decode.mean <= 0) {
+                std::cout << "n/a";
+                continue;
+            }
+            // per message, as the variants may run different iteration counts
+            double reference = full.decode.mean / full.iterations;
+            double decode = part->decode.mean / part->iterations;
+            std::cout << decode / reference << "x";
+        }
+        std::cout << std::endl;
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+
+    std::cout << std::endl;
+}
+
+namespace {
+
+// Runs a projection test: encode() writes the payload given, and decode()
+// returns what it read of the last message as project() has it, which is
+// checked for every record before the measured loop, periodically during it
+// and after it. size() is the size of the last message.
+template <typename Encode, typename Decode, typename Size>
+void
+projection_test(size_t iterations, const std::string &name, const std::string &version,
+                Encode encode, Decode decode, Size size)
+{
+    Records<Payload> records([](Payload &record, const Payload &data) {
+        record = data;
+    });
+
+    uint64_t value = 0;
+
+    auto encode_next = [&] {
+        encode(records.next());
+    };
+
+    auto decode_last = [&] {
+        value = decode();
+        do_not_optimize(value);
+    };
+
+    // check if we can read back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode_next();
+        decode_last();
+
+        if (value != project(records.last(), projection())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+
+        sizes.push_back(size());
+    }
+
+    auto check = [&] {
+        if (value != project(records.last(), projection())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode_next, decode_last, check);
+
+    check();
+
+    print_timings(name, version, timings, sizes);
+}
+
+uint64_t
+string_checksum(const char *data, size_t size)
+{
+    Checksum result;
+    result.add(data, size);
+    return result.value();
+}
+
+template <typename Record>
+void
+assign(Record &record, const Payload &data)
+{
+    record.ids.assign(data.ids.begin(), data.ids.end());
+    record.strings.assign(data.strings.begin(), data.strings.end());
+}
+
+// Only the borrowed view: it points at the ids and strings in place, so a
+// projection reads just what it returns.
+void
+raw_projection_test(size_t iterations)
+{
+    using namespace raw_test;
+
+    Record r1;
+    RecordView v2;
+    std::string serialized;
+
+    projection_test(iterations, "raw-view", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            to_string(r1, serialized);
+        },
+        [&]() -> uint64_t {
+            from_string(v2, serialized);
+
+            if (projection() == Projection::IdCount) {
+                return v2.ids_size();
+            }
+
+            if (projection() == Projection::FirstString) {
+                if (v2.strings_size() == 0) {
+                    return Checksum().value();
+                }
+                return string_checksum(v2.string_data(0), v2.string_size(0));
+            }
+
+            Checksum result;
+            for (size_t i = 0; i < v2.ids_size(); i++) {
+                result.add(v2.id(i));
+            }
+            for (size_t i = 0; i < v2.strings_size(); i++) {
+                result.add(v2.string_data(i), v2.string_size(i));
+            }
+            return result.value();
+        },
+        [&] { return serialized.size(); });
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+// Reads the fields of a Record up to the one projected, skipping the
+// others with TProtocol::skip(), which still walks every element of a list.
+// The rest of the message is left unread, but the struct is ended all the
+// same for the compact protocol to pop the field ids it keeps.
+template <typename Protocol>
+uint64_t
+thrift_project(Protocol &protocol, std::string &scratch)
+{
+    using namespace apache::thrift::protocol;
+
+    std::string name;
+    TType type;
+    int16_t id;
+    bool found = false;
+    uint64_t value = 0;
+
+    protocol.readStructBegin(name);
+
+    while (!found) {
+        protocol.readFieldBegin(name, type, id);
+        if (type == T_STOP) {
+            break;
+        }
+
+        if (type != T_LIST || (id != 1 && id != 2)) {
+            protocol.skip(type);
+            protocol.readFieldEnd();
+            continue;
+        }
+
+        TType element;
+        uint32_t size;
+        protocol.readListBegin(element, size);
+
+        if (id == 1 && projection() == Projection::IdCount) {
+            value = size;
+            found = true;
+        } else if (id == 2 && projection() == Projection::FirstString) {
+            if (size == 0) {
+                value = Checksum().value();
+            } else {
+                protocol.readString(scratch);
+                value = string_checksum(scratch.data(), scratch.size());
+            }
+            found = true;
+        } else {
+            for (uint32_t i = 0; i < size; i++) {
+                protocol.skip(element);
+            }
+            protocol.readListEnd();
+            protocol.readFieldEnd();
+        }
+    }
+
+    protocol.readStructEnd();
+
+    if (!found) {
+        throw std::logic_error("the projected field is missing");
+    }
+
+    return value;
+}
+
+void
+thrift_projection_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Record r1, r2;
+    std::string serialized;
+    std::string scratch;
+
+    bool binary = proto == ThriftSerializationProto::Binary;
+
+    projection_test(iterations, binary ? "thrift-binary" : "thrift-compact", VERSION,
+        [&](const Payload &data) {
+            assign(r1, data);
+            buffer1->resetBuffer();
+
+            if (binary) {
+                r1.write(&binary_protocol1);
+            } else {
+                r1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&]() -> uint64_t {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (projection() != Projection::Full) {
+                return binary ? thrift_project(binary_protocol2, scratch)
+                              : thrift_project(compact_protocol2, scratch);
+            }
+
+            if (binary) {
+                r2.read(&binary_protocol2);
+            } else {
+                r2.read(&compact_protocol2);
+            }
+            return checksum(r2);
+        },
+        [&] { return serialized.size(); });
+}
+
+// Reads the tags of the message up to the field projected, skipping the
+// length-delimited strings in one step and the ids one varint at a time.
+// The ids may come in several runs and have to be counted up to the end,
+// but strings[0] is the first string met.
+uint64_t
+protobuf_project(const std::string &serialized)
+{
+    using google::protobuf::io::CodedInputStream;
+    using google::protobuf::internal::WireFormatLite;
+
+    CodedInputStream input(reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+    uint64_t count = 0;
+
+    for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+        int field = WireFormatLite::GetTagFieldNumber(tag);
+        WireFormatLite::WireType type = WireFormatLite::GetTagWireType(tag);
+
+        // the ids, read inline rather than through SkipField()
+        if (type == WireFormatLite::WIRETYPE_VARINT) {
+            uint64_t id;
+            if (!input.ReadVarint64(&id)) {
+                break;
+            }
+            count += field == protobuf_test::Record::kIdsFieldNumber;
+            continue;
+        }
+
+        if (field == protobuf_test::Record::kIdsFieldNumber && projection() == Projection::IdCount) {
+            // packed by another writer: every varint ends with a byte
+            // below 0x80
+            uint32_t length;
+            const void *data;
+            int size;
+            if (type != WireFormatLite::WIRETYPE_LENGTH_DELIMITED || !input.ReadVarint32(&length)) {
+                break;
+            }
+            if (length == 0) {
+                continue;
+            }
+            if (!input.GetDirectBufferPointer(&data, &size) || static_cast<uint32_t>(size) < length) {
+                break;
+            }
+            const uint8_t *bytes = static_cast<const uint8_t*>(data);
+            for (uint32_t i = 0; i < length; i++) {
+                count += bytes[i] < 0x80;
+            }
+            input.Skip(length);
+            continue;
+        }
+
+        if (field == protobuf_test::Record::kStringsFieldNumber && projection() == Projection::FirstString &&
+            type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+            // read in place, the message being in one buffer
+            uint32_t length;
+            if (!input.ReadVarint32(&length)) {
+                break;
+            }
+            if (length == 0) {
+                return string_checksum("", 0);
+            }
+            const void *data;
+            int size;
+            if (!input.GetDirectBufferPointer(&data, &size) || static_cast<uint32_t>(size) < length) {
+                break;
+            }
+            return string_checksum(static_cast<const char*>(data), length);
+        }
+
+        if (!WireFormatLite::SkipField(&input, tag)) {
+            break;
+        }
+    }
+
+    if (!input.ConsumedEntireMessage()) {
+        throw std::logic_error("malformed message");
+    }
+
+    return projection() == Projection::IdCount ? count : Checksum().value();
+}
+
+void
+protobuf_projection_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    Record r1, r2;
+    std::string serialized;
+
+    projection_test(iterations, "protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION),
+        [&](const Payload &data) {
+            r1.Clear();
+            for (size_t i = 0; i < data.ids.size(); i++) {
+                r1.add_ids(data.ids[i]);
+            }
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                r1.add_strings(data.strings[i]);
+            }
+
+            serialized.clear();
+            r1.SerializeToString(&serialized);
+        },
+        [&]() -> uint64_t {
+            if (projection() != Projection::Full) {
+                return protobuf_project(serialized);
+            }
+
+            r2.ParseFromString(serialized);
+
+            Checksum result;
+            for (int i = 0; i < r2.ids_size(); i++) {
+                result.add(r2.ids(i));
+            }
+            for (int i = 0; i < r2.strings_size(); i++) {
+                result.add(r2.strings(i).data(), r2.strings(i).size());
+            }
+            return result.value();
+        },
+        [&] { return serialized.size(); });
+}
+
+// Read in place: a projection follows the root's pointer to the list and
+// goes no further.
+void
+capnproto_projection_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    kj::Array<capnp::word> serialized;
+
+    projection_test(iterations, "capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION),
+        [&](const Payload &data) {
+            capnp::MallocMessageBuilder message;
+            Record::Builder r1 = message.initRoot<Record>();
+
+            auto ids = r1.initIds(data.ids.size());
+            for (size_t i = 0; i < data.ids.size(); i++) {
+                ids.set(i, data.ids[i]);
+            }
+
+            auto strings = r1.initStrings(data.strings.size());
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                strings.set(i, data.strings[i]);
+            }
+
+            serialized = capnp::messageToFlatArray(message);
+        },
+        [&]() -> uint64_t {
+            capnp::FlatArrayMessageReader reader(serialized);
+            Record::Reader r2 = reader.getRoot<Record>();
+
+            if (projection() == Projection::IdCount) {
+                return r2.getIds().size();
+            }
+
+            if (projection() == Projection::FirstString) {
+                auto strings = r2.getStrings();
+                if (strings.size() == 0) {
+                    return Checksum().value();
+                }
+                auto string = strings[0];
+                return string_checksum(string.begin(), string.size());
+            }
+
+            Checksum result;
+            for (auto id: r2.getIds()) {
+                result.add(id);
+            }
+            for (auto string: r2.getStrings()) {
+                result.add(string.begin(), string.size());
+            }
+            return result.value();
+        },
+        [&] { return serialized.size() * sizeof(capnp::word); });
+}
+
+void
+flatbuffers_projection_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    projection_test(iterations, "flatbuffers", version,
+        [&](const Payload &data) {
+            builder.Clear();
+            strings.clear();
+
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                strings.push_back(builder.CreateString(data.strings[i]));
+            }
+
+            auto ids_vec = builder.CreateVector(data.ids);
+            auto strings_vec = builder.CreateVector(strings);
+            builder.Finish(CreateRecord(builder, ids_vec, strings_vec));
+
+            auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+            auto sz = builder.GetSize();
+            buf.assign(p, p + sz);
+
+            builder.ReleaseBufferPointer();
+        },
+        [&]() -> uint64_t {
+            auto r2 = GetRecord(buf.data());
+
+            if (projection() == Projection::IdCount) {
+                return r2->ids()->size();
+            }
+
+            if (projection() == Projection::FirstString) {
+                if (r2->strings()->size() == 0) {
+                    return Checksum().value();
+                }
+                const flatbuffers::String *string = r2->strings()->Get(0);
+                return string_checksum(string->c_str(), string->size());
+            }
+
+            Checksum result;
+            for (size_t i = 0; i < r2->ids()->size(); i++) {
+                result.add(r2->ids()->Get(i));
+            }
+            for (size_t i = 0; i < r2->strings()->size(); i++) {
+                const flatbuffers::String *string = r2->strings()->Get(i);
+                result.add(string->c_str(), string->size());
+            }
+            return result.value();
+        },
+        [&] { return buf.size(); });
+}
+
+// Msgpack has no way to skip a value, so a projection unpacks the whole
+// message into its object tree but converts only the part it reads.
+void
+msgpack_projection_test(size_t iterations)
+{
+    using namespace msgpack_test;
+
+    Record r1, r2;
+    msgpack::sbuffer sbuf;
+
+    projection_test(iterations, "msgpack", msgpack_version(),
+        [&](const Payload &data) {
+            assign(r1, data);
+            sbuf.clear();
+            msgpack::pack(sbuf, r1);
+        },
+        [&]() -> uint64_t {
+            msgpack::unpacked msg;
+            msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+            msgpack::object obj = msg.get();
+
+            if (projection() == Projection::Full) {
+                obj.convert(&r2);
+                return checksum(r2);
+            }
+
+            // MSGPACK_DEFINE packs the members as an array
+            if (obj.type != msgpack::type::ARRAY || obj.via.array.size != 2 ||
+                obj.via.array.ptr[0].type != msgpack::type::ARRAY ||
+                obj.via.array.ptr[1].type != msgpack::type::ARRAY) {
+                throw msgpack::type_error();
+            }
+
+            if (projection() == Projection::IdCount) {
+                return obj.via.array.ptr[0].via.array.size;
+            }
+
+            const msgpack::object &strings = obj.via.array.ptr[1];
+            if (strings.via.array.size == 0) {
+                return Checksum().value();
+            }
+            const msgpack::object &string = strings.via.array.ptr[0];
+            if (string.type != msgpack::type::STR) {
+                throw msgpack::type_error();
+            }
+            return string_checksum(string.via.str.ptr, string.via.str.size);
+        },
+        [&] { return sbuf.size(); });
+}
+
+// The binary encoder writes no byte counts for the blocks of an array, so
+// the ids are skipped by decoding them one by one.
+void
+avro_projection_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    Record r1, r2;
+    std::auto_ptr<avro::OutputStream> out;
+    std::string scratch;
+
+    projection_test(iterations, "avro", "",
+        [&](const Payload &data) {
+            assign(r1, data);
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, r1);
+            encoder->flush();
+        },
+        [&]() -> uint64_t {
+            auto in = avro::memoryInputStream(*out);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+
+            if (projection() == Projection::Full) {
+                avro::decode(*decoder, r2);
+                return checksum(r2);
+            }
+
+            uint64_t count = 0;
+            for (size_t n = decoder->arrayStart(); n != 0; n = decoder->arrayNext()) {
+                count += n;
+                for (size_t i = 0; i < n; i++) {
+                    decoder->decodeLong();
+                }
+            }
+
+            if (projection() == Projection::IdCount) {
+                return count;
+            }
+
+            if (decoder->arrayStart() == 0) {
+                return Checksum().value();
+            }
+            decoder->decodeString(scratch);
+            return string_checksum(scratch.data(), scratch.size());
+        },
+        [&] { return static_cast<size_t>(out->byteCount()); });
+}
+
+} // namespace
+
+Tests
+projection_tests()
+{
+    Tests tests = {
+        {"raw-view", raw_projection_test, true},
+        {"thrift-binary",
+         [](size_t n) { thrift_projection_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_projection_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_projection_test, true},
+        {"capnproto", capnproto_projection_test, true},
+        {"msgpack", msgpack_projection_test, true},
+        {"avro", avro_projection_test, true},
+        {"flatbuffers", flatbuffers_projection_test, true},
+    };
+
+    return tests;
+}
@@ -0,0 +1,39 @@
+#ifndef __PROJECTION_HPP_INCLUDED__
+#define __PROJECTION_HPP_INCLUDED__
+
+#include <string>
+#include <functional>
+
+#include <stdint.h>
+
+#include "workload.hpp"
+
+// The projection tests (--projection) decode only part of a record, as a
+// router reading a header field and forwarding the rest does, through the
+// cheapest way each serializer has to get at it: capnproto and flatbuffers
+// read the field in place, protobuf and thrift skip the fields before it on
+// the wire, avro skips them through its decoder and msgpack unpacks the
+// message without converting it. The other serializers only read whole
+// records and don't take part.
+enum class Projection {
+    Full,        // every id and string byte
+    FirstString, // the bytes of strings[0]
+    IdCount      // ids.size()
+};
+
+// The part of the record the projection tests decode, see run_projection().
+Projection &projection();
+
+// The value a decode of `record` returns for `part`: the checksum of the
+// values read (see checksum.hpp) or the number of ids.
+uint64_t project(const Payload &record, Projection part);
+
+// Runs `test` decoding the whole record, then strings[0] only, then
+// ids.size() only, and reports each as "name/full", "name/strings[0]" and
+// "name/ids.size()".
+void run_projection(const std::string &name, const std::function<void()> &test);
+
+// Prints the decode time of every projection relative to the full decode.
+void print_projection_table();
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __RANDOM_HPP_INCLUDED__
+#define __RANDOM_HPP_INCLUDED__
+
+#include <string>
+#include <random>
+
+#include <stdint.h>
+
+// std::mt19937_64 is specified exactly by the standard, the distributions
+// in <random> are not, so values are drawn from the raw generator.
+class Random {
+public:
+
+    explicit Random(uint64_t seed) : engine_(seed) {}
+
+    uint64_t next() {
+        return engine_();
+    }
+
+    // uniform in [low, high]
+    int64_t between(int64_t low, int64_t high) {
+        uint64_t range = static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1;
+        if (range == 0) {
+            return static_cast<int64_t>(next());
+        }
+        return static_cast<int64_t>(static_cast<uint64_t>(low) + next() % range);
+    }
+
+    // uniform in [0, 1)
+    double fraction() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // `length` letters and digits
+    std::string text(size_t length) {
+        static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+        std::string value(length, ' ');
+        for (size_t i = 0; i < length; i++) {
+            value[i] = alphabet[next() % (sizeof(alphabet) - 1)];
+        }
+        return value;
+    }
+
+private:
+
+    std::mt19937_64 engine_;
+};
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef __RAW_RECORD_HPP_INCLUDED__
+#define __RAW_RECORD_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdexcept>
+
+#include <string.h>
+#include <stdint.h>
+
+// The reference the serializers are measured against: no schema, no
+// varints, no tags, just what a hand-written copy of the record needs. A
+// message is the 64-bit count of ids followed by the ids themselves, then
+// the 64-bit count of strings, each string being its 32-bit length followed
+// by its characters, all in the host's byte order. Encoding sizes the
+// message first and copies every array with a single memcpy into a buffer
+// kept from one message to the next; decoding either copies the ids and the
+// strings out (Record) or points into the message (RecordView).
+namespace raw_test {
+
+typedef std::vector<int64_t>     Integers;
+typedef std::vector<std::string> Strings;
+
+class Record {
+public:
+
+    Integers ids;
+    Strings  strings;
+
+    bool operator==(const Record &other) {
+        return (ids == other.ids && strings == other.strings);
+    }
+
+    bool operator!=(const Record &other) {
+        return !(*this == other);
+    }
+};
+
+// A decoded message that borrows its ids and strings from the buffer it was
+// read from, which must outlive it.
+class RecordView {
+public:
+
+    RecordView() : ids_(NULL), count_(0) {}
+
+    size_t ids_size() const {
+        return count_;
+    }
+
+    int64_t id(size_t i) const {
+        int64_t value;
+        memcpy(&value, ids_ + i * sizeof(value), sizeof(value));
+        return value;
+    }
+
+    size_t strings_size() const {
+        return strings_.size();
+    }
+
+    const char *string_data(size_t i) const {
+        return strings_[i].first;
+    }
+
+    size_t string_size(size_t i) const {
+        return strings_[i].second;
+    }
+
+    bool operator==(const Record &other) const {
+        if (count_ != other.ids.size() || strings_.size() != other.strings.size()) {
+            return false;
+        }
+        if (count_ > 0 && memcmp(ids_, other.ids.data(), count_ * sizeof(int64_t)) != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < strings_.size(); i++) {
+            if (other.strings[i].compare(0, std::string::npos, strings_[i].first, strings_[i].second) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const Record &other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    friend void from_string(RecordView &view, const std::string &data);
+
+    const char *ids_;
+    size_t      count_;
+
+    std::vector<std::pair<const char*, size_t> > strings_;
+};
+
+namespace detail {
+
+inline uint64_t
+read_count(const std::string &data, size_t &offset, size_t width)
+{
+    if (data.size() - offset < width) {
+        throw std::runtime_error("raw: truncated message");
+    }
+
+    uint64_t count = 0;
+    if (width == sizeof(uint64_t)) {
+        memcpy(&count, &data[offset], sizeof(uint64_t));
+    } else {
+        uint32_t value;
+        memcpy(&value, &data[offset], sizeof(uint32_t));
+        count = value;
+    }
+    offset += width;
+    return count;
+}
+
+// Throws unless `count` items of `width` bytes are left after `offset`.
+inline void
+check_remaining(const std::string &data, size_t offset, uint64_t count, size_t width)
+{
+    if (count > (data.size() - offset) / width) {
+        throw std::runtime_error("raw: truncated message");
+    }
+}
+
+} // namespace detail
+
+// Writes `record` into `data`, replacing what it held but keeping its
+// capacity.
+inline void
+to_string(const Record &record, std::string &data)
+{
+    const uint64_t ids = record.ids.size();
+    const uint64_t strings = record.strings.size();
+
+    size_t size = 2 * sizeof(uint64_t) + ids * sizeof(int64_t) + strings * sizeof(uint32_t);
+    for (size_t i = 0; i < strings; i++) {
+        size += record.strings[i].size();
+    }
+    data.resize(size);
+
+    char *out = &data[0];
+    memcpy(out, &ids, sizeof(ids));
+    out += sizeof(ids);
+    if (ids > 0) {
+        memcpy(out, record.ids.data(), ids * sizeof(int64_t));
+        out += ids * sizeof(int64_t);
+    }
+
+    memcpy(out, &strings, sizeof(strings));
+    out += sizeof(strings);
+    for (size_t i = 0; i < strings; i++) {
+        const std::string &value = record.strings[i];
+        uint32_t length = static_cast<uint32_t>(value.size());
+        memcpy(out, &length, sizeof(length));
+        memcpy(out + sizeof(length), value.data(), length);
+        out += sizeof(length) + length;
+    }
+}
+
+// Copies the ids and strings of the message in `data` into `record`, whose
+// vectors and strings keep their capacity. Throws std::runtime_error when
+// the message is truncated.
+inline void
+from_string(Record &record, const std::string &data)
+{
+    size_t offset = 0;
+
+    uint64_t ids = detail::read_count(data, offset, sizeof(uint64_t));
+    detail::check_remaining(data, offset, ids, sizeof(int64_t));
+    record.ids.resize(ids);
+    if (ids > 0) {
+        memcpy(record.ids.data(), &data[offset], ids * sizeof(int64_t));
+        offset += ids * sizeof(int64_t);
+    }
+
+    uint64_t strings = detail::read_count(data, offset, sizeof(uint64_t));
+    detail::check_remaining(data, offset, strings, sizeof(uint32_t));
+    record.strings.resize(strings);
+    for (size_t i = 0; i < strings; i++) {
+        uint64_t length = detail::read_count(data, offset, sizeof(uint32_t));
+        detail::check_remaining(data, offset, length, 1);
+        record.strings[i].assign(&data[offset], length);
+        offset += length;
+    }
+}
+
+// Points `view` at the ids and strings of the message in `data`, without
+// copying them. Throws std::runtime_error when the message is truncated.
+inline void
+from_string(RecordView &view, const std::string &data)
+{
+    size_t offset = 0;
+
+    uint64_t ids = detail::read_count(data, offset, sizeof(uint64_t));
+    detail::check_remaining(data, offset, ids, sizeof(int64_t));
+    view.ids_ = data.data() + offset;
+    view.count_ = ids;
+    offset += ids * sizeof(int64_t);
+
+    uint64_t strings = detail::read_count(data, offset, sizeof(uint64_t));
+    detail::check_remaining(data, offset, strings, sizeof(uint32_t));
+    view.strings_.resize(strings);
+    for (size_t i = 0; i < strings; i++) {
+        uint64_t length = detail::read_count(data, offset, sizeof(uint32_t));
+        detail::check_remaining(data, offset, length, 1);
+        view.strings_[i] = std::make_pair(data.data() + offset, static_cast<size_t>(length));
+        offset += length;
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __REFLECT_RECORD_HPP_INCLUDED__
+#define __REFLECT_RECORD_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+
+#include <stdint.h>
+
+#include "reflect/reflect.hpp"
+
+namespace reflect_test {
+
+typedef std::vector<int64_t>     Integers;
+typedef std::vector<std::string> Strings;
+
+class Record {
+public:
+
+    Integers ids;
+    Strings  strings;
+
+    bool operator==(const Record &other) {
+        return (ids == other.ids && strings == other.strings);
+    }
+
+    bool operator!=(const Record &other) {
+        return !(*this == other);
+    }
+};
+
+} // namespace
+
+namespace reflect {
+
+template <>
+struct Fields<reflect_test::Record> {
+    typedef FieldList<REFLECT_FIELD(reflect_test::Record, ids),
+                      REFLECT_FIELD(reflect_test::Record, strings)> type;
+};
+
+} // namespace
+
+#endif
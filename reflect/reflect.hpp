@@ -0,0 +1,367 @@
+#ifndef __REFLECT_REFLECT_HPP_INCLUDED__
+#define __REFLECT_REFLECT_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+// A serializer driven by a field list known at compile time rather than by
+// an archive visiting the fields one call at a time. A class takes part by
+// specializing reflect::Fields with the list of its members:
+//
+//     namespace reflect {
+//     template <>
+//     struct Fields<Matrix> {
+//         typedef FieldList<REFLECT_FIELD(Matrix, rows),
+//                           REFLECT_FIELD(Matrix, columns),
+//                           REFLECT_FIELD(Matrix, values)> type;
+//     };
+//     }
+//
+// From it the layout of the message is planned when the code is compiled:
+// trivially copyable members lying next to each other in the class are
+// copied with a single memcpy, whose size is a constant, vectors of
+// trivially copyable elements are copied in bulk after their 64-bit count,
+// strings follow their 32-bit length and the other members, vectors of them
+// included, are planned the same way in turn. A class that is trivially
+// copyable as a whole is copied as a whole. Everything is written in the
+// host's byte order, with no padding between members.
+namespace reflect {
+
+// Specialized with the members of every class to serialize, see above.
+template <typename Class>
+struct Fields;
+
+template <typename... Members>
+struct FieldList {};
+
+// A member of Class, of type Type, found at Offset bytes from the start of
+// the object.
+template <typename Class, typename Type, Type Class::*Member, size_t Offset>
+struct Field {
+    typedef Type type;
+
+    static const size_t offset = Offset;
+    static const size_t size = sizeof(Type);
+    static const bool trivial = std::is_trivially_copyable<Type>::value;
+
+    static const Type &get(const Class &object) {
+        return object.*Member;
+    }
+
+    static Type &get(Class &object) {
+        return object.*Member;
+    }
+};
+
+#define REFLECT_FIELD(Class, member) \
+    ::reflect::Field<Class, decltype(Class::member), &Class::member, offsetof(Class, member)>
+
+namespace detail {
+
+// A message being read, throwing when it ends before a value.
+class Input {
+public:
+
+    Input(const char *begin, const char *end) : position_(begin), end_(end) {}
+
+    // Throws unless `count` values of `width` bytes are left.
+    void require(uint64_t count, size_t width) const {
+        if (count > static_cast<size_t>(end_ - position_) / width) {
+            throw std::runtime_error("reflect: truncated message");
+        }
+    }
+
+    void read(void *to, size_t size) {
+        require(size, 1);
+        memcpy(to, position_, size);
+        position_ += size;
+    }
+
+    const char *take(size_t size) {
+        require(size, 1);
+        const char *data = position_;
+        position_ += size;
+        return data;
+    }
+
+    bool done() const {
+        return position_ == end_;
+    }
+
+private:
+
+    const char *position_;
+    const char *end_;
+};
+
+template <typename Type, bool Trivial = std::is_trivially_copyable<Type>::value>
+struct Codec;
+
+// Whatever is trivially copyable is written as its bytes.
+template <typename Type>
+struct Codec<Type, true> {
+    static const size_t fixed = sizeof(Type);
+
+    static size_t size(const Type &) {
+        return sizeof(Type);
+    }
+
+    static void write(const Type &value, char *&out) {
+        memcpy(out, &value, sizeof(Type));
+        out += sizeof(Type);
+    }
+
+    static void read(Type &value, Input &in) {
+        in.read(&value, sizeof(Type));
+    }
+};
+
+template <>
+struct Codec<std::string, false> {
+    static const size_t fixed = sizeof(uint32_t);
+
+    static size_t size(const std::string &value) {
+        return sizeof(uint32_t) + value.size();
+    }
+
+    static void write(const std::string &value, char *&out) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        memcpy(out, &length, sizeof(length));
+        memcpy(out + sizeof(length), value.data(), length);
+        out += sizeof(length) + length;
+    }
+
+    static void read(std::string &value, Input &in) {
+        uint32_t length;
+        in.read(&length, sizeof(length));
+        value.assign(in.take(length), length);
+    }
+};
+
+// Vectors of trivially copyable elements are copied in bulk, the others
+// element by element.
+template <typename Element, bool Bulk = std::is_trivially_copyable<Element>::value>
+struct VectorCodec {
+    static size_t size(const std::vector<Element> &values) {
+        return sizeof(uint64_t) + values.size() * sizeof(Element);
+    }
+
+    static void write(const std::vector<Element> &values, char *&out) {
+        uint64_t count = values.size();
+        memcpy(out, &count, sizeof(count));
+        out += sizeof(count);
+        if (count > 0) {
+            memcpy(out, values.data(), count * sizeof(Element));
+            out += count * sizeof(Element);
+        }
+    }
+
+    static void read(std::vector<Element> &values, Input &in) {
+        uint64_t count;
+        in.read(&count, sizeof(count));
+        in.require(count, sizeof(Element));
+        values.resize(count);
+        if (count > 0) {
+            in.read(values.data(), count * sizeof(Element));
+        }
+    }
+};
+
+template <typename Element>
+struct VectorCodec<Element, false> {
+    static size_t size(const std::vector<Element> &values) {
+        size_t total = sizeof(uint64_t);
+        for (size_t i = 0; i < values.size(); i++) {
+            total += Codec<Element>::size(values[i]);
+        }
+        return total;
+    }
+
+    static void write(const std::vector<Element> &values, char *&out) {
+        uint64_t count = values.size();
+        memcpy(out, &count, sizeof(count));
+        out += sizeof(count);
+        for (size_t i = 0; i < values.size(); i++) {
+            Codec<Element>::write(values[i], out);
+        }
+    }
+
+    static void read(std::vector<Element> &values, Input &in) {
+        uint64_t count;
+        in.read(&count, sizeof(count));
+        // every element takes at least its fixed part
+        in.require(count, Codec<Element>::fixed > 0 ? Codec<Element>::fixed : 1);
+        values.resize(count);
+        for (size_t i = 0; i < values.size(); i++) {
+            Codec<Element>::read(values[i], in);
+        }
+    }
+};
+
+template <typename Element>
+struct Codec<std::vector<Element>, false> : VectorCodec<Element> {
+    static const size_t fixed = sizeof(uint64_t);
+};
+
+// The members of Class from the list still to plan, the Length bytes from
+// offset Start on being a run of trivially copyable members not copied yet.
+template <typename Class, size_t Start, size_t Length, typename... Members>
+struct Plan;
+
+// Copies the pending run, if any, then goes on with Next.
+template <typename Class, size_t Start, size_t Length, typename Next>
+struct Flush {
+    static const size_t fixed = Length + Next::fixed;
+
+    static size_t dynamic_size(const Class &object) {
+        return Next::dynamic_size(object);
+    }
+
+    static void write(const Class &object, char *&out) {
+        if (Length > 0) {
+            memcpy(out, reinterpret_cast<const char*>(&object) + Start, Length);
+            out += Length;
+        }
+        Next::write(object, out);
+    }
+
+    static void read(Class &object, Input &in) {
+        if (Length > 0) {
+            in.read(reinterpret_cast<char*>(&object) + Start, Length);
+        }
+        Next::read(object, in);
+    }
+};
+
+struct Done {
+    static const size_t fixed = 0;
+
+    template <typename Class>
+    static size_t dynamic_size(const Class &) {
+        return 0;
+    }
+
+    template <typename Class>
+    static void write(const Class &, char *&) {}
+
+    template <typename Class>
+    static void read(Class &, Input &) {}
+};
+
+// A member that isn't trivially copyable, followed by the rest.
+template <typename Class, typename Member, typename Next>
+struct Single {
+    typedef Codec<typename Member::type> MemberCodec;
+
+    static const size_t fixed = MemberCodec::fixed + Next::fixed;
+
+    static size_t dynamic_size(const Class &object) {
+        return MemberCodec::size(Member::get(object)) - MemberCodec::fixed + Next::dynamic_size(object);
+    }
+
+    static void write(const Class &object, char *&out) {
+        MemberCodec::write(Member::get(object), out);
+        Next::write(object, out);
+    }
+
+    static void read(Class &object, Input &in) {
+        MemberCodec::read(Member::get(object), in);
+        Next::read(object, in);
+    }
+};
+
+template <typename Class, size_t Start, size_t Length>
+struct Plan<Class, Start, Length> : Flush<Class, Start, Length, Done> {};
+
+template <typename Class, size_t Start, size_t Length, bool Trivial, bool Adjacent, typename... Members>
+struct Step;
+
+// a trivially copyable member right after the run: the run grows
+template <typename Class, size_t Start, size_t Length, typename Member, typename... Rest>
+struct Step<Class, Start, Length, true, true, Member, Rest...>
+    : Plan<Class, Length == 0 ? Member::offset : Start, Length + Member::size, Rest...> {};
+
+// a trivially copyable member elsewhere: it starts a new run
+template <typename Class, size_t Start, size_t Length, typename Member, typename... Rest>
+struct Step<Class, Start, Length, true, false, Member, Rest...>
+    : Flush<Class, Start, Length, Plan<Class, Member::offset, Member::size, Rest...> > {};
+
+template <typename Class, size_t Start, size_t Length, bool Adjacent, typename Member, typename... Rest>
+struct Step<Class, Start, Length, false, Adjacent, Member, Rest...>
+    : Flush<Class, Start, Length, Single<Class, Member, Plan<Class, 0, 0, Rest...> > > {};
+
+template <typename Class, size_t Start, size_t Length, typename Member, typename... Rest>
+struct Plan<Class, Start, Length, Member, Rest...>
+    : Step<Class, Start, Length, Member::trivial, Length == 0 || Start + Length == Member::offset,
+           Member, Rest...> {};
+
+template <typename Class, typename List>
+struct PlanOf;
+
+template <typename Class, typename... Members>
+struct PlanOf<Class, FieldList<Members...> > {
+    typedef Plan<Class, 0, 0, Members...> type;
+};
+
+// Classes that aren't trivially copyable are planned from their Fields.
+template <typename Class>
+struct Codec<Class, false> {
+    typedef typename PlanOf<Class, typename Fields<Class>::type>::type Layout;
+
+    // bytes every message of Class takes whatever the values
+    static const size_t fixed = Layout::fixed;
+
+    static size_t size(const Class &object) {
+        return fixed + Layout::dynamic_size(object);
+    }
+
+    static void write(const Class &object, char *&out) {
+        Layout::write(object, out);
+    }
+
+    static void read(Class &object, Input &in) {
+        Layout::read(object, in);
+    }
+};
+
+} // namespace detail
+
+// Bytes every message of Type takes whatever its values: its trivially
+// copyable members, the counts of its vectors and the lengths of its
+// strings.
+template <typename Type>
+struct FixedSize : std::integral_constant<size_t, detail::Codec<Type>::fixed> {};
+
+// Writes `object` into `data`, replacing what it held; its capacity is kept
+// when the size of the message doesn't change.
+template <typename Type>
+void
+to_string(const Type &object, std::string &data)
+{
+    data.resize(detail::Codec<Type>::size(object));
+    char *out = &data[0];
+    detail::Codec<Type>::write(object, out);
+}
+
+// Reads `object` from the message in `data`. Throws std::runtime_error
+// when the message is truncated or longer than `object`.
+template <typename Type>
+void
+from_string(Type &object, const std::string &data)
+{
+    detail::Input in(data.data(), data.data() + data.size());
+    detail::Codec<Type>::read(object, in);
+    if (!in.done()) {
+        throw std::runtime_error("reflect: trailing bytes after the message");
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __REFLECT_SIMULATION_HPP_INCLUDED__
+#define __REFLECT_SIMULATION_HPP_INCLUDED__
+
+#include <vector>
+#include <string>
+
+#include <stdint.h>
+
+#include "reflect/reflect.hpp"
+
+namespace reflect_test {
+
+// Trivially copyable, so vectors of particles are copied in bulk.
+class Particle {
+public:
+
+    double  x;
+    double  y;
+    double  z;
+    int32_t id;
+
+    Particle() : x(0), y(0), z(0), id(0) {}
+
+    bool operator==(const Particle &other) const {
+        return (x == other.x &&
+                y == other.y &&
+                z == other.z &&
+                id == other.id);
+    }
+
+    bool operator!=(const Particle &other) const {
+        return !(*this == other);
+    }
+};
+
+class Matrix {
+public:
+
+    uint32_t           rows;
+    uint32_t           columns;
+    std::vector<float> values; // row after row
+
+    Matrix() : rows(0), columns(0) {}
+
+    bool operator==(const Matrix &other) const {
+        return (rows == other.rows &&
+                columns == other.columns &&
+                values == other.values);
+    }
+
+    bool operator!=(const Matrix &other) const {
+        return !(*this == other);
+    }
+};
+
+class Simulation {
+public:
+
+    std::vector<double>   samples;
+    std::vector<Particle> particles;
+    Matrix                matrix;
+
+    bool operator==(const Simulation &other) const {
+        return (samples == other.samples &&
+                particles == other.particles &&
+                matrix == other.matrix);
+    }
+
+    bool operator!=(const Simulation &other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace
+
+namespace reflect {
+
+// rows and columns are copied together
+template <>
+struct Fields<reflect_test::Matrix> {
+    typedef FieldList<REFLECT_FIELD(reflect_test::Matrix, rows),
+                      REFLECT_FIELD(reflect_test::Matrix, columns),
+                      REFLECT_FIELD(reflect_test::Matrix, values)> type;
+};
+
+template <>
+struct Fields<reflect_test::Simulation> {
+    typedef FieldList<REFLECT_FIELD(reflect_test::Simulation, samples),
+                      REFLECT_FIELD(reflect_test::Simulation, particles),
+                      REFLECT_FIELD(reflect_test::Simulation, matrix)> type;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,639 @@
+#include "results.hpp"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+
+#include <cmath>
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include "options.hpp"
+#include "topology.hpp"
+#include "timer.hpp"
+
+namespace {
+
+std::mutex results_mutex;
+std::vector<Result> collected;
+
+// Host the results were obtained on.
+struct Host {
+    std::string hostname;
+    std::string os;
+    std::string cpu;
+    unsigned    cpus;
+    std::string compiler;
+    std::string timestamp;
+};
+
+Host
+describe_host()
+{
+    Host host;
+
+    char hostname[256] = "";
+    gethostname(hostname, sizeof(hostname) - 1);
+    host.hostname = hostname;
+
+    struct utsname system;
+    if (uname(&system) == 0) {
+        host.os = std::string(system.sysname) + " " + system.release + " " + system.machine;
+    }
+
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                host.cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+            break;
+        }
+    }
+
+    host.cpus = std::thread::hardware_concurrency();
+
+#if defined(__clang__)
+    host.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    host.compiler = std::string("gcc ") + __VERSION__;
+#else
+    host.compiler = "unknown";
+#endif
+
+    char timestamp[32] = "";
+    time_t now = time(NULL);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    host.timestamp = timestamp;
+
+    return host;
+}
+
+std::string
+json_string(const std::string &value)
+{
+    std::string result = "\"";
+    for (size_t i = 0; i < value.size(); i++) {
+        char c = value[i];
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            result += escaped;
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+std::string
+csv_string(const std::string &value)
+{
+    std::string result = "\"";
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '"') {
+            result += '"';
+        }
+        result += value[i];
+    }
+    return result + "\"";
+}
+
+void
+write_summary_json(std::ostream &out, const char *name, const Summary &summary)
+{
+    out << "\"" << name << "\": {"
+        << "\"mean\": " << summary.mean
+        << ", \"median\": " << summary.median
+        << ", \"stddev\": " << summary.stddev
+        << ", \"ci_low\": " << summary.ci_low
+        << ", \"ci_high\": " << summary.ci_high
+        << ", \"runs\": " << summary.samples
+        << ", \"outliers\": " << summary.outliers
+        << "}";
+}
+
+void
+write_percentiles_json(std::ostream &out, const char *name, const Percentiles &latency)
+{
+    out << "\"" << name << "\": {"
+        << "\"p50\": " << latency.p50
+        << ", \"p90\": " << latency.p90
+        << ", \"p99\": " << latency.p99
+        << ", \"p99.9\": " << latency.p999
+        << ", \"max\": " << latency.max
+        << "}";
+}
+
+const char *kSummaryColumns[] = {"mean", "median", "stddev", "ci_low", "ci_high", "runs"};
+const char *kPercentileColumns[] = {"p50", "p90", "p99", "p99.9", "max"};
+
+void
+write_summary_csv(std::ostream &out, const Summary &summary)
+{
+    out << "," << summary.mean << "," << summary.median << "," << summary.stddev
+        << "," << summary.ci_low << "," << summary.ci_high << "," << summary.samples;
+}
+
+void
+write_percentiles_csv(std::ostream &out, const Percentiles &latency)
+{
+    out << "," << latency.p50 << "," << latency.p90 << "," << latency.p99
+        << "," << latency.p999 << "," << latency.max;
+}
+
+std::vector<std::string>
+split_csv_line(const std::string &line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::string());
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+
+    return fields;
+}
+
+// Phase summaries of the baseline per round trip, in milliseconds, keyed
+// by serializer name.
+typedef std::map<std::string, std::map<std::string, Summary> > Baseline;
+
+Baseline
+read_baseline(const std::string &path)
+{
+    std::ifstream in(path.c_str());
+    if (!in) {
+        throw std::runtime_error("can't open baseline file '" + path + "'");
+    }
+
+    std::string line;
+    if (!std::getline(in, line)) {
+        throw std::runtime_error("baseline file '" + path + "' is empty");
+    }
+
+    std::vector<std::string> header = split_csv_line(line);
+    std::map<std::string, size_t> columns;
+    for (size_t i = 0; i < header.size(); i++) {
+        columns[header[i]] = i;
+    }
+
+    const char *phases[] = {"encode", "decode", "total"};
+    for (size_t i = 0; i < 3; i++) {
+        std::string prefix = std::string(phases[i]) + "_";
+        if (!columns.count("name") || !columns.count("iterations") || !columns.count(prefix + "mean") ||
+            !columns.count(prefix + "stddev") || !columns.count(prefix + "runs")) {
+            throw std::runtime_error("baseline file '" + path + "' is not a results CSV file");
+        }
+    }
+
+    Baseline baseline;
+
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields = split_csv_line(line);
+        if (fields.size() != header.size()) {
+            continue;
+        }
+
+        const std::string &name = fields[columns["name"]];
+        if (baseline.count(name)) {
+            throw std::runtime_error("baseline file '" + path + "' has several results named '" + name + "'");
+        }
+
+        // baselines written before the timer column were timed with the clock
+        std::string timer = columns.count("timer") ? fields[columns["timer"]] : std::string("clock");
+        if (timer != options().timer) {
+            throw std::runtime_error("baseline file '" + path + "' was timed with --timer=" + timer +
+                                     ", not --timer=" + options().timer);
+        }
+
+        // results of another schema, workload spec or corpus share names
+        // with these but measured something else
+        if (columns.count("workload") && fields[columns["workload"]] != options().workload.describe()) {
+            throw std::runtime_error("baseline file '" + path + "' was run on the workload '" +
+                                     fields[columns["workload"]] + "', not '" + options().workload.describe() + "'");
+        }
+
+        double iterations = atof(fields[columns["iterations"]].c_str());
+        if (iterations <= 0) {
+            throw std::runtime_error("baseline file '" + path + "' has no iteration count for '" + name + "'");
+        }
+
+        for (size_t i = 0; i < 3; i++) {
+            std::string prefix = std::string(phases[i]) + "_";
+            Summary &summary = baseline[name][phases[i]];
+            summary.mean = atof(fields[columns[prefix + "mean"]].c_str()) / iterations;
+            summary.stddev = atof(fields[columns[prefix + "stddev"]].c_str()) / iterations;
+            summary.samples = strtoul(fields[columns[prefix + "runs"]].c_str(), NULL, 10);
+        }
+    }
+
+    return baseline;
+}
+
+bool
+regressed(const Summary &base, const Summary &current, double threshold)
+{
+    if (base.mean <= 0 || current.mean <= base.mean * (1 + threshold / 100.0)) {
+        return false;
+    }
+
+    if (base.samples < 2 || current.samples < 2) {
+        return true;
+    }
+
+    double base_variance = base.stddev * base.stddev / base.samples;
+    double current_variance = current.stddev * current.stddev / current.samples;
+    double variance = base_variance + current_variance;
+
+    if (variance == 0) {
+        return true;
+    }
+
+    // Welch-Satterthwaite degrees of freedom
+    double df = variance * variance /
+        (base_variance * base_variance / (base.samples - 1) +
+         current_variance * current_variance / (current.samples - 1));
+
+    return (current.mean - base.mean) / std::sqrt(variance) > student_t_975(static_cast<size_t>(df));
+}
+
+} // namespace
+
+void
+add_result(const Result &result)
+{
+    std::lock_guard<std::mutex> lock(results_mutex);
+    collected.push_back(result);
+}
+
+std::vector<Result>
+results()
+{
+    std::lock_guard<std::mutex> lock(results_mutex);
+    return collected;
+}
+
+void
+print_size_table(size_t raw_bytes)
+{
+    std::vector<Result> all = results();
+    if (all.empty()) {
+        return;
+    }
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << "sizes relative to the " << raw_bytes << " bytes of raw data:" << std::endl;
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+        double ratio = raw_bytes == 0 ? 0.0 : static_cast<double>(result.size) / raw_bytes;
+        double per_iteration = result.iterations == 0 ? 0.0 : 1e6 / result.iterations;
+
+        std::cout << "  " << result.name << ": " << result.size << " bytes"
+                  << std::fixed << std::setprecision(2)
+                  << " (" << ratio << "x), encode " << result.encode.mean * per_iteration
+                  << ", decode " << result.decode.mean * per_iteration << " ns per record" << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+    std::cout << std::endl;
+}
+
+namespace {
+
+// GB/s of a phase taking `mean` milliseconds per run of `iterations` round
+// trips of `raw_bytes` each.
+double
+bandwidth(size_t raw_bytes, size_t iterations, double mean)
+{
+    return mean <= 0 ? 0.0 : static_cast<double>(raw_bytes) * iterations / (mean * 1e6);
+}
+
+// GB/s of memcpy copying `bytes` from one buffer to another, the best of 5
+// rounds of copies adding up to 256 MB or more.
+double
+copy_bandwidth(size_t bytes)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::vector<char> source(bytes, 1);
+    std::vector<char> destination(bytes, 0);
+    volatile char *last = &destination[bytes - 1];
+
+    const size_t copies = std::max<size_t>((256 << 20) / bytes, 1);
+    double best = 0;
+
+    for (int round = 0; round < 5; round++) {
+        auto start = clock::now();
+        for (size_t i = 0; i < copies; i++) {
+            source[bytes - 1] = static_cast<char>(i);
+            memcpy(&destination[0], &source[0], bytes);
+            *last;
+        }
+        auto finish = clock::now();
+
+        double seconds = std::chrono::duration<double>(finish - start).count();
+        if (seconds > 0) {
+            best = std::max(best, static_cast<double>(bytes) * copies / seconds / 1e9);
+        }
+    }
+
+    return best;
+}
+
+} // namespace
+
+void
+print_bandwidth_table(size_t raw_bytes, const std::string &baseline)
+{
+    std::vector<Result> all = results();
+    if (all.empty()) {
+        return;
+    }
+
+    const Result *reference = NULL;
+    for (size_t i = 0; i < all.size(); i++) {
+        if (all[i].name == baseline) {
+            reference = &all[i];
+        }
+    }
+
+    double reference_encode = 0;
+    double reference_decode = 0;
+    if (reference != NULL) {
+        reference_encode = bandwidth(raw_bytes, reference->iterations, reference->encode.mean);
+        reference_decode = bandwidth(raw_bytes, reference->iterations, reference->decode.mean);
+    }
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << "throughput over the " << raw_bytes << " bytes of raw data";
+    if (reference != NULL) {
+        std::cout << ", relative to " << baseline;
+    }
+    std::cout << ":" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+        double encode = bandwidth(raw_bytes, result.iterations, result.encode.mean);
+        double decode = bandwidth(raw_bytes, result.iterations, result.decode.mean);
+
+        std::cout << "  " << result.name << ": " << std::fixed << std::setprecision(2)
+                  << "encode " << encode << " GB/s";
+        if (reference != NULL && reference_encode > 0) {
+            std::cout << " (" << encode / reference_encode << "x)";
+        }
+        std::cout << ", decode " << decode << " GB/s";
+        if (reference != NULL && reference_decode > 0) {
+            std::cout << " (" << decode / reference_decode << "x)";
+        }
+        std::cout << std::endl;
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+    std::cout << std::endl;
+}
+
+void
+print_hardware_limit_table(size_t raw_bytes)
+{
+    std::vector<Result> all = results();
+    if (all.empty() || raw_bytes == 0) {
+        return;
+    }
+
+    // the source and the destination of the memory copy are each twice the
+    // size of the last level of cache
+    size_t llc = last_level_cache_size();
+    size_t memory_bytes = 2 * (llc ? llc : 32 << 20);
+
+    double cached = copy_bandwidth(raw_bytes);
+    double memory = copy_bandwidth(memory_bytes);
+    double ticks = tsc_ticks_per_nanosecond();
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << std::fixed << std::setprecision(2) << "hardware limits: memcpy of the " << raw_bytes
+              << " bytes of raw data at " << cached << " GB/s, of " << (memory_bytes >> 20) << " MB at " << memory
+              << " GB/s";
+    if (ticks > 0) {
+        // a reference clock, not the core's: turbo and power states make
+        // the core run faster or slower than these ticks
+        std::cout << ", time stamp counter (TSC) at " << ticks << " GHz";
+    }
+    std::cout << "; throughput as a percentage of either:" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+        const char *phases[] = {"encode", "decode", "round trip"};
+        const Summary *summaries[] = {&result.encode, &result.decode, &result.total};
+
+        std::cout << "  " << result.name << ":";
+        for (int phase = 0; phase < 3; phase++) {
+            double throughput = bandwidth(raw_bytes, result.iterations, summaries[phase]->mean);
+
+            std::cout << (phase == 0 ? " " : ", ") << phases[phase] << " ";
+            if (ticks > 0 && throughput > 0) {
+                std::cout << ticks / throughput << " TSC ticks/byte, ";
+            }
+            std::cout << throughput << " GB/s";
+            if (cached > 0 && memory > 0) {
+                std::cout << " (" << 100 * throughput / cached << "%, " << 100 * throughput / memory << "%)";
+            }
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+void
+write_json(const std::string &path)
+{
+    std::ofstream out(path.c_str());
+    if (!out) {
+        throw std::runtime_error("can't open '" + path + "' for writing");
+    }
+
+    Host host = describe_host();
+    std::vector<Result> all = results();
+
+    out << "{" << std::endl;
+    out << "  \"host\": {"
+        << "\"hostname\": " << json_string(host.hostname)
+        << ", \"os\": " << json_string(host.os)
+        << ", \"cpu\": " << json_string(host.cpu)
+        << ", \"cpus\": " << host.cpus
+        << ", \"compiler\": " << json_string(host.compiler)
+        << ", \"timestamp\": " << json_string(host.timestamp)
+        << "}," << std::endl;
+    out << "  \"settings\": {"
+        << "\"warmup\": " << options().warmup
+        << ", \"runs\": " << options().runs
+        << ", \"timer\": " << json_string(options().timer)
+        << ", \"workload\": " << json_string(options().workload.describe())
+        << "}," << std::endl;
+    out << "  \"results\": [" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+
+        out << "    {"
+            << "\"name\": " << json_string(result.name)
+            << ", \"version\": " << json_string(result.version)
+            << ", \"size\": " << result.size
+            << ", \"iterations\": " << result.iterations
+            << ", \"milliseconds\": {";
+        write_summary_json(out, "encode", result.encode);
+        out << ", ";
+        write_summary_json(out, "decode", result.decode);
+        out << ", ";
+        write_summary_json(out, "total", result.total);
+        out << "}, \"latency_ns\": {";
+        write_percentiles_json(out, "encode", result.encode_latency);
+        out << ", ";
+        write_percentiles_json(out, "decode", result.decode_latency);
+        out << "}}" << (i + 1 < all.size() ? "," : "") << std::endl;
+    }
+
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+void
+write_csv(const std::string &path)
+{
+    std::ofstream out(path.c_str());
+    if (!out) {
+        throw std::runtime_error("can't open '" + path + "' for writing");
+    }
+
+    Host host = describe_host();
+    std::vector<Result> all = results();
+
+    out << "name,version,size,iterations";
+    const char *phases[] = {"encode", "decode", "total"};
+    for (size_t phase = 0; phase < 3; phase++) {
+        for (size_t i = 0; i < sizeof(kSummaryColumns) / sizeof(kSummaryColumns[0]); i++) {
+            out << "," << phases[phase] << "_" << kSummaryColumns[i];
+        }
+    }
+    for (size_t phase = 0; phase < 2; phase++) {
+        for (size_t i = 0; i < sizeof(kPercentileColumns) / sizeof(kPercentileColumns[0]); i++) {
+            out << "," << phases[phase] << "_" << kPercentileColumns[i] << "_ns";
+        }
+    }
+    out << ",workload,timer,hostname,os,cpu,cpus,compiler,timestamp" << std::endl;
+
+    std::string workload = options().workload.describe();
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+
+        out << csv_string(result.name) << "," << csv_string(result.version)
+            << "," << result.size << "," << result.iterations;
+        write_summary_csv(out, result.encode);
+        write_summary_csv(out, result.decode);
+        write_summary_csv(out, result.total);
+        write_percentiles_csv(out, result.encode_latency);
+        write_percentiles_csv(out, result.decode_latency);
+        out << "," << csv_string(workload) << "," << csv_string(options().timer)
+            << "," << csv_string(host.hostname) << "," << csv_string(host.os)
+            << "," << csv_string(host.cpu) << "," << host.cpus
+            << "," << csv_string(host.compiler) << "," << csv_string(host.timestamp) << std::endl;
+    }
+}
+
+size_t
+compare_with_baseline(const std::string &path, double threshold)
+{
+    Baseline baseline = read_baseline(path);
+    std::vector<Result> all = results();
+
+    size_t regressions = 0;
+
+    std::cout << "comparison with baseline " << path << ":" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const Result &result = all[i];
+
+        Baseline::const_iterator base = baseline.find(result.name);
+        if (base == baseline.end()) {
+            std::cout << result.name << ": not in baseline" << std::endl;
+            continue;
+        }
+
+        const char *phases[] = {"encode", "decode", "total"};
+        const Summary *summaries[] = {&result.encode, &result.decode, &result.total};
+
+        bool failed = false;
+        for (size_t phase = 0; phase < 3; phase++) {
+            const Summary &before = base->second.find(phases[phase])->second;
+
+            // per round trip, as the runs may have different iteration counts
+            Summary current = *summaries[phase];
+            double iterations = static_cast<double>(std::max<size_t>(result.iterations, 1));
+            current.mean /= iterations;
+            current.stddev /= iterations;
+
+            double change = before.mean > 0 ? 100.0 * (current.mean - before.mean) / before.mean : 0;
+            bool worse = regressed(before, current, threshold);
+
+            std::cout << result.name << ": " << phases[phase] << " " << 1e6 * before.mean << " -> "
+                      << 1e6 * current.mean << " ns per round trip (" << (change >= 0 ? "+" : "")
+                      << change << "%)" << (worse ? " REGRESSION" : "") << std::endl;
+
+            failed = failed || worse;
+        }
+
+        if (failed) {
+            regressions++;
+        }
+    }
+
+    std::cout << std::endl;
+
+    return regressions;
+}
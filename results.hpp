@@ -0,0 +1,76 @@
+#ifndef __RESULTS_HPP_INCLUDED__
+#define __RESULTS_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "statistics.hpp"
+
+// Latency percentiles of single operations, in nanoseconds.
+struct Percentiles {
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+
+    Percentiles() : p50(0), p90(0), p99(0), p999(0), max(0) {}
+};
+
+// Outcome of one serializer test, as written to the JSON and CSV reports.
+// Times are milliseconds per run of `iterations` round trips.
+struct Result {
+    std::string name;
+    std::string version;
+    size_t      size;
+    size_t      iterations;
+
+    Summary     encode;
+    Summary     decode;
+    Summary     total;
+
+    Percentiles encode_latency;
+    Percentiles decode_latency;
+
+    Result() : size(0), iterations(0) {}
+};
+
+void add_result(const Result &result);
+std::vector<Result> results();
+
+// Prints the encoded size of every result relative to `raw_bytes`, the
+// size of the payload itself, next to its mean encode and decode times.
+// Comparing the table across workloads shows where varint encodings win
+// over fixed-width ones and where they lose.
+void print_size_table(size_t raw_bytes);
+
+// Prints the encode and decode throughput of every result in GB/s of the
+// `raw_bytes` of payload, and relative to the result named `baseline` when
+// there is one.
+void print_bandwidth_table(size_t raw_bytes, const std::string &baseline);
+
+// Prints how far every result is from the hardware: its time stamp counter
+// ticks per byte of the `raw_bytes` of payload, a reference clock rather
+// than core cycles, and its throughput as a percentage of memcpy's on a
+// buffer of `raw_bytes`, which stays in the caches, and on buffers twice
+// the size of the last level of cache, which don't.
+void print_hardware_limit_table(size_t raw_bytes);
+
+void write_json(const std::string &path);
+void write_csv(const std::string &path);
+
+// Compares the collected results with a CSV report written by an earlier
+// run and prints the verdict for every serializer found in both. Times are
+// compared per round trip, so the runs may use different iteration counts,
+// but not different timers or workloads. A phase counts as regressed when
+// its mean time grew by more than `threshold` percent and, when both sides
+// were repeated, Welch's t-test finds the difference significant at 95%.
+// Returns the number of regressed results; throws std::runtime_error when
+// the file can't be read, holds a result twice, was timed with another
+// --timer or was run on another workload (--schema, workload spec or
+// --corpus).
+size_t compare_with_baseline(const std::string &path, double threshold);
+
+#endif
@@ -0,0 +1,494 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/test_types.h"
+#include "thrift/gen-cpp/test_constants.h"
+
+#include <avro/Stream.hh>
+
+#include "protobuf/test.pb.h"
+#include "boost/record.hpp"
+#include "cereal/record.hpp"
+#include "avro/record.hpp"
+#ifdef WITH_MPI
+#include "mpi/record.hpp"
+#endif
+#include "yas/record.hpp"
+#include "flatbuffers/test_generated.h"
+
+#include "workload.hpp"
+#include "benchmark.hpp"
+#include "tests.hpp"
+
+namespace {
+
+// Runs a reuse test on `records`: encode(record) writes a record into the
+// buffers the test keeps, decode() reads the last message back and
+// matches(record) tells whether it reproduced `record`. size() is the size
+// of the last message. Reported as "name-reuse".
+template <typename Record, typename Encode, typename Decode, typename Size, typename Matches>
+void
+reuse_test(size_t iterations, const std::string &name, const std::string &version, Records<Record> &records,
+           Encode encode, Decode decode, Size size, Matches matches)
+{
+    auto encode_next = [&] {
+        encode(records.next());
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode_next();
+        decode();
+
+        if (!matches(records.last())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+
+        sizes.push_back(size());
+    }
+
+    auto check = [&] {
+        if (!matches(records.last())) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode_next, decode, check);
+
+    check();
+
+    print_timings(name + "-reuse", version, timings, sizes);
+}
+
+template <typename Record>
+void
+assign(Record &record, const Payload &data)
+{
+    record.ids.assign(data.ids.begin(), data.ids.end());
+    record.strings.assign(data.strings.begin(), data.strings.end());
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+// The message is read straight from the writing transport's buffer rather
+// than from a copy of it.
+void
+thrift_reuse_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    uint8_t *serialized = NULL;
+    uint32_t size = 0;
+
+    bool binary = proto == ThriftSerializationProto::Binary;
+
+    reuse_test(iterations, binary ? "thrift-binary" : "thrift-compact", VERSION, records,
+        [&](const Record &r1) {
+            buffer1->resetBuffer();
+
+            if (binary) {
+                r1.write(&binary_protocol1);
+            } else {
+                r1.write(&compact_protocol1);
+            }
+
+            buffer1->getBuffer(&serialized, &size);
+        },
+        [&] {
+            buffer2->resetBuffer(serialized, size);
+
+            if (binary) {
+                r2.read(&binary_protocol2);
+            } else {
+                r2.read(&compact_protocol2);
+            }
+        },
+        [&] { return static_cast<size_t>(size); },
+        [&](const Record &r1) { return r1 == r2; });
+}
+
+// ByteSize() gives the exact size of the message, which is then written
+// into a buffer that only ever grows, with the sizes it cached.
+void
+protobuf_reuse_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.add_ids(data.ids[i]);
+        }
+
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.add_strings(data.strings[i]);
+        }
+    });
+
+    Record r2;
+    std::vector<uint8_t> buffer;
+    int size = 0;
+
+    reuse_test(iterations, "protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), records,
+        [&](const Record &r1) {
+            size = r1.ByteSize();
+            if (buffer.size() < static_cast<size_t>(size)) {
+                buffer.resize(size);
+            }
+            r1.SerializeWithCachedSizesToArray(buffer.data());
+        },
+        [&] {
+            r2.ParseFromArray(buffer.data(), size);
+        },
+        [&] { return static_cast<size_t>(size); },
+        [&](const Record &) {
+            return r2.SerializeAsString() == std::string(reinterpret_cast<const char*>(buffer.data()), size);
+        });
+}
+
+void
+boost_reuse_test(size_t iterations)
+{
+    using namespace boost_test;
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    std::string serialized;
+
+    reuse_test(iterations, "boost", boost::lexical_cast<std::string>(BOOST_VERSION), records,
+        [&](const Record &r1) {
+            to_buffer(r1, serialized);
+        },
+        [&] {
+            from_buffer(r2, serialized);
+        },
+        [&] { return serialized.size(); },
+        [&](const Record &r1) { return const_cast<Record&>(r1) == r2; });
+}
+
+void
+cereal_reuse_test(size_t iterations)
+{
+    using namespace cereal_test;
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    std::string serialized;
+
+    reuse_test(iterations, "cereal", "", records,
+        [&](const Record &r1) {
+            to_buffer(r1, serialized);
+        },
+        [&] {
+            from_buffer(r2, serialized);
+        },
+        [&] { return serialized.size(); },
+        [&](const Record &r1) { return const_cast<Record&>(r1) == r2; });
+}
+
+// An avro output stream over a byte vector kept from one message to the
+// next: reset() starts a message over without freeing the memory.
+class VectorOutputStream : public avro::OutputStream {
+public:
+
+    VectorOutputStream() : size_(0) {}
+
+    void reset() {
+        size_ = 0;
+    }
+
+    const uint8_t *data() const {
+        return data_.data();
+    }
+
+    bool next(uint8_t **data, size_t *len) {
+        if (size_ == data_.size()) {
+            data_.resize(std::max<size_t>(4096, 2 * data_.size()));
+        }
+        *data = &data_[size_];
+        *len = data_.size() - size_;
+        size_ = data_.size();
+        return true;
+    }
+
+    void backup(size_t len) {
+        size_ -= len;
+    }
+
+    uint64_t byteCount() const {
+        return size_;
+    }
+
+    void flush() {
+    }
+
+private:
+
+    std::vector<uint8_t> data_;
+    size_t size_;
+};
+
+// An avro input stream reading an array it doesn't own, set by reset().
+class ArrayInputStream : public avro::InputStream {
+public:
+
+    ArrayInputStream() : data_(NULL), size_(0), position_(0) {}
+
+    void reset(const uint8_t *data, size_t size) {
+        data_ = data;
+        size_ = size;
+        position_ = 0;
+    }
+
+    bool next(const uint8_t **data, size_t *len) {
+        if (position_ == size_) {
+            return false;
+        }
+        *data = data_ + position_;
+        *len = size_ - position_;
+        position_ = size_;
+        return true;
+    }
+
+    void backup(size_t len) {
+        position_ -= len;
+    }
+
+    void skip(size_t len) {
+        position_ += std::min(len, size_ - position_);
+    }
+
+    size_t byteCount() const {
+        return position_;
+    }
+
+private:
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t position_;
+};
+
+// The encoder, the decoder and their streams are made once and only
+// re-initialized for every message.
+void
+avro_reuse_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    VectorOutputStream out;
+    ArrayInputStream in;
+
+    auto encoder = avro::binaryEncoder();
+    auto decoder = avro::binaryDecoder();
+
+    reuse_test(iterations, "avro", "", records,
+        [&](const Record &r1) {
+            out.reset();
+            encoder->init(out);
+            avro::encode(*encoder, r1);
+            encoder->flush();
+        },
+        [&] {
+            in.reset(out.data(), out.byteCount());
+            decoder->init(in);
+            avro::decode(*decoder, r2);
+        },
+        [&] { return static_cast<size_t>(out.byteCount()); },
+        [&](const Record &r1) { return r1.ids == r2.ids && r1.strings == r2.strings; });
+}
+
+#ifdef WITH_MPI
+// Every message is packed into a buffer of the size determine_pack_size()
+// gives for it, rather than into one sized for the largest record.
+void
+mpi_reuse_test(size_t iterations)
+{
+    using namespace mpi_test;
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    std::string serialized;
+
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
+
+    reuse_test(iterations, "mpi", version, records,
+        [&](const Record &r1) {
+            serialized.resize(determine_pack_size(r1));
+            to_string(r1, serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+        },
+        [&] { return serialized.size(); },
+        [&](const Record &r1) { return const_cast<Record&>(r1) == r2; });
+}
+#endif
+
+// A yas output stream appending to a string kept from one message to the
+// next, in place of a new mem_ostream for every message.
+class StringOStream {
+public:
+
+    explicit StringOStream(std::string &data) : data_(data) {}
+
+    std::size_t write(const void *ptr, std::size_t size) {
+        data_.append(static_cast<const char*>(ptr), size);
+        return size;
+    }
+
+    void flush() {
+    }
+
+private:
+
+    std::string &data_;
+};
+
+void
+yas_reuse_test(size_t iterations)
+{
+    using namespace yas_test;
+
+    Records<Record> records(assign<Record>);
+
+    Record r2;
+    std::string serialized;
+
+    reuse_test(iterations, "yas", "", records,
+        [&](const Record &r1) {
+            serialized.clear();
+            StringOStream os(serialized);
+            yas::binary_oarchive<StringOStream> oa(os);
+            oa & r1;
+        },
+        [&] {
+            yas::mem_istream is(serialized.data(), serialized.size());
+            yas::binary_iarchive<yas::mem_istream> ia(is);
+            ia & r2;
+        },
+        [&] { return serialized.size(); },
+        [&](const Record &r1) { return const_cast<Record&>(r1) == r2; });
+}
+
+// The message is read in place from the builder's buffer rather than from
+// a copy of it.
+void
+flatbuffers_reuse_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    Records<Payload> records([](Payload &record, const Payload &data) {
+        record = data;
+    });
+
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    flatbuffers::FlatBufferBuilder builder;
+    size_t decoded = 0;
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    reuse_test(iterations, "flatbuffers", version, records,
+        [&](const Payload &data) {
+            builder.Clear();
+            strings.clear();
+
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                strings.push_back(builder.CreateString(data.strings[i]));
+            }
+
+            auto ids_vec = builder.CreateVector(data.ids);
+            auto strings_vec = builder.CreateVector(strings);
+            builder.Finish(CreateRecord(builder, ids_vec, strings_vec));
+        },
+        [&] {
+            auto r2 = GetRecord(builder.GetBufferPointer());
+            decoded = r2->ids()->size() + r2->strings()->size();
+        },
+        [&] { return static_cast<size_t>(builder.GetSize()); },
+        [&](const Payload &data) {
+            auto r2 = GetRecord(builder.GetBufferPointer());
+            if (decoded != data.ids.size() + data.strings.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < data.ids.size(); i++) {
+                if (r2->ids()->Get(i) != data.ids[i]) {
+                    return false;
+                }
+            }
+            for (size_t i = 0; i < data.strings.size(); i++) {
+                if (r2->strings()->Get(i)->str() != data.strings[i]) {
+                    return false;
+                }
+            }
+            return true;
+        });
+}
+
+} // namespace
+
+Tests
+reuse_tests()
+{
+    Tests tests = {
+        {"thrift-binary-reuse",
+         [](size_t n) { thrift_reuse_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact-reuse",
+         [](size_t n) { thrift_reuse_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf-reuse", protobuf_reuse_test, true},
+        {"boost-reuse", boost_reuse_test, true},
+        {"cereal-reuse", cereal_reuse_test, true},
+        {"avro-reuse", avro_reuse_test, true},
+#ifdef WITH_MPI
+        {"mpi-reuse", mpi_reuse_test, false},
+#endif
+        {"yas-reuse", yas_reuse_test, true},
+        {"flatbuffers-reuse", flatbuffers_reuse_test, true},
+    };
+
+    return tests;
+}
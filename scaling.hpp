@@ -0,0 +1,116 @@
+#ifndef __SCALING_HPP_INCLUDED__
+#define __SCALING_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+#include "benchmark.hpp"
+
+inline void
+print_scaling(const std::string &name, size_t threads, double throughput, double speedup, const Timings &timings)
+{
+    std::cout << name << ": threads = " << threads
+              << ", throughput = " << throughput << " round trips/s"
+              << ", speedup = " << speedup
+              << " (" << 100.0 * speedup / threads << "% efficiency)" << std::endl;
+    print_latency(name, "per-thread encode", timings.encode_latency);
+    print_latency(name, "per-thread decode", timings.decode_latency);
+}
+
+// Runs `test` on 1, 2, ... `max_threads` threads at once. Every thread runs
+// the whole test, so it builds its own records and buffers, and the threads
+// are released together once they are all warmed up. For each thread count
+// the aggregate throughput and the latency of single operations on any
+// thread are printed. Serializers known to keep shared state are run on one
+// thread only, and a thread count at which a test fails, e.g. because a
+// round trip no longer reproduces the record, is reported and ends the
+// scaling for that serializer.
+inline void
+run_scaling(const std::string &name, const std::function<void()> &test, size_t max_threads, bool thread_safe)
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    double single = 0;
+
+    for (size_t threads = 1; threads <= max_threads; threads++) {
+        if (threads > 1 && !thread_safe) {
+            std::cout << name << ": not thread-safe, not run on more than one thread" << std::endl;
+            break;
+        }
+
+        Barrier start(threads + 1);
+        std::vector<Collector> collectors(threads, Collector(&start));
+        std::vector<std::string> errors(threads);
+        std::vector<std::thread> workers;
+
+        for (size_t t = 0; t < threads; t++) {
+            workers.push_back(std::thread([&, t] {
+                collector() = &collectors[t];
+
+                try {
+                    test();
+                } catch (std::exception &exc) {
+                    errors[t] = exc.what();
+                }
+
+                // don't leave the others waiting when failing before measuring
+                if (!collectors[t].started) {
+                    start.wait();
+                }
+
+                if (errors[t].empty() && !collectors[t].reported) {
+                    errors[t] = "no results reported";
+                }
+
+                collector() = NULL;
+            }));
+        }
+
+        start.wait();
+        auto begin = clock::now();
+        for (size_t t = 0; t < threads; t++) {
+            workers[t].join();
+        }
+        auto finish = clock::now();
+
+        std::string error;
+        Timings timings;
+
+        for (size_t t = 0; t < threads; t++) {
+            if (!errors[t].empty()) {
+                error = errors[t];
+            } else {
+                timings.merge(collectors[t].timings);
+            }
+        }
+
+        if (!error.empty() && threads == 1) {
+            std::cout << name << ": FAILED: " << error << std::endl;
+            break;
+        }
+
+        if (!error.empty()) {
+            std::cout << name << ": FAILED on " << threads << " threads, not thread-safe: " << error << std::endl;
+            break;
+        }
+
+        double seconds = std::chrono::duration<double>(finish - begin).count();
+        double throughput = seconds > 0 ? timings.round_trips() / seconds : 0;
+        if (threads == 1) {
+            single = throughput;
+        }
+
+        print_scaling(name, threads, throughput, single > 0 ? throughput / single : 0, timings);
+
+        add_result(make_result(name + "@" + std::to_string(threads), collectors[0].version,
+                               timings, collectors[0].size));
+    }
+
+    std::cout << std::endl;
+}
+
+#endif
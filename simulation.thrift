@@ -0,0 +1,23 @@
+namespace cpp thrift_test
+
+// The bulk arrays of a simulation step. Thrift has no 32-bit floating
+// point type, the matrix is written as doubles.
+
+struct Particle {
+    1: required double x,
+    2: required double y,
+    3: required double z,
+    4: required i32    id
+}
+
+struct Matrix {
+    1: required i32          rows,
+    2: required i32          columns,
+    3: required list<double> values
+}
+
+struct Simulation {
+    1: required list<double>   samples,
+    2: required list<Particle> particles,
+    3: required Matrix         matrix
+}
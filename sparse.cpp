@@ -0,0 +1,672 @@
+#include <string>
+#include <utility>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <hpx/config.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/sparse_types.h"
+#include "thrift/gen-cpp/sparse_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include "protobuf/sparse.pb.h"
+#include "capnproto/sparse.capnp.h"
+#include "boost/sparse_record.hpp"
+#include "msgpack/sparse_record.hpp"
+#include "cereal/sparse_record.hpp"
+#include "avro/sparse_record.hpp"
+#include "hpx/sparse_record.hpp"
+#include "hpx/version.hpp"
+#ifdef WITH_MPI
+#include "mpi/sparse_record.hpp"
+#endif
+#include "yas/sparse_record.hpp"
+#include "flatbuffers/sparse_generated.h"
+
+#include "sparse.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "variants.hpp"
+#include "tests.hpp"
+
+SparsePayload::SparsePayload() : present(0), integers(), doubles(), flags()
+{
+}
+
+bool
+SparsePayload::operator==(const SparsePayload &other) const
+{
+    if (present != other.present) {
+        return false;
+    }
+
+    for (size_t slot = 0; slot < kSparseSlots; slot++) {
+        if ((has(4 * slot) && integers[slot] != other.integers[slot]) ||
+            (has(4 * slot + 1) && strings[slot] != other.strings[slot]) ||
+            (has(4 * slot + 2) && doubles[slot] != other.doubles[slot]) ||
+            (has(4 * slot + 3) && flags[slot] != other.flags[slot])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t
+SparsePayload::count() const
+{
+    size_t result = 0;
+    for (size_t field = 0; field < kSparseFields; field++) {
+        result += has(field);
+    }
+    return result;
+}
+
+size_t
+SparsePayload::bytes() const
+{
+    size_t total = 0;
+
+    for (size_t slot = 0; slot < kSparseSlots; slot++) {
+        total += has(4 * slot) ? sizeof(int64_t) : 0;
+        total += has(4 * slot + 1) ? strings[slot].size() : 0;
+        total += has(4 * slot + 2) ? sizeof(double) : 0;
+        total += has(4 * slot + 3) ? 1 : 0;
+    }
+
+    return total;
+}
+
+SparsePayload
+generate_sparse(size_t fill, uint64_t seed)
+{
+    Random random(seed);
+
+    size_t count = (kSparseFields * fill + 50) / 100;
+    if (fill > 0 && count == 0) {
+        count = 1;
+    }
+
+    // the first `count` fields of a shuffled list of all of them
+    size_t fields[kSparseFields];
+    for (size_t i = 0; i < kSparseFields; i++) {
+        fields[i] = i;
+    }
+    for (size_t i = 0; i < count; i++) {
+        std::swap(fields[i], fields[random.between(i, kSparseFields - 1)]);
+    }
+
+    SparsePayload result;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t field = fields[i];
+        size_t slot = field / 4;
+
+        result.mark(field);
+
+        switch (field % 4) {
+        case 0: result.integers[slot] = random.between(1, 1000000); break;
+        case 1: result.strings[slot] = random.text(random.between(4, 32)); break;
+        case 2: result.doubles[slot] = 1 + random.fraction(); break;
+        case 3: result.flags[slot] = true; break;
+        }
+    }
+
+    return result;
+}
+
+SparsePayload &
+sparse()
+{
+    static SparsePayload instance;
+    return instance;
+}
+
+void
+run_sparse(const std::string &name, const std::function<void()> &test,
+           const std::vector<size_t> &fills, uint64_t seed)
+{
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < fills.size(); i++) {
+        labels.push_back(boost::lexical_cast<std::string>(fills[i]) + "%");
+    }
+
+    run_variants(name, test, labels, [&](size_t i) { sparse() = generate_sparse(fills[i], seed); });
+}
+
+namespace {
+
+// Copies the record into the hand-written serializers' SparseRecord, which
+// mirrors SparsePayload.
+template <typename Record>
+void
+assign(Record &record, const SparsePayload &data)
+{
+    record.present = data.present;
+
+    for (size_t slot = 0; slot < kSparseSlots; slot++) {
+        record.integers[slot] = data.integers[slot];
+        record.strings[slot] = data.strings[slot];
+        record.doubles[slot] = data.doubles[slot];
+        record.flags[slot] = data.flags[slot];
+    }
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+void
+thrift_sparse_test(size_t iterations, ThriftSerializationProto proto)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    using namespace thrift_test;
+
+    const SparsePayload &data = sparse();
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    SparseRecord r1, r2;
+
+#define THRIFT_SET(k)                                                       \
+    if (data.has(4 * k))     { r1.__set_i##k(data.integers[k]); }          \
+    if (data.has(4 * k + 1)) { r1.__set_s##k(data.strings[k]); }           \
+    if (data.has(4 * k + 2)) { r1.__set_d##k(data.doubles[k]); }           \
+    if (data.has(4 * k + 3)) { r1.__set_b##k(data.flags[k]); }
+    SPARSE_SLOTS(THRIFT_SET)
+#undef THRIFT_SET
+
+    std::string serialized;
+
+    auto check = [&] {
+        SparsePayload result;
+
+#define THRIFT_GET(k)                                                                                   \
+        if (r2.__isset.i##k) { result.mark(4 * k);     result.integers[k] = r2.i##k; }                \
+        if (r2.__isset.s##k) { result.mark(4 * k + 1); result.strings[k] = r2.s##k; }                 \
+        if (r2.__isset.d##k) { result.mark(4 * k + 2); result.doubles[k] = r2.d##k; }                 \
+        if (r2.__isset.b##k) { result.mark(4 * k + 3); result.flags[k] = r2.b##k; }
+        SPARSE_SLOTS(THRIFT_GET)
+#undef THRIFT_GET
+
+        if (result != data) {
+            throw std::logic_error("thrift's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            buffer1->resetBuffer();
+
+            if (proto == ThriftSerializationProto::Binary) {
+                r1.write(&binary_protocol1);
+            } else {
+                r1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&] {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (proto == ThriftSerializationProto::Binary) {
+                r2.read(&binary_protocol2);
+            } else {
+                r2.read(&compact_protocol2);
+            }
+        },
+        check);
+
+    check();
+
+    std::string tag = proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    print_timings(tag, VERSION, timings, serialized.size());
+}
+
+void
+protobuf_sparse_test(size_t iterations)
+{
+    using namespace protobuf_test;
+
+    const SparsePayload &data = sparse();
+
+    SparseRecord r1, r2;
+
+#define PROTOBUF_SET(k)                                                     \
+    if (data.has(4 * k))     { r1.set_i##k(data.integers[k]); }            \
+    if (data.has(4 * k + 1)) { r1.set_s##k(data.strings[k]); }             \
+    if (data.has(4 * k + 2)) { r1.set_d##k(data.doubles[k]); }             \
+    if (data.has(4 * k + 3)) { r1.set_b##k(data.flags[k]); }
+    SPARSE_SLOTS(PROTOBUF_SET)
+#undef PROTOBUF_SET
+
+    std::string serialized;
+
+    auto check = [&] {
+        SparsePayload result;
+
+#define PROTOBUF_GET(k)                                                                                 \
+        if (r2.has_i##k()) { result.mark(4 * k);     result.integers[k] = r2.i##k(); }                \
+        if (r2.has_s##k()) { result.mark(4 * k + 1); result.strings[k] = r2.s##k(); }                 \
+        if (r2.has_d##k()) { result.mark(4 * k + 2); result.doubles[k] = r2.d##k(); }                 \
+        if (r2.has_b##k()) { result.mark(4 * k + 3); result.flags[k] = r2.b##k(); }
+        SPARSE_SLOTS(PROTOBUF_GET)
+#undef PROTOBUF_GET
+
+        if (result != data) {
+            throw std::logic_error("protobuf's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            r1.SerializeToString(&serialized);
+        },
+        [&] {
+            r2.ParseFromString(serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), timings, serialized.size());
+}
+
+void
+capnproto_sparse_test(size_t iterations)
+{
+    using namespace capnp_test;
+
+    const SparsePayload &data = sparse();
+
+    capnp::MallocMessageBuilder message;
+    SparseRecord::Builder r1 = message.initRoot<SparseRecord>();
+
+#define CAPNP_SET(k)                                                        \
+    if (data.has(4 * k))     { r1.setI##k(data.integers[k]); }             \
+    if (data.has(4 * k + 1)) { r1.setS##k(data.strings[k]); }              \
+    if (data.has(4 * k + 2)) { r1.setD##k(data.doubles[k]); }              \
+    if (data.has(4 * k + 3)) { r1.setB##k(data.flags[k]); }
+    SPARSE_SLOTS(CAPNP_SET)
+#undef CAPNP_SET
+
+    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized =
+        message.getSegmentsForOutput();
+
+    size_t size = 0;
+    for (auto segment: serialized) {
+      size += segment.asBytes().size();
+    }
+
+    // reading every field, as there is no telling which are set
+    size_t decoded = 0;
+
+#define CAPNP_COUNT(k)                                                      \
+    decoded += (r2.getI##k() != 0) + r2.hasS##k() + (r2.getD##k() != 0) + r2.getB##k();
+
+    auto check = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        SparseRecord::Reader r2 = reader.getRoot<SparseRecord>();
+
+        SparsePayload result;
+
+#define CAPNP_GET(k)                                                                                            \
+        if (r2.getI##k() != 0) { result.mark(4 * k);     result.integers[k] = r2.getI##k(); }                 \
+        if (r2.hasS##k())      { result.mark(4 * k + 1); result.strings[k] = r2.getS##k().cStr(); }           \
+        if (r2.getD##k() != 0) { result.mark(4 * k + 2); result.doubles[k] = r2.getD##k(); }                  \
+        if (r2.getB##k())      { result.mark(4 * k + 3); result.flags[k] = true; }
+        SPARSE_SLOTS(CAPNP_GET)
+#undef CAPNP_GET
+
+        if (result != data || decoded != data.count()) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized = message.getSegmentsForOutput();
+        },
+        [&] {
+            capnp::SegmentArrayMessageReader reader(serialized);
+            SparseRecord::Reader r2 = reader.getRoot<SparseRecord>();
+            decoded = 0;
+            SPARSE_SLOTS(CAPNP_COUNT)
+        },
+        check);
+
+#undef CAPNP_COUNT
+
+    check();
+
+    print_timings("capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION), timings, size);
+}
+
+template <typename Record, typename ToString, typename FromString>
+void
+archive_sparse_test(size_t iterations, const std::string &name, const std::string &version,
+                    ToString to_string, FromString from_string)
+{
+    Record r1, r2;
+    assign(r1, sparse());
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (r1 != r2) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            to_string(r1, serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings(name, version, timings, serialized.size());
+}
+
+void
+boost_sparse_test(size_t iterations)
+{
+    archive_sparse_test<boost_test::SparseRecord>(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION),
+        [](const boost_test::SparseRecord &r, std::string &s) { boost_test::to_string(r, s); },
+        [](boost_test::SparseRecord &r, const std::string &s) { boost_test::from_string(r, s); });
+}
+
+void
+cereal_sparse_test(size_t iterations)
+{
+    archive_sparse_test<cereal_test::SparseRecord>(iterations, "cereal", "",
+        [](const cereal_test::SparseRecord &r, std::string &s) { cereal_test::to_string(r, s); },
+        [](cereal_test::SparseRecord &r, const std::string &s) { cereal_test::from_string(r, s); });
+}
+
+void
+hpx_sparse_test(size_t iterations)
+{
+    archive_sparse_test<hpx_test::SparseRecord>(iterations, "hpx", hpx::full_version_as_string(),
+        [](const hpx_test::SparseRecord &r, std::string &s) { hpx_test::to_string(r, s); },
+        [](hpx_test::SparseRecord &r, const std::string &s) { hpx_test::from_string(r, s); });
+}
+
+void
+yas_sparse_test(size_t iterations)
+{
+    archive_sparse_test<yas_test::SparseRecord>(iterations, "yas", "",
+        [](const yas_test::SparseRecord &r, std::string &s) { yas_test::to_string(r, s); },
+        [](yas_test::SparseRecord &r, const std::string &s) { yas_test::from_string(r, s); });
+}
+
+#ifdef WITH_MPI
+void
+mpi_sparse_test(size_t iterations)
+{
+    using namespace mpi_test;
+
+    SparseRecord r1, r2;
+    assign(r1, sparse());
+
+    std::string serialized(determine_pack_size(r1), ' ');
+
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
+
+    auto check = [&] {
+        if (r1 != r2) {
+            throw std::logic_error("mpi's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            to_string(r1, serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("mpi", version, timings, serialized.size());
+}
+#endif
+
+void
+msgpack_sparse_test(size_t iterations)
+{
+    using namespace msgpack_test;
+
+    SparseRecord r1, r2;
+    assign(r1, sparse());
+
+    msgpack::sbuffer sbuf;
+
+    auto check = [&] {
+        if (r1 != r2) {
+            throw std::logic_error("msgpack's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            sbuf.clear();
+            msgpack::pack(sbuf, r1);
+        },
+        [&] {
+            msgpack::unpacked msg;
+            msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+            msgpack::object obj = msg.get();
+            obj.convert(&r2);
+        },
+        check);
+
+    check();
+
+    print_timings("msgpack", msgpack_version(), timings, sbuf.size());
+}
+
+void
+avro_sparse_test(size_t iterations)
+{
+    using namespace avro_test;
+
+    const SparsePayload &data = sparse();
+
+    // every field is a union of null, the default, and its type
+    SparseRecord r1, r2;
+
+#define AVRO_SET(k)                                                         \
+    if (data.has(4 * k))     { r1.i##k.set_long(data.integers[k]); }       \
+    if (data.has(4 * k + 1)) { r1.s##k.set_string(data.strings[k]); }      \
+    if (data.has(4 * k + 2)) { r1.d##k.set_double(data.doubles[k]); }      \
+    if (data.has(4 * k + 3)) { r1.b##k.set_bool(data.flags[k]); }
+    SPARSE_SLOTS(AVRO_SET)
+#undef AVRO_SET
+
+    std::auto_ptr<avro::OutputStream> out;
+
+    auto check = [&] {
+        SparsePayload result;
+
+#define AVRO_GET(k)                                                                                         \
+        if (!r2.i##k.is_null()) { result.mark(4 * k);     result.integers[k] = r2.i##k.get_long(); }      \
+        if (!r2.s##k.is_null()) { result.mark(4 * k + 1); result.strings[k] = r2.s##k.get_string(); }     \
+        if (!r2.d##k.is_null()) { result.mark(4 * k + 2); result.doubles[k] = r2.d##k.get_double(); }     \
+        if (!r2.b##k.is_null()) { result.mark(4 * k + 3); result.flags[k] = r2.b##k.get_bool(); }
+        SPARSE_SLOTS(AVRO_GET)
+#undef AVRO_GET
+
+        if (result != data) {
+            throw std::logic_error("avro's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, r1);
+            encoder->flush();
+        },
+        [&] {
+            auto in = avro::memoryInputStream(*out);
+            auto decoder = avro::binaryDecoder();
+            decoder->init(*in);
+            avro::decode(*decoder, r2);
+        },
+        check);
+
+    check();
+
+    print_timings("avro", "", timings, out->byteCount());
+}
+
+void
+flatbuffers_sparse_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    const SparsePayload &data = sparse();
+
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    auto build = [&] {
+        builder.Clear();
+
+        // strings go before the table that refers to them
+        flatbuffers::Offset<flatbuffers::String> strings[kSparseSlots];
+        for (size_t slot = 0; slot < kSparseSlots; slot++) {
+            if (data.has(4 * slot + 1)) {
+                strings[slot] = builder.CreateString(data.strings[slot]);
+            }
+        }
+
+        SparseRecordBuilder record(builder);
+
+#define FLATBUFFERS_ADD(k)                                                  \
+        if (data.has(4 * k))     { record.add_i##k(data.integers[k]); }    \
+        if (data.has(4 * k + 1)) { record.add_s##k(strings[k]); }      \
+        if (data.has(4 * k + 2)) { record.add_d##k(data.doubles[k]); } \
+        if (data.has(4 * k + 3)) { record.add_b##k(data.flags[k]); }
+        SPARSE_SLOTS(FLATBUFFERS_ADD)
+#undef FLATBUFFERS_ADD
+
+        builder.Finish(record.Finish());
+
+        auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+        auto sz = builder.GetSize();
+        buf.assign(p, p + sz);
+
+        builder.ReleaseBufferPointer();
+    };
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // reading every field, as there is no telling which are set
+    size_t decoded = 0;
+
+#define FLATBUFFERS_COUNT(k)                                                \
+    decoded += (r2->i##k() != 0) + (r2->s##k() != nullptr) + (r2->d##k() != 0) + r2->b##k();
+
+    auto check = [&] {
+        auto r2 = GetSparseRecord(buf.data());
+
+        SparsePayload result;
+
+#define FLATBUFFERS_GET(k)                                                                                  \
+        if (r2->i##k() != 0)       { result.mark(4 * k);     result.integers[k] = r2->i##k(); }           \
+        if (r2->s##k() != nullptr) { result.mark(4 * k + 1); result.strings[k] = r2->s##k()->str(); }     \
+        if (r2->d##k() != 0)       { result.mark(4 * k + 2); result.doubles[k] = r2->d##k(); }            \
+        if (r2->b##k())            { result.mark(4 * k + 3); result.flags[k] = true; }
+        SPARSE_SLOTS(FLATBUFFERS_GET)
+#undef FLATBUFFERS_GET
+
+        if (result != data || decoded != data.count()) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        build,
+        [&] {
+            auto r2 = GetSparseRecord(buf.data());
+            decoded = 0;
+            SPARSE_SLOTS(FLATBUFFERS_COUNT)
+        },
+        check);
+
+#undef FLATBUFFERS_COUNT
+
+    check();
+
+    print_timings("flatbuffers", version, timings, buf.size());
+}
+
+} // namespace
+
+Tests
+sparse_tests()
+{
+    Tests tests = {
+        {"thrift-binary",
+         [](size_t n) { thrift_sparse_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_sparse_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_sparse_test, true},
+        {"capnproto", capnproto_sparse_test, true},
+        {"boost", boost_sparse_test, true},
+        {"msgpack", msgpack_sparse_test, true},
+        {"cereal", cereal_sparse_test, true},
+        {"avro", avro_sparse_test, true},
+        {"hpx", hpx_sparse_test, true},
+#ifdef WITH_MPI
+        {"mpi", mpi_sparse_test, false},
+#endif
+        {"yas", yas_sparse_test, true},
+        {"flatbuffers", flatbuffers_sparse_test, true},
+    };
+
+    return tests;
+}
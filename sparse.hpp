@@ -0,0 +1,71 @@
+#ifndef __SPARSE_HPP_INCLUDED__
+#define __SPARSE_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <stdint.h>
+
+// The sparse schema's tests (--schema=sparse) run on a record of 64
+// optional fields, of which only a share is set. Field n, numbered n + 1 in
+// the IDLs, is an integer (named i<n / 4>) when n % 4 is 0, a string (s)
+// when 1, a double (d) when 2 and a boolean (b) when 3, so that the fields
+// of slot k are ik, sk, dk and bk.
+const size_t kSparseFields = 64;
+const size_t kSparseSlots = kSparseFields / 4;
+
+// Expands X(k) for every slot k, for the code that has to name each field
+// of the generated types.
+#define SPARSE_SLOTS(X) \
+    X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) \
+    X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15)
+
+struct SparsePayload {
+    uint64_t    present; // bit n is set when field n is
+    int64_t     integers[kSparseSlots];
+    std::string strings[kSparseSlots];
+    double      doubles[kSparseSlots];
+    bool        flags[kSparseSlots];
+
+    SparsePayload();
+
+    bool has(size_t field) const {
+        return (present >> field) & 1;
+    }
+
+    void mark(size_t field) {
+        present |= static_cast<uint64_t>(1) << field;
+    }
+
+    // Number of fields set.
+    size_t count() const;
+
+    // Compares the fields that are set.
+    bool operator==(const SparsePayload &other) const;
+
+    bool operator!=(const SparsePayload &other) const {
+        return !(*this == other);
+    }
+
+    // Size of the raw data of the fields that are set: 8 bytes per integer
+    // and double, 1 per boolean plus the characters of the strings.
+    size_t bytes() const;
+};
+
+// Generates a record with `fill` percent of its fields set, at least one
+// unless `fill` is 0, picked at random from `seed`. Set values differ from
+// the fields' defaults, so that the formats which only tell an unset field
+// by its default value (capnproto, flatbuffers) read them back: integers
+// and doubles are not 0 and booleans are true.
+SparsePayload generate_sparse(size_t fill, uint64_t seed);
+
+// The record shared by the sparse schema's tests.
+SparsePayload &sparse();
+
+// Runs `test` once per fill ratio in `fills` and reports the size and the
+// time per message of each as "name/fill%".
+void run_sparse(const std::string &name, const std::function<void()> &test,
+                const std::vector<size_t> &fills, uint64_t seed);
+
+#endif
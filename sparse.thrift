@@ -0,0 +1,71 @@
+namespace cpp thrift_test
+
+// 64 optional fields, cycling through integers, strings, doubles and
+// booleans. Only the fields that are set are written.
+
+struct SparseRecord {
+    1: optional i64    i0,
+    2: optional string s0,
+    3: optional double d0,
+    4: optional bool   b0,
+    5: optional i64    i1,
+    6: optional string s1,
+    7: optional double d1,
+    8: optional bool   b1,
+    9: optional i64    i2,
+    10: optional string s2,
+    11: optional double d2,
+    12: optional bool   b2,
+    13: optional i64    i3,
+    14: optional string s3,
+    15: optional double d3,
+    16: optional bool   b3,
+    17: optional i64    i4,
+    18: optional string s4,
+    19: optional double d4,
+    20: optional bool   b4,
+    21: optional i64    i5,
+    22: optional string s5,
+    23: optional double d5,
+    24: optional bool   b5,
+    25: optional i64    i6,
+    26: optional string s6,
+    27: optional double d6,
+    28: optional bool   b6,
+    29: optional i64    i7,
+    30: optional string s7,
+    31: optional double d7,
+    32: optional bool   b7,
+    33: optional i64    i8,
+    34: optional string s8,
+    35: optional double d8,
+    36: optional bool   b8,
+    37: optional i64    i9,
+    38: optional string s9,
+    39: optional double d9,
+    40: optional bool   b9,
+    41: optional i64    i10,
+    42: optional string s10,
+    43: optional double d10,
+    44: optional bool   b10,
+    45: optional i64    i11,
+    46: optional string s11,
+    47: optional double d11,
+    48: optional bool   b11,
+    49: optional i64    i12,
+    50: optional string s12,
+    51: optional double d12,
+    52: optional bool   b12,
+    53: optional i64    i13,
+    54: optional string s13,
+    55: optional double d13,
+    56: optional bool   b13,
+    57: optional i64    i14,
+    58: optional string s14,
+    59: optional double d14,
+    60: optional bool   b14,
+    61: optional i64    i15,
+    62: optional string s15,
+    63: optional double d15,
+    64: optional bool   b15
+}
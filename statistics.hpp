@@ -0,0 +1,127 @@
+#ifndef __STATISTICS_HPP_INCLUDED__
+#define __STATISTICS_HPP_INCLUDED__
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <stdint.h>
+
+// Summary of a series of repeated measurements after outliers have been
+// dropped.
+struct Summary {
+    double mean;
+    double median;
+    double stddev;
+    double ci_low;   // bounds of the 95% confidence interval of the mean
+    double ci_high;
+    size_t samples;  // measurements the summary is computed from
+    size_t outliers; // measurements dropped as outliers
+
+    Summary() : mean(0), median(0), stddev(0), ci_low(0), ci_high(0), samples(0), outliers(0) {}
+
+    // Standard deviation relative to the mean, in percent.
+    double relative_stddev() const {
+        return mean == 0 ? 0 : 100.0 * stddev / mean;
+    }
+};
+
+// Two-sided 97.5% quantile of Student's t distribution with `df` degrees of
+// freedom.
+inline double
+student_t_975(size_t df)
+{
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    if (df == 0) {
+        return 0;
+    }
+    if (df <= sizeof(table) / sizeof(table[0])) {
+        return table[df - 1];
+    }
+    if (df <= 60) {
+        return 2.000;
+    }
+    if (df <= 120) {
+        return 1.980;
+    }
+    return 1.960;
+}
+
+// Value at `fraction` of the way through a sorted series, interpolating
+// linearly between neighbours.
+inline double
+quantile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    double position = fraction * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(position);
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+
+    return sorted[lower] + (position - lower) * (sorted[upper] - sorted[lower]);
+}
+
+// Drops the values outside Tukey's fences (1.5 interquartile ranges beyond
+// the quartiles) and summarizes the rest.
+inline Summary
+summarize(std::vector<double> values)
+{
+    Summary summary;
+
+    if (values.empty()) {
+        return summary;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    if (values.size() >= 4) {
+        double q1 = quantile(values, 0.25);
+        double q3 = quantile(values, 0.75);
+        double fence = 1.5 * (q3 - q1);
+
+        std::vector<double> kept;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i] >= q1 - fence && values[i] <= q3 + fence) {
+                kept.push_back(values[i]);
+            }
+        }
+
+        summary.outliers = values.size() - kept.size();
+        values.swap(kept);
+    }
+
+    size_t n = values.size();
+
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += values[i];
+    }
+
+    summary.samples = n;
+    summary.mean = sum / n;
+    summary.median = quantile(values, 0.5);
+
+    if (n > 1) {
+        double squares = 0;
+        for (size_t i = 0; i < n; i++) {
+            squares += (values[i] - summary.mean) * (values[i] - summary.mean);
+        }
+        summary.stddev = std::sqrt(squares / (n - 1));
+    }
+
+    double half_width = student_t_975(n - 1) * summary.stddev / std::sqrt(static_cast<double>(n));
+
+    summary.ci_low = summary.mean - half_width;
+    summary.ci_high = summary.mean + half_width;
+
+    return summary;
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __STRING_BUFFER_HPP_INCLUDED__
+#define __STRING_BUFFER_HPP_INCLUDED__
+
+#include <string>
+#include <streambuf>
+
+// A stream buffer appending what is written to a string it doesn't own, for
+// the stream-based archives to write into a buffer kept from one message to
+// the next instead of an std::ostringstream's.
+class StringOutputBuffer : public std::streambuf {
+public:
+
+    explicit StringOutputBuffer(std::string &data) : data_(data) {}
+
+protected:
+
+    std::streamsize xsputn(const char *data, std::streamsize size) {
+        data_.append(data, size);
+        return size;
+    }
+
+    int_type overflow(int_type c) {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            data_.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+private:
+
+    std::string &data_;
+};
+
+// A stream buffer reading a string in place, without the copy an
+// std::stringstream makes.
+class StringInputBuffer : public std::streambuf {
+public:
+
+    explicit StringInputBuffer(const std::string &data) {
+        char *begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+};
+
+#endif
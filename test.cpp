@@ -3,8 +3,8 @@
 #include <iostream>
 #include <stdexcept>
 #include <memory>
-#include <chrono>
 #include <sstream>
+#include <functional>
 #ifdef WITH_MPI
 #include <mpi.h>
 #endif
@@ -35,9 +35,79 @@
 #include "hpx/version.hpp"
 #include "mpi/record.hpp"
 #include "yas/record.hpp"
+#include "raw/record.hpp"
+#include "reflect/record.hpp"
 #include "flatbuffers/test_generated.h"
 
-#include "data.hpp"
+#include "workload.hpp"
+#include "checksum.hpp"
+#include "benchmark.hpp"
+#include "scaling.hpp"
+#include "placement.hpp"
+#include "tiny.hpp"
+#include "tests.hpp"
+#include "nested.hpp"
+#include "sparse.hpp"
+#include "dispatch.hpp"
+#include "tracking.hpp"
+#include "hpc.hpp"
+#include "versioning.hpp"
+#include "projection.hpp"
+#include "working_set.hpp"
+
+// The reference: the ids copied with a single memcpy after their count and
+// every string after its length, into a buffer kept from one message to the
+// next (see raw/record.hpp). Decoding copies the message out into a Record,
+// or with `view` only points a RecordView at the ids and strings in place.
+void
+raw_serialization_test(size_t iterations, bool view)
+{
+    using namespace raw_test;
+
+    Records<Record> records([](Record &record, const Payload &data) {
+        record.ids = data.ids;
+        record.strings = data.strings;
+    });
+
+    Record r2;
+    RecordView v2;
+    std::string serialized;
+
+    auto encode = [&] {
+        to_string(records.next(), serialized);
+    };
+
+    auto decode = [&] {
+        if (view) {
+            from_string(v2, serialized);
+        } else {
+            from_string(r2, serialized);
+        }
+    };
+
+    auto check = [&] {
+        if (view ? v2 != records.last() : r2 != records.last()) {
+            throw std::logic_error("raw's case: deserialization failed");
+        }
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
+        check();
+
+        sizes.push_back(serialized.size());
+    }
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings(view ? "raw-view" : "raw", "", timings, sizes);
+}
 
 enum class ThriftSerializationProto {
     Binary,
@@ -62,75 +132,74 @@ thrift_serialization_test(size_t iterations, ThriftSerializationProto proto = Th
     TCompactProtocol compact_protocol1(buffer1);
     TCompactProtocol compact_protocol2(buffer2);
 
-    Record r1;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    if (proto == ThriftSerializationProto::Binary) {
-        r1.write(&binary_protocol1);
-    } else if (proto == ThriftSerializationProto::Compact) {
-        r1.write(&compact_protocol1);
-    }
+    auto encode = [&] {
+        buffer1->resetBuffer();
 
-    serialized = buffer1->getBufferAsString();
+        if (proto == ThriftSerializationProto::Binary) {
+            records.next().write(&binary_protocol1);
+        } else if (proto == ThriftSerializationProto::Compact) {
+            records.next().write(&compact_protocol1);
+        }
 
-    // check if we can deserialize back
-    Record r2;
+        serialized = buffer1->getBufferAsString();
+    };
 
-    buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+    auto decode = [&] {
+        buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
 
-    if (proto == ThriftSerializationProto::Binary) {
-        r2.read(&binary_protocol2);
-    } else if (proto == ThriftSerializationProto::Compact) {
-        r2.read(&compact_protocol2);
-    }
+        if (proto == ThriftSerializationProto::Binary) {
+            r2.read(&binary_protocol2);
+        } else if (proto == ThriftSerializationProto::Compact) {
+            r2.read(&compact_protocol2);
+        }
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
 
-    if (r1 != r2) {
-        throw std::logic_error("thrift's case: deserialization failed");
+        if (records.last() != r2) {
+            throw std::logic_error("thrift's case: deserialization failed");
+        }
+
+        sizes.push_back(serialized.size());
     }
 
     std::string tag;
 
     if (proto == ThriftSerializationProto::Binary) {
-        tag = "thrift-binary:";
+        tag = "thrift-binary";
     } else if (proto == ThriftSerializationProto::Compact) {
-        tag = "thrift-compact:";
+        tag = "thrift-compact";
     }
 
-    std::cout << tag << " version = " << VERSION << std::endl;
-    std::cout << tag << " size = " << serialized.size() << " bytes" << std::endl;
-
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        buffer1->resetBuffer();
-
-        if (proto == ThriftSerializationProto::Binary) {
-            r1.write(&binary_protocol1);
-        } else if (proto == ThriftSerializationProto::Compact) {
-            r1.write(&compact_protocol1);
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("thrift's case: deserialization failed");
         }
+    };
 
-        serialized = buffer1->getBufferAsString();
-        buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+    auto timings = measure(iterations, encode, decode, check);
 
-        if (proto == ThriftSerializationProto::Binary) {
-            r2.read(&binary_protocol2);
-        } else if (proto == ThriftSerializationProto::Compact) {
-            r2.read(&compact_protocol2);
-        }
-    }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    check();
 
-    std::cout << tag << " time = " << duration << " milliseconds" << std::endl << std::endl;
+    print_timings(tag, VERSION, timings, sizes);
 }
 
 void
@@ -138,40 +207,53 @@ protobuf_serialization_test(size_t iterations)
 {
     using namespace protobuf_test;
 
-    Record r1;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.add_ids(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.add_ids(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.add_strings(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.add_strings(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    r1.SerializeToString(&serialized);
+    auto encode = [&] {
+        serialized.clear();
+        records.next().SerializeToString(&serialized);
+    };
 
-    // check if we can deserialize back
-    Record r2;
-    bool ok = r2.ParseFromString(serialized);
-    if (!ok /*|| r2 != r1*/) {
-        throw std::logic_error("protobuf's case: deserialization failed");
-    }
+    auto decode = [&] {
+        r2.ParseFromString(serialized);
+    };
 
-    std::cout << "protobuf: version = " << GOOGLE_PROTOBUF_VERSION << std::endl;
-    std::cout << "protobuf: size = " << serialized.size() << " bytes" << std::endl;
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        serialized.clear();
-        r1.SerializeToString(&serialized);
-        r2.ParseFromString(serialized);
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+
+        bool ok = r2.ParseFromString(serialized);
+        if (!ok || r2.SerializeAsString() != serialized) {
+            throw std::logic_error("protobuf's case: deserialization failed");
+        }
+
+        sizes.push_back(serialized.size());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "protobuf: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (r2.SerializeAsString() != serialized) {
+            throw std::logic_error("protobuf's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), timings, sizes);
 }
 
 void
@@ -179,47 +261,81 @@ capnproto_serialization_test(size_t iterations)
 {
     using namespace capnp_test;
 
-    capnp::MallocMessageBuilder message;
-    Record::Builder r1 = message.getRoot<Record>();
+    Records<capnp::MallocMessageBuilder> messages([](capnp::MallocMessageBuilder &message, const Payload &data) {
+        Record::Builder r1 = message.getRoot<Record>();
 
-    auto ids = r1.initIds(kIntegers.size());
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        ids.set(i, kIntegers[i]);
-    }
+        auto ids = r1.initIds(data.ids.size());
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            ids.set(i, data.ids[i]);
+        }
 
-    auto strings = r1.initStrings(kStringsCount);
-    for (size_t i = 0; i < kStringsCount; i++) {
-        strings.set(i, kStringValue);
-    }
+        auto strings = r1.initStrings(data.strings.size());
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            strings.set(i, data.strings[i]);
+        }
+    });
 
-    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized =
-        message.getSegmentsForOutput();
+    // Cap'n Proto builds the message in its wire format, so encoding is
+    // collecting the segments for output and decoding is opening a reader
+    // over them and reaching the root's lists, as far as a zero-copy format
+    // goes before the data is actually used.
+    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized;
+    size_t decoded = 0;
 
-    // check if we can deserialize back
-    capnp::SegmentArrayMessageReader reader(serialized);
-    Record::Reader r2 = reader.getRoot<Record>();
-    if (r2.getIds().size() != kIntegers.size()) {
-        throw std::logic_error("capnproto's case: deserialization failed");
-    }
+    auto encode = [&] {
+        serialized = messages.next().getSegmentsForOutput();
+    };
 
-    size_t size = 0;
-    for (auto segment: serialized) {
-      size += segment.asBytes().size();
-    }
+    auto decode = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        Record::Reader r2 = reader.getRoot<Record>();
+        decoded = r2.getIds().size() + r2.getStrings().size();
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    std::cout << "capnproto: version = " << CAPNP_VERSION << std::endl;
-    std::cout << "capnproto: size = " << size << " bytes" << std::endl;
+    for (size_t i = 0; i < messages.size(); i++) {
+        encode();
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        serialized = message.getSegmentsForOutput();
         capnp::SegmentArrayMessageReader reader(serialized);
-        reader.getRoot<Record>();
+        Record::Reader r2 = reader.getRoot<Record>();
+        if (r2.getIds().size() != messages.last_payload().ids.size() ||
+            r2.getStrings().size() != messages.last_payload().strings.size()) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+
+        size_t size = 0;
+        for (auto segment: serialized) {
+          size += segment.asBytes().size();
+        }
+        sizes.push_back(size);
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "capnproto: time = " << duration << " milliseconds" << std::endl << std::endl;
+    // the timed decode stops at the lists, the check reads every value
+    auto check = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        Record::Reader r2 = reader.getRoot<Record>();
+
+        Checksum values;
+        for (auto id: r2.getIds()) {
+            values.add(id);
+        }
+        for (auto string: r2.getStrings()) {
+            values.add(string.begin(), string.size());
+        }
+
+        if (decoded != messages.last_payload().ids.size() + messages.last_payload().strings.size() ||
+            values.value() != checksum(messages.last_payload())) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION), timings, sizes);
 }
 
 void
@@ -227,38 +343,53 @@ boost_serialization_test(size_t iterations)
 {
     using namespace boost_test;
 
-    Record r1, r2;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    to_string(r1, serialized);
-    from_string(r2, serialized);
+    auto encode = [&] {
+        serialized.clear();
+        to_string(records.next(), serialized);
+    };
 
-    if (r1 != r2) {
-        throw std::logic_error("boost's case: deserialization failed");
-    }
+    auto decode = [&] {
+        from_string(r2, serialized);
+    };
 
-    std::cout << "boost: version = " << BOOST_VERSION << std::endl;
-    std::cout << "boost: size = " << serialized.size() << " bytes" << std::endl;
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        serialized.clear();
-        to_string(r1, serialized);
-        from_string(r2, serialized);
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
+
+        if (records.last() != r2) {
+            throw std::logic_error("boost's case: deserialization failed");
+        }
+
+        sizes.push_back(serialized.size());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "boost: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("boost's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("boost", boost::lexical_cast<std::string>(BOOST_VERSION), timings, sizes);
 }
 
 void
@@ -266,49 +397,56 @@ msgpack_serialization_test(size_t iterations)
 {
     using namespace msgpack_test;
 
-    Record r1, r2;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     msgpack::sbuffer sbuf;
 
-    msgpack::pack(sbuf, r1);
+    auto encode = [&] {
+        sbuf.clear();
+        msgpack::pack(sbuf, records.next());
+    };
 
-    std::string serialized(sbuf.data(), sbuf.size());
+    auto decode = [&] {
+        msgpack::unpacked msg;
+        msgpack::unpack(&msg, sbuf.data(), sbuf.size());
+        msgpack::object obj = msg.get();
+        obj.convert(&r2);
+    };
 
-    msgpack::unpacked msg;
-    msgpack::unpack(&msg, serialized.data(), serialized.size());
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    msgpack::object obj = msg.get();
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
 
-    obj.convert(&r2);
+        if (records.last() != r2) {
+            throw std::logic_error("msgpack's case: deserialization failed");
+        }
 
-    if (r1 != r2) {
-        throw std::logic_error("msgpack's case: deserialization failed");
+        sizes.push_back(sbuf.size());
     }
 
-    std::cout << "msgpack: version = " << msgpack_version() << std::endl;
-    std::cout << "msgpack: size = " << serialized.size() << " bytes" << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("msgpack's case: deserialization failed");
+        }
+    };
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        sbuf.clear();
-        msgpack::pack(sbuf, r1);
-        msgpack::unpacked msg;
-        msgpack::unpack(&msg, sbuf.data(), sbuf.size());
-        msgpack::object obj = msg.get();
-        obj.convert(&r2);
-    }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
 
-    std::cout << "msgpack: time = " << duration << " milliseconds" << std::endl << std::endl;
+    print_timings("msgpack", msgpack_version(), timings, sizes);
 }
 
 void
@@ -316,199 +454,270 @@ cereal_serialization_test(size_t iterations)
 {
     using namespace cereal_test;
 
-    Record r1, r2;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    to_string(r1, serialized);
-    from_string(r2, serialized);
-
-    if (r1 != r2) {
-        throw std::logic_error("cereal's case: deserialization failed");
-    }
-
-    std::cout << "cereal: size = " << serialized.size() << " bytes" << std::endl;
-
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
+    auto encode = [&] {
         serialized.clear();
-        to_string(r1, serialized);
+        to_string(records.next(), serialized);
+    };
+
+    auto decode = [&] {
         from_string(r2, serialized);
-    }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    };
 
-    std::cout << "cereal: time = " << duration << " milliseconds" << std::endl << std::endl;
-}
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-void
-avro_serialization_test(size_t iterations)
-{
-    using namespace avro_test;
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
 
-    Record r1, r2;
+        if (records.last() != r2) {
+            throw std::logic_error("cereal's case: deserialization failed");
+        }
 
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
+        sizes.push_back(serialized.size());
     }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("cereal's case: deserialization failed");
+        }
+    };
 
-    std::auto_ptr<avro::OutputStream> out = avro::memoryOutputStream();
-    avro::EncoderPtr encoder = avro::binaryEncoder();
+    auto timings = measure(iterations, encode, decode, check);
 
-    encoder->init(*out);
-    avro::encode(*encoder, r1);
+    check();
 
-    auto serialized_size = out->byteCount();
+    print_timings("cereal", "", timings, sizes);
+}
 
-    std::auto_ptr<avro::InputStream> in = avro::memoryInputStream(*out);
-    avro::DecoderPtr decoder = avro::binaryDecoder();
+void
+avro_serialization_test(size_t iterations)
+{
+    using namespace avro_test;
 
-    decoder->init(*in);
-    avro::decode(*decoder, r2);
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    if (r1.ids != r2.ids || r1.strings != r2.strings ||
-        r2.ids.size() != kIntegers.size() || r2.strings.size() != kStringsCount) {
-        throw std::logic_error("avro's case: deserialization failed");
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
-    std::cout << "avro: size = " << serialized_size << " bytes" << std::endl;
+    Record r2;
+    std::auto_ptr<avro::OutputStream> out;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        auto out = avro::memoryOutputStream();
+    auto encode = [&] {
+        out = avro::memoryOutputStream();
         auto encoder = avro::binaryEncoder();
         encoder->init(*out);
-        avro::encode(*encoder, r1);
+        avro::encode(*encoder, records.next());
+        encoder->flush();
+    };
 
+    auto decode = [&] {
         auto in = avro::memoryInputStream(*out);
         auto decoder = avro::binaryDecoder();
         decoder->init(*in);
         avro::decode(*decoder, r2);
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
+
+        if (records.last().ids != r2.ids || records.last().strings != r2.strings) {
+            throw std::logic_error("avro's case: deserialization failed");
+        }
+
+        sizes.push_back(out->byteCount());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "avro: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (records.last().ids != r2.ids || records.last().strings != r2.strings) {
+            throw std::logic_error("avro's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("avro", "", timings, sizes);
 }
 
 void hpx_serialization_test(size_t iterations)
 {
     using namespace hpx_test;
 
-    Record r1, r2;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    to_string(r1, serialized);
-    from_string(r2, serialized);
+    auto encode = [&] {
+        serialized.clear();
+        to_string(records.next(), serialized);
+    };
 
-    if (r1 != r2) {
-        throw std::logic_error("hpx's case: deserialization failed");
-    }
+    auto decode = [&] {
+        from_string(r2, serialized);
+    };
 
-    std::cout << "hpx: version = " << hpx::full_version_as_string() << std::endl;
-    std::cout << "hpx: size    = " << serialized.size() << " bytes" << std::endl;
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        serialized.clear();
-        to_string(r1, serialized);
-        from_string(r2, serialized);
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
+
+        if (records.last() != r2) {
+            throw std::logic_error("hpx's case: deserialization failed");
+        }
+
+        sizes.push_back(serialized.size());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "hpx: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("hpx's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("hpx", hpx::full_version_as_string(), timings, sizes);
 }
 
 void hpx_zero_copy_serialization_test(size_t iterations)
 {
     using namespace hpx_zero_copy_test;
 
-    Record r1, r2;
-
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
+    Record r2;
     std::string serialized;
 
-    to_string(r1, serialized);
-    from_string(r2, serialized);
+    auto encode = [&] {
+        serialized.clear();
+        to_string(records.next(), serialized);
+    };
 
-    if (r1 != r2) {
-        throw std::logic_error("hpx_zero_copy's case: deserialization failed");
-    }
+    auto decode = [&] {
+        from_string(r2, serialized);
+    };
 
-    std::cout << "hpx_zero_copy: version = " << hpx::full_version_as_string() << std::endl;
-    std::cout << "hpx_zero_copy: size    = " << serialized.size() << " bytes" << std::endl;
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        serialized.clear();
-        to_string(r1, serialized);
-        from_string(r2, serialized);
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
+
+        if (records.last() != r2) {
+            throw std::logic_error("hpx_zero_copy's case: deserialization failed");
+        }
+
+        sizes.push_back(serialized.size());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "hpx_zero_copy: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("hpx_zero_copy's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("hpx_zero_copy", hpx::full_version_as_string(), timings, sizes);
 }
 
 void mpi_serialization_test(size_t iterations)
 {
     using namespace mpi_test;
 
-    Record r1, r2;
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
+
+    // one buffer large enough for the largest record
+    std::vector<size_t> sizes;
+    int total_size = 0;
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
+    for (size_t i = 0; i < records.size(); i++) {
+        int size = determine_pack_size(records.next());
+        sizes.push_back(size);
+        total_size = std::max(total_size, size);
     }
 
-    int total_size = determine_pack_size(r1);
+    Record r2;
     std::string serialized(total_size, ' ');
 
-    std::cout << "mpi: version = " << OMPI_MAJOR_VERSION << "."
-              << OMPI_MINOR_VERSION << "." << OMPI_RELEASE_VERSION << std::endl;
-    std::cout << "mpi: size    = " << serialized.size() << " bytes" << std::endl;
+    std::string version = boost::lexical_cast<std::string>(OMPI_MAJOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_MINOR_VERSION) + "." +
+                          boost::lexical_cast<std::string>(OMPI_RELEASE_VERSION);
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        to_string(r1, serialized);
-        from_string(r2, serialized);
-    }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("mpi's case: deserialization failed");
+        }
+    };
 
-    std::cout << "mpi: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto timings = measure(iterations,
+        [&] {
+            to_string(records.next(), serialized);
+        },
+        [&] {
+            from_string(r2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings("mpi", version, timings, sizes);
 }
 
 void
@@ -516,104 +725,199 @@ yas_serialization_test(size_t iterations)
 {
     using namespace yas_test;
 
-    Record r1, r2;
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    for (size_t i = 0; i < kIntegers.size(); i++) {
-        r1.ids.push_back(kIntegers[i]);
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
 
-    for (size_t i = 0; i < kStringsCount; i++) {
-        r1.strings.push_back(kStringValue);
-    }
+    Record r2;
+    std::unique_ptr<yas::mem_ostream> os;
 
-    std::string serialized;
+    auto encode = [&] {
+        os.reset(new yas::mem_ostream());
+        yas::binary_oarchive<yas::mem_ostream> oa(*os);
+        oa & records.next();
+    };
 
-    to_string(r1, serialized);
-    from_string(r2, serialized);
+    auto decode = [&] {
+        yas::mem_istream is(os->get_intrusive_buffer());
+        yas::binary_iarchive<yas::mem_istream> ia(is);
+        ia & r2;
+    };
 
-    if (r1 != r2) {
-        throw std::logic_error("yas' case: deserialization failed");
-    }
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    std::cout << "yas: size = " << serialized.size() << " bytes" << std::endl;
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
-        yas::mem_ostream os;
-        yas::binary_oarchive<yas::mem_ostream> oa(os);
-        oa & r1;
+        if (records.last() != r2) {
+            throw std::logic_error("yas' case: deserialization failed");
+        }
 
-        yas::mem_istream is(os.get_intrusive_buffer());
-        yas::binary_iarchive<yas::mem_istream> ia(is);
-        ia & r2;
+        sizes.push_back(os->get_intrusive_buffer().size);
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "yas: time = " << duration << " milliseconds" << std::endl << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("yas' case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("yas", "", timings, sizes);
 }
 
 void
-flatbuffers_serialization_test(size_t iterations)
+reflect_serialization_test(size_t iterations)
 {
-    using namespace flatbuffers_test;
+    using namespace reflect_test;
 
-    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
-    strings.reserve(kStringsCount);
+    Records<Record> records([](Record &record, const Payload &data) {
+        for (size_t i = 0; i < data.ids.size(); i++) {
+            record.ids.push_back(data.ids[i]);
+        }
 
-    flatbuffers::FlatBufferBuilder builder;
-    for (size_t i = 0; i < kStringsCount; i++) {
-        strings.push_back(builder.CreateString(kStringValue));
-    }
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            record.strings.push_back(data.strings[i]);
+        }
+    });
+
+    Record r2;
+    std::string serialized;
+
+    auto encode = [&] {
+        reflect::to_string(records.next(), serialized);
+    };
+
+    auto decode = [&] {
+        reflect::from_string(r2, serialized);
+    };
 
-    auto ids_vec = builder.CreateVector(kIntegers);
-    auto strings_vec = builder.CreateVector(strings);
-    auto r1 = CreateRecord(builder, ids_vec, strings_vec);
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
 
-    builder.Finish(r1);
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+        decode();
 
-    auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
-    auto sz = builder.GetSize();
-    std::vector<char> buf(p, p + sz);
+        if (records.last() != r2) {
+            throw std::logic_error("reflect's case: deserialization failed");
+        }
 
-    auto r2 = GetRecord(buf.data());
-    if (r2->strings()->size() != kStringsCount || r2->ids()->size() != kIntegers.size()) {
-        throw std::logic_error("flatbuffer's case: deserialization failed");
+        sizes.push_back(serialized.size());
     }
 
-    std::cout << "flatbuffers: version = " << FLATBUFFERS_VERSION_MAJOR << "."
-              << FLATBUFFERS_VERSION_MINOR << "." << FLATBUFFERS_VERSION_REVISION << std::endl;
-    std::cout << "flatbuffers: size    = " << builder.GetSize() << " bytes" << std::endl;
+    auto check = [&] {
+        if (records.last() != r2) {
+            throw std::logic_error("reflect's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("reflect", "", timings, sizes);
+}
+
+void
+flatbuffers_serialization_test(size_t iterations)
+{
+    using namespace flatbuffers_test;
+
+    // FlatBuffers is read in place, so encoding is building the message
+    // from the payload and copying it out of the builder, and decoding is
+    // getting the root table and reaching its lists, mirroring what the
+    // capnproto test does.
+    Records<Payload> records([](Payload &record, const Payload &data) {
+        record = data;
+    });
 
-    builder.ReleaseBufferPointer();
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+    size_t decoded = 0;
+
+    auto encode = [&] {
+        const Payload &data = records.next();
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < iterations; i++) {
         builder.Clear();
         strings.clear();
-        // buf.clear();
 
-        for (size_t i = 0; i < kStringsCount; i++) {
-            strings.push_back(builder.CreateString(kStringValue));
+        for (size_t i = 0; i < data.strings.size(); i++) {
+            strings.push_back(builder.CreateString(data.strings[i]));
         }
 
-        auto ids_vec = builder.CreateVector(kIntegers);
+        auto ids_vec = builder.CreateVector(data.ids);
         auto strings_vec = builder.CreateVector(strings);
         auto r1 = CreateRecord(builder, ids_vec, strings_vec);
         builder.Finish(r1);
 
         auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
         auto sz = builder.GetSize();
-        std::vector<char> buf(p, p + sz);
-        auto r2 = GetRecord(buf.data());
-        (void)r2->ids()[0];
+        buf.assign(p, p + sz);
 
         builder.ReleaseBufferPointer();
+    };
+
+    auto decode = [&] {
+        auto r2 = GetRecord(buf.data());
+        decoded = r2->ids()->size() + r2->strings()->size();
+    };
+
+    // check if we can deserialize back every record
+    std::vector<size_t> sizes;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        encode();
+
+        auto r2 = GetRecord(buf.data());
+        if (r2->strings()->size() != records.last().strings.size() ||
+            r2->ids()->size() != records.last().ids.size()) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+
+        sizes.push_back(buf.size());
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
 
-    std::cout << "flatbuffers: time = " << duration << " milliseconds" << std::endl << std::endl;
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // the timed decode stops at the vectors, the check reads every value
+    auto check = [&] {
+        auto r2 = GetRecord(buf.data());
+
+        Checksum values;
+        for (size_t i = 0; i < r2->ids()->size(); i++) {
+            values.add(r2->ids()->Get(i));
+        }
+        for (size_t i = 0; i < r2->strings()->size(); i++) {
+            const flatbuffers::String *string = r2->strings()->Get(i);
+            values.add(string->c_str(), string->size());
+        }
+
+        if (decoded != records.last().ids.size() + records.last().strings.size() ||
+            values.value() != checksum(records.last())) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations, encode, decode, check);
+
+    check();
+
+    print_timings("flatbuffers", version, timings, sizes);
 }
 
 int
@@ -626,10 +930,13 @@ main(int argc, char **argv)
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 
     if (argc < 2) {
-        std::cout << "usage: " << argv[0] << " N [thrift-binary thrift-compact protobuf boost msgpack cereal avro hpx capnproto flatbuffers yas]";
+        std::cout << "usage: " << argv[0] << " N [raw raw-view thrift-binary thrift-compact protobuf boost msgpack cereal avro hpx capnproto flatbuffers yas reflect] [options]";
         std::cout << std::endl << std::endl;
         std::cout << "arguments: " << std::endl;
         std::cout << " N  -- number of iterations" << std::endl << std::endl;
+        std::cout << "options: " << std::endl;
+        print_options_usage();
+        std::cout << std::endl;
         return EXIT_SUCCESS;
     }
 
@@ -645,68 +952,327 @@ main(int argc, char **argv)
 
     std::set<std::string> names;
 
-    if (argc > 2) {
+    try {
         for (int i = 2; i < argc; i++) {
-            names.insert(argv[i]);
+            std::string arg = argv[i];
+            if (arg.compare(0, 2, "--") == 0) {
+                parse_option(arg);
+            } else {
+                names.insert(arg);
+            }
         }
+    } catch (std::exception &exc) {
+        std::cerr << "Error: " << exc.what() << std::endl;
+        return EXIT_FAILURE;
     }
 
-    std::cout << "performing " << iterations << " iterations" << std::endl << std::endl;
+    set_allocation_tracking(options().allocations);
 
-    /*std::cout << "total size: " << sizeof(kIntegerValue) * kIntegersCount + kStringValue.size() * kStringsCount << std::endl;*/
+    Placements placements;
 
     try {
-        if (names.empty() || names.find("thrift-binary") != names.end()) {
-            thrift_serialization_test(iterations, ThriftSerializationProto::Binary);
-        }
+        placements = resolve_placements(options().placements);
+    } catch (std::exception &exc) {
+        std::cerr << "Error: " << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
-        if (names.empty() || names.find("thrift-compact") != names.end()) {
-            thrift_serialization_test(iterations, ThriftSerializationProto::Compact);
-        }
+    const std::string &schema = options().workload.schema;
 
-        if (names.empty() || names.find("protobuf") != names.end()) {
-            protobuf_serialization_test(iterations);
-        }
+    if (options().materialize && (schema != "record" || options().tiny)) {
+        std::cerr << "Error: --materialize only applies to the record schema and can't be combined with --tiny"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
 
-        if (names.empty() || names.find("capnproto") != names.end()) {
-            capnproto_serialization_test(iterations);
-        }
+    if (options().projection && (schema != "record" || options().tiny || options().materialize)) {
+        std::cerr << "Error: --projection only applies to the record schema and can't be combined with --tiny "
+                  << "or --materialize" << std::endl;
+        return EXIT_FAILURE;
+    }
 
-        if (names.empty() || names.find("boost") != names.end()) {
-            boost_serialization_test(iterations);
-        }
+    if (options().reuse && (schema != "record" || options().tiny || options().materialize || options().projection)) {
+        std::cerr << "Error: --reuse only applies to the record schema and can't be combined with --tiny, "
+                  << "--materialize or --projection" << std::endl;
+        return EXIT_FAILURE;
+    }
 
-        if (names.empty() || names.find("msgpack") != names.end()) {
-            msgpack_serialization_test(iterations);
+    const bool working_sets = !options().working_sets.empty();
+
+    if (working_sets && (schema != "record" || options().tiny || options().projection)) {
+        std::cerr << "Error: --working-set only applies to the record schema and can't be combined with --tiny "
+                  << "or --projection" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (options().timer == "tsc" && tsc_ticks_per_nanosecond() <= 0) {
+        std::cerr << "Error: --timer=tsc needs an x86 CPU's time stamp counter" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((options().flush || options().counters || options().batch > 1) && !placements.empty()) {
+        std::cerr << "Error: --flush, --counters and --batch can't be combined with --placement" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // one thread's sweep would evict the caches of the others being timed
+    if (options().flush && options().threads > 0) {
+        std::cerr << "Error: --flush can't be combined with --threads" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (schema != "record" && (options().tiny || !options().workload.corpus.empty())) {
+        std::cerr << "Error: --schema=" << schema << " can't be combined with --tiny or --corpus" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // a batch runs all its encodes before its decodes into the same message
+    // buffer, so with records cycled every decode would read the message
+    // of the batch's last record
+    const bool cycled = working_sets || (!options().workload.corpus.empty() && !options().tiny);
+
+    if (cycled && options().batch > 1) {
+        std::cerr << "Error: --batch can't be combined with --corpus or --working-set" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the tiny records, the sparse schema's fill ratios, the graph schema's
+    // tracking modes, the evolution schema's versions, the projections and
+    // the working sets are run one after the other
+    bool variants = options().tiny || options().projection || working_sets || schema == "sparse" ||
+                    schema == "graph" || schema == "evolution";
+
+    if (variants) {
+        if (options().threads > 0 || !placements.empty()) {
+            std::cerr << "Error: "
+                      << (options().tiny ? std::string("--tiny") :
+                          options().projection ? std::string("--projection") :
+                          working_sets ? std::string("--working-set") : "--schema=" + schema)
+                      << " can't be combined with --threads or --placement" << std::endl;
+            return EXIT_FAILURE;
         }
+        // the tiny and sparse messages, and the projections read in place,
+        // are quick enough to need batching, unless records are cycled
+        if (options().batch == 0 && !cycled && (options().tiny || options().projection || schema == "sparse")) {
+            options().batch = 100;
+        }
+    }
 
-        if (names.empty() || names.find("cereal") != names.end()) {
-            cereal_serialization_test(iterations);
+    std::cout << "performing " << iterations << " iterations";
+    if (options().runs > 1) {
+        std::cout << " " << options().runs << " times";
+    }
+    if (options().warmup > 0) {
+        std::cout << " after " << options().warmup << " warm-up iterations";
+    }
+    if (options().batch > 1) {
+        std::cout << " in batches of " << options().batch;
+    }
+    if (options().threads > 0) {
+        std::cout << " on up to " << options().threads << " threads";
+    }
+    if (options().flush) {
+        std::cout << " flushing the caches before every batch";
+    }
+    if (options().timer == "tsc") {
+        std::cout << ", timed with the time stamp counter at " << tsc_ticks_per_nanosecond() << " GHz";
+    }
+    std::cout << std::endl << std::endl;
+
+    try {
+        payloads() = load_payloads(options().workload);
+        if (working_sets) {
+            const std::vector<size_t> &sizes = options().working_sets;
+            working_set_pool() = make_working_set_pool(payloads(), options().workload,
+                                                       *std::max_element(sizes.begin(), sizes.end()));
+        }
+        if (schema == "nested") {
+            document() = generate_document(options().workload.seed);
+        } else if (schema == "envelope") {
+            envelopes() = generate_envelopes(kEnvelopes, options().workload.seed);
+        } else if (schema == "graph") {
+            graph() = generate_graph(kGraphNodes, options().workload.seed);
+        } else if (schema == "hpc") {
+            simulation() = generate_simulation(options().workload.seed);
+        } else if (schema == "evolution") {
+            evolution() = generate_evolution(payloads()[0], options().workload.seed);
         }
+    } catch (std::exception &exc) {
+        std::cerr << "Error: " << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
-        if (names.empty() || names.find("avro") != names.end()) {
-            avro_serialization_test(iterations);
+    if (options().tiny) {
+        std::cout << "workload: tiny records (empty, 1-int, 1-int-1-string)" << std::endl << std::endl;
+    } else if (schema == "nested") {
+        std::cout << "workload: " << options().workload.describe() << ", " << document().bytes()
+                  << " bytes of raw data" << std::endl << std::endl;
+    } else if (schema == "envelope") {
+        std::cout << "workload: " << envelopes().size() << " " << options().workload.describe() << ", "
+                  << average_envelope_bytes() << " bytes of raw data on average" << std::endl << std::endl;
+    } else if (schema == "graph") {
+        std::cout << "workload: " << options().workload.describe() << ", " << graph().nodes.size()
+                  << " nodes, " << graph().links() << " links of which " << graph().cycles()
+                  << " point back to an ancestor, " << graph().bytes() << " bytes of raw data"
+                  << std::endl << std::endl;
+    } else if (schema == "hpc") {
+        std::cout << "workload: " << options().workload.describe() << ", " << simulation().samples.size()
+                  << " samples, " << simulation().particles.size() << " particles, a " << simulation().rows
+                  << "x" << simulation().columns << " matrix, " << simulation().bytes() << " bytes of raw data"
+                  << std::endl << std::endl;
+    } else if (schema == "evolution") {
+        std::cout << "workload: " << options().workload.describe() << ", " << evolution().bytes(1)
+                  << " bytes of raw data in version 1 and " << evolution().bytes(2) << " in version 2"
+                  << std::endl << std::endl;
+    } else if (schema == "sparse") {
+        std::cout << "workload: " << options().workload.describe() << std::endl << std::endl;
+    } else if (working_sets) {
+        std::cout << "workload: " << options().workload.describe() << ", pools of up to "
+                  << working_set_pool().size() << " distinct records of " << average_bytes(working_set_pool())
+                  << " bytes of raw data on average, last level cache of " << last_level_cache_size()
+                  << " bytes" << std::endl << std::endl;
+    } else {
+        std::cout << "workload: " << options().workload.describe();
+        if (payloads().size() > 1) {
+            std::cout << ", " << payloads().size() << " records of " << average_bytes(payloads())
+                      << " bytes of raw data on average" << std::endl << std::endl;
+        } else {
+            std::cout << ", " << average_bytes(payloads()) << " bytes of raw data" << std::endl << std::endl;
         }
+    }
 
-        if (names.empty() || names.find("hpx") != names.end()) {
-            hpx_serialization_test(iterations);
+    // Serializers in the order they are run. The last column tells whether
+    // a serializer may run on several threads at once: hpx_zero_copy keeps
+    // its chunks in a file-static vector and MPI is initialized without
+    // thread support. The placement mode (--placement, --pin) runs the
+    // halves of a round trip on two threads but never at the same time.
+    Tests tests = {
+        {"raw", [](size_t n) { raw_serialization_test(n, false); }, true},
+        {"raw-view", [](size_t n) { raw_serialization_test(n, true); }, true},
+        {"thrift-binary",
+         [](size_t n) { thrift_serialization_test(n, ThriftSerializationProto::Binary); }, true},
+        {"thrift-compact",
+         [](size_t n) { thrift_serialization_test(n, ThriftSerializationProto::Compact); }, true},
+        {"protobuf", protobuf_serialization_test, true},
+        {"capnproto", capnproto_serialization_test, true},
+        {"boost", boost_serialization_test, true},
+        {"msgpack", msgpack_serialization_test, true},
+        {"cereal", cereal_serialization_test, true},
+        {"avro", avro_serialization_test, true},
+        {"hpx", hpx_serialization_test, true},
+        {"hpx_zero_copy", hpx_zero_copy_serialization_test, false},
+#ifdef WITH_MPI
+        {"mpi", mpi_serialization_test, false},
+#endif
+        {"yas", yas_serialization_test, true},
+        {"reflect", reflect_serialization_test, true},
+        {"flatbuffers", flatbuffers_serialization_test, true},
+    };
+
+    if (schema == "nested") {
+        tests = nested_tests();
+    } else if (schema == "sparse") {
+        tests = sparse_tests();
+    } else if (schema == "envelope") {
+        tests = envelope_tests();
+    } else if (schema == "graph") {
+        tests = graph_tests();
+    } else if (schema == "hpc") {
+        tests = hpc_tests();
+    } else if (schema == "evolution") {
+        tests = evolution_tests();
+    } else if (options().materialize) {
+        tests = materialized_tests();
+    } else if (options().projection) {
+        tests = projection_tests();
+    } else if (options().reuse) {
+        // every reuse test right after the test it is a variant of
+        Tests reuse = reuse_tests();
+        Tests merged;
+        for (size_t i = 0; i < tests.size(); i++) {
+            merged.push_back(tests[i]);
+            for (size_t j = 0; j < reuse.size(); j++) {
+                if (reuse[j].name == tests[i].name + "-reuse") {
+                    merged.push_back(reuse[j]);
+                }
+            }
         }
+        tests.swap(merged);
+    }
 
-        if (names.empty() || names.find("hpx_zero_copy") != names.end()) {
-            hpx_zero_copy_serialization_test(iterations);
+    try {
+        for (size_t i = 0; i < tests.size(); i++) {
+            const Test &test = tests[i];
+
+            // naming a serializer selects its reuse test as well
+            std::string::size_type suffix = test.name.rfind("-reuse");
+            std::string base = suffix == std::string::npos ? test.name : test.name.substr(0, suffix);
+
+            if (!names.empty() && names.find(test.name) == names.end() && names.find(base) == names.end()) {
+                continue;
+            }
+
+            if (options().tiny) {
+                run_tiny(test.name, std::bind(test.run, iterations));
+            } else if (schema == "sparse") {
+                run_sparse(test.name, std::bind(test.run, iterations), options().workload.fills,
+                           options().workload.seed);
+            } else if (schema == "graph") {
+                run_graph(test.name, std::bind(test.run, iterations));
+            } else if (schema == "evolution") {
+                run_evolution(test.name, std::bind(test.run, iterations));
+            } else if (options().projection) {
+                run_projection(test.name, std::bind(test.run, iterations));
+            } else if (working_sets) {
+                run_working_sets(test.name, std::bind(test.run, iterations));
+            } else if (options().threads > 0) {
+                run_scaling(test.name, std::bind(test.run, iterations), options().threads, test.thread_safe);
+            } else if (!placements.empty()) {
+                run_placements(test.name, std::bind(test.run, iterations), placements);
+            } else {
+                test.run(iterations);
+            }
         }
+    } catch (std::exception &exc) {
+        std::cerr << "Error: " << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
-#ifdef WITH_MPI
-        if (names.empty() || names.find("mpi") != names.end()) {
-            mpi_serialization_test(iterations);
+    if (schema == "nested") {
+        print_size_table(document().bytes());
+    } else if (schema == "envelope") {
+        print_size_table(average_envelope_bytes());
+    } else if (schema == "graph") {
+        print_size_table(graph().bytes());
+    } else if (schema == "hpc") {
+        print_size_table(simulation().bytes());
+        print_bandwidth_table(simulation().bytes(), "memcpy");
+        print_hardware_limit_table(simulation().bytes());
+    } else if (schema == "evolution") {
+        print_evolution_table();
+    } else if (options().projection) {
+        print_projection_table();
+    } else if (working_sets) {
+        print_working_set_table();
+    } else if (!variants) {
+        print_size_table(average_bytes(payloads()));
+        print_bandwidth_table(average_bytes(payloads()), "raw");
+        print_hardware_limit_table(average_bytes(payloads()));
+    }
+
+    size_t regressions = 0;
+
+    try {
+        if (!options().json.empty()) {
+            write_json(options().json);
         }
-#endif
-        if (names.empty() || names.find("yas") != names.end()) {
-            yas_serialization_test(iterations);
+
+        if (!options().csv.empty()) {
+            write_csv(options().csv);
         }
 
-        if (names.empty() || names.find("flatbuffers") != names.end()) {
-            flatbuffers_serialization_test(iterations);
+        if (!options().baseline.empty()) {
+            regressions = compare_with_baseline(options().baseline, options().threshold);
         }
     } catch (std::exception &exc) {
         std::cerr << "Error: " << exc.what() << std::endl;
@@ -718,5 +1284,11 @@ main(int argc, char **argv)
 #ifdef WITH_MPI
     MPI_Finalize();
 #endif
+
+    if (regressions > 0) {
+        std::cerr << "Error: " << regressions << " serializer(s) regressed compared to the baseline" << std::endl;
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
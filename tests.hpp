@@ -0,0 +1,48 @@
+#ifndef __TESTS_HPP_INCLUDED__
+#define __TESTS_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+// A serializer test as run by main(): `run` measures the given number of
+// round trips and reports them with print_timings(). `thread_safe` tells
+// whether the test may run on several threads at once (see scaling.hpp).
+struct Test {
+    std::string name;
+    std::function<void(size_t)> run;
+    bool thread_safe;
+};
+
+typedef std::vector<Test> Tests;
+
+// The serializers' tests on the nested Document schema, see nested.cpp.
+Tests nested_tests();
+
+// The serializers' tests on the sparse optional-field schema, see sparse.cpp.
+Tests sparse_tests();
+
+// The serializers' tests on the envelope schema, see dispatch.cpp.
+Tests envelope_tests();
+
+// The serializers' tests on the object graph schema, see tracking.cpp.
+Tests graph_tests();
+
+// The serializers' tests on the HPC schema of bulk arrays, see hpc.cpp.
+Tests hpc_tests();
+
+// The serializers' tests on the evolution schema, see versioning.cpp.
+Tests evolution_tests();
+
+// The serializers' tests on the record schema, building every message from
+// the payload and reading back every value, see materialize.cpp.
+Tests materialized_tests();
+
+// The serializers' tests decoding part of the record, see projection.cpp.
+Tests projection_tests();
+
+// The serializers' tests on the record schema keeping their output buffers
+// from one message to the next, named "name-reuse", see reuse.cpp.
+Tests reuse_tests();
+
+#endif
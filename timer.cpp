@@ -0,0 +1,45 @@
+#include "timer.hpp"
+
+#include <algorithm>
+
+namespace {
+
+#ifdef HAVE_TSC
+double
+calibrate_tsc()
+{
+    typedef std::chrono::steady_clock clock;
+
+    // the median of 5 spans of 20 milliseconds, busy-waiting so that the
+    // process isn't descheduled between the two readings of a span
+    double ratios[5];
+    for (int i = 0; i < 5; i++) {
+        auto start = clock::now();
+        uint64_t ticks = __rdtsc();
+        auto finish = start;
+        do {
+            finish = clock::now();
+        } while (finish - start < std::chrono::milliseconds(20));
+        ticks = __rdtsc() - ticks;
+
+        auto span = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start);
+        ratios[i] = ticks / static_cast<double>(span.count());
+    }
+
+    std::sort(ratios, ratios + 5);
+    return ratios[2];
+}
+#endif
+
+} // namespace
+
+double
+tsc_ticks_per_nanosecond()
+{
+#ifdef HAVE_TSC
+    static const double ratio = calibrate_tsc();
+    return ratio;
+#else
+    return 0;
+#endif
+}
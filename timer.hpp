@@ -0,0 +1,72 @@
+#ifndef __TIMER_HPP_INCLUDED__
+#define __TIMER_HPP_INCLUDED__
+
+#include <chrono>
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+// Time stamp counter ticks per nanosecond, calibrated against the steady
+// clock over 100 milliseconds on the first call, or 0 when the CPU has no
+// time stamp counter the benchmark can read.
+double tsc_ticks_per_nanosecond();
+
+// Timestamps of the measured loops, read from the steady clock or, with
+// --timer=tsc, from the time stamp counter: rdtsc after an lfence when a
+// timed section starts, so that it doesn't run before the instructions
+// preceding it, and rdtscp followed by an lfence when it ends, so that it
+// waits for the timed instructions and the next ones wait for it.
+class Timer {
+public:
+
+    explicit Timer(bool tsc) : tsc_(tsc), nanoseconds_per_tick_(1.0) {
+        if (tsc_) {
+            nanoseconds_per_tick_ = 1.0 / tsc_ticks_per_nanosecond();
+        }
+    }
+
+    uint64_t start() const {
+#ifdef HAVE_TSC
+        if (tsc_) {
+            _mm_lfence();
+            return __rdtsc();
+        }
+#endif
+        return now();
+    }
+
+    uint64_t stop() const {
+#ifdef HAVE_TSC
+        if (tsc_) {
+            unsigned int cpu;
+            uint64_t ticks = __rdtscp(&cpu);
+            _mm_lfence();
+            return ticks;
+        }
+#endif
+        return now();
+    }
+
+    std::chrono::nanoseconds elapsed(uint64_t start, uint64_t stop) const {
+        if (tsc_) {
+            return std::chrono::nanoseconds(static_cast<int64_t>((stop - start) * nanoseconds_per_tick_ + 0.5));
+        }
+        return std::chrono::nanoseconds(stop - start);
+    }
+
+private:
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool   tsc_;
+    double nanoseconds_per_tick_;
+};
+
+#endif
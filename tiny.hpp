@@ -0,0 +1,53 @@
+#ifndef __TINY_HPP_INCLUDED__
+#define __TINY_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include "variants.hpp"
+#include "workload.hpp"
+
+// Records small enough for the fixed cost of every message (archive and
+// builder construction, first buffer allocation, framing) to dominate:
+// an empty record, one with a single id and one with an id and a short
+// string.
+inline std::vector<std::pair<std::string, Payload>>
+tiny_payloads()
+{
+    std::vector<std::pair<std::string, Payload>> result;
+
+    Payload empty;
+    result.push_back(std::make_pair("empty", empty));
+
+    Payload one_int;
+    one_int.ids.push_back(34492);
+    result.push_back(std::make_pair("1-int", one_int));
+
+    Payload int_string = one_int;
+    int_string.strings.push_back("shgfkghsdfjh");
+    result.push_back(std::make_pair("1-int-1-string", int_string));
+
+    return result;
+}
+
+// Runs `test` on each of the tiny records, see run_variants(). The
+// workload's payloads are put back afterwards.
+inline void
+run_tiny(const std::string &name, const std::function<void()> &test)
+{
+    std::vector<std::pair<std::string, Payload>> tiny = tiny_payloads();
+    std::vector<Payload> workload = payloads();
+
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < tiny.size(); i++) {
+        labels.push_back(tiny[i].first);
+    }
+
+    run_variants(name, test, labels, [&](size_t i) { payloads().assign(1, tiny[i].second); });
+
+    payloads() = workload;
+}
+
+#endif
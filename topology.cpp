@@ -0,0 +1,300 @@
+#include "topology.hpp"
+
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+namespace {
+
+int
+read_int(const std::string &path, int fallback)
+{
+    std::ifstream in(path.c_str());
+    int value;
+    if (in >> value) {
+        return value;
+    }
+    return fallback;
+}
+
+std::vector<int>
+parse_list(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+
+        char *end = NULL;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (end == range.c_str() || (*end != '\0' && *end != '\n') || first < 0 || last < first) {
+            throw std::invalid_argument("bad CPU list '" + list + "'");
+        }
+
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    return cpus;
+}
+
+std::string
+read_line(const std::string &path)
+{
+    std::ifstream in(path.c_str());
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+const Cpu *
+find_cpu(const std::vector<Cpu> &cpus, int id)
+{
+    for (size_t i = 0; i < cpus.size(); i++) {
+        if (cpus[i].id == id) {
+            return &cpus[i];
+        }
+    }
+    return NULL;
+}
+
+} // namespace
+
+#ifdef __linux__
+
+std::vector<Cpu>
+available_cpus()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::vector<Cpu> cpus;
+    std::vector<int> online = parse_list(read_line("/sys/devices/system/cpu/online"));
+
+    for (size_t i = 0; i < online.size(); i++) {
+        int id = online[i];
+        if (!CPU_ISSET(id, &allowed)) {
+            continue;
+        }
+
+        std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+
+        Cpu cpu;
+        cpu.id = id;
+        cpu.package = read_int(topology + "physical_package_id", 0);
+        cpu.core = read_int(topology + "core_id", id);
+        cpu.node = 0;
+        cpus.push_back(cpu);
+    }
+
+    // NUMA nodes list their CPUs; hosts without NUMA support have no such
+    // directory and everything stays on node 0
+    if (DIR *nodes = opendir("/sys/devices/system/node")) {
+        while (struct dirent *entry = readdir(nodes)) {
+            std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4) {
+                continue;
+            }
+
+            int node = atoi(name.c_str() + 4);
+            std::vector<int> members = parse_list(read_line("/sys/devices/system/node/" + name + "/cpulist"));
+            for (size_t i = 0; i < members.size(); i++) {
+                for (size_t j = 0; j < cpus.size(); j++) {
+                    if (cpus[j].id == members[i]) {
+                        cpus[j].node = node;
+                    }
+                }
+            }
+        }
+        closedir(nodes);
+    }
+
+    return cpus;
+}
+
+bool
+pin_current_thread(const std::vector<int> &cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < cpus.size(); i++) {
+        CPU_SET(cpus[i], &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+size_t
+last_level_cache_size()
+{
+    int level = 0;
+    size_t size = 0;
+
+    // index0, index1... until one is missing; sizes read as "32768K"
+    for (int index = 0;; index++) {
+        std::string cache = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::string text = read_line(cache + "size");
+        if (text.empty()) {
+            break;
+        }
+
+        char *end = NULL;
+        size_t value = strtoul(text.c_str(), &end, 10);
+        if (*end == 'K') {
+            value *= 1024;
+        } else if (*end == 'M') {
+            value *= 1024 * 1024;
+        }
+
+        int this_level = read_int(cache + "level", 0);
+        if (this_level > level || (this_level == level && value > size)) {
+            level = this_level;
+            size = value;
+        }
+    }
+
+    return size;
+}
+
+#else
+
+std::vector<Cpu>
+available_cpus()
+{
+    return std::vector<Cpu>();
+}
+
+size_t
+last_level_cache_size()
+{
+    return 0;
+}
+
+bool
+pin_current_thread(const std::vector<int> &)
+{
+    return false;
+}
+
+#endif
+
+std::vector<int>
+parse_cpus(const std::string &spec)
+{
+    if (spec.compare(0, 4, "node") != 0) {
+        return parse_list(spec);
+    }
+
+    std::string path = "/sys/devices/system/node/" + spec + "/cpulist";
+    std::ifstream in(path.c_str());
+    if (!in) {
+        throw std::invalid_argument("unknown NUMA node '" + spec + "'");
+    }
+    return parse_list(read_line(path));
+}
+
+std::string
+describe_cpus(const std::vector<int> &ids)
+{
+    std::vector<Cpu> cpus = available_cpus();
+
+    if (ids.size() == 1) {
+        std::ostringstream description;
+        description << "cpu " << ids[0];
+        if (const Cpu *cpu = find_cpu(cpus, ids[0])) {
+            description << " (node " << cpu->node << ", socket " << cpu->package << ", core " << cpu->core << ")";
+        }
+        return description.str();
+    }
+
+    std::set<int> nodes;
+    std::ostringstream description;
+    description << "cpus";
+    for (size_t i = 0; i < ids.size(); i++) {
+        description << (i == 0 ? " " : ",") << ids[i];
+        if (const Cpu *cpu = find_cpu(cpus, ids[i])) {
+            nodes.insert(cpu->node);
+        }
+    }
+    if (nodes.size() == 1) {
+        description << " (node " << *nodes.begin() << ")";
+    }
+    return description.str();
+}
+
+bool
+choose_placement(const std::string &kind, std::vector<int> &encode_cpus, std::vector<int> &decode_cpus)
+{
+    std::vector<Cpu> cpus = available_cpus();
+
+    for (size_t i = 0; i < cpus.size(); i++) {
+        for (size_t j = 0; j < cpus.size(); j++) {
+            const Cpu &a = cpus[i];
+            const Cpu &b = cpus[j];
+
+            bool match = false;
+            if (kind == "same-core") {
+                match = i == j;
+            } else if (kind == "smt") {
+                match = i != j && a.package == b.package && a.core == b.core;
+            } else if (kind == "same-socket") {
+                match = a.package == b.package && a.core != b.core;
+            } else if (kind == "cross-socket") {
+                match = a.package != b.package;
+            } else if (kind == "cross-node") {
+                match = a.package == b.package && a.node != b.node;
+            } else {
+                throw std::invalid_argument("unknown placement '" + kind + "'");
+            }
+
+            if (match) {
+                encode_cpus.assign(1, a.id);
+                decode_cpus.assign(1, b.id);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+namespace {
+
+size_t
+sweep_size()
+{
+    size_t llc = last_level_cache_size();
+    return 2 * (llc ? llc : 32 * 1024 * 1024);
+}
+
+} // namespace
+
+void
+flush_caches()
+{
+    // built once by the static's initialization, which C++11 makes safe
+    static std::vector<char> sweep(sweep_size(), 1);
+
+    // writing every line evicts what the caches held, dirty lines included
+    volatile char *data = &sweep[0];
+    for (size_t i = 0; i < sweep.size(); i += 64) {
+        data[i] = data[i] + 1;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef __TOPOLOGY_HPP_INCLUDED__
+#define __TOPOLOGY_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+
+// A logical CPU the process may run on, as described by Linux sysfs.
+struct Cpu {
+    int id;
+    int package; // socket
+    int core;    // core within the package, shared by SMT siblings
+    int node;    // NUMA node
+};
+
+std::vector<Cpu> available_cpus();
+
+// Parses a CPU list such as "0-3,8,10-11" or, with a "node" prefix, the
+// CPUs of a NUMA node such as "node1". Throws std::invalid_argument.
+std::vector<int> parse_cpus(const std::string &spec);
+
+// Describes a CPU set as "cpu 3 (node 0, socket 0, core 1)" or a list.
+std::string describe_cpus(const std::vector<int> &cpus);
+
+// Restricts the calling thread to `cpus`, returns false when not allowed.
+bool pin_current_thread(const std::vector<int> &cpus);
+
+// Chooses an encode and a decode CPU for one of the placements "same-core",
+// "smt", "same-socket", "cross-socket" and "cross-node" (two NUMA nodes of
+// one socket), returns false when the host has no such pair.
+bool choose_placement(const std::string &kind, std::vector<int> &encode_cpus, std::vector<int> &decode_cpus);
+
+// Size in bytes of the last level of cache of the first CPU, as described by
+// Linux sysfs, or 0 when unknown.
+size_t last_level_cache_size();
+
+// Evicts the data caches by writing every line of a buffer twice the size
+// of the last level of cache (32 MB when unknown), for --flush.
+void flush_caches();
+
+#endif
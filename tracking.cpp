@@ -0,0 +1,458 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+
+#include <hpx/config.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include "boost/graph.hpp"
+#include "cereal/graph.hpp"
+#include "hpx/graph.hpp"
+#include "hpx/version.hpp"
+
+#include "tracking.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "variants.hpp"
+#include "tests.hpp"
+
+bool
+GraphNodePayload::operator==(const GraphNodePayload &other) const
+{
+    if (kind != other.kind || children != other.children || links != other.links) {
+        return false;
+    }
+
+    switch (kind) {
+        case kWeight:
+            return weight == other.weight;
+        case kText:
+            return text == other.text;
+        case kSeries:
+            return values == other.values;
+    }
+
+    return false;
+}
+
+size_t
+GraphPayload::links() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        total += nodes[i].links.size();
+    }
+    return total;
+}
+
+size_t
+GraphPayload::cycles() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        for (size_t j = 0; j < nodes[i].links.size(); j++) {
+            // only the links to ancestors point to an earlier node
+            if (nodes[i].links[j] < static_cast<int64_t>(i)) {
+                total++;
+            }
+        }
+    }
+    return total;
+}
+
+GraphPayload
+GraphPayload::acyclic() const
+{
+    GraphPayload result = *this;
+
+    for (size_t i = 0; i < result.nodes.size(); i++) {
+        std::vector<int64_t> &links = result.nodes[i].links;
+        std::vector<int64_t> kept;
+        for (size_t j = 0; j < links.size(); j++) {
+            if (links[j] > static_cast<int64_t>(i)) {
+                kept.push_back(links[j]);
+            }
+        }
+        links.swap(kept);
+    }
+
+    return result;
+}
+
+size_t
+GraphPayload::bytes() const
+{
+    size_t total = 0;
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const GraphNodePayload &node = nodes[i];
+        total += (node.children.size() + node.links.size()) * sizeof(int64_t);
+
+        switch (node.kind) {
+            case GraphNodePayload::kWeight:
+                total += sizeof(node.weight);
+                break;
+            case GraphNodePayload::kText:
+                total += node.text.size();
+                break;
+            case GraphNodePayload::kSeries:
+                total += node.values.size() * sizeof(int64_t);
+                break;
+        }
+    }
+
+    return total;
+}
+
+GraphPayload
+generate_graph(size_t nodes, uint64_t seed)
+{
+    Random random(seed);
+
+    GraphPayload result;
+    result.nodes.resize(nodes);
+
+    std::vector<size_t> parents(nodes, 0);
+
+    for (size_t i = 0; i < nodes; i++) {
+        GraphNodePayload &node = result.nodes[i];
+        node.kind = static_cast<GraphNodePayload::Kind>(random.next() % 3);
+
+        switch (node.kind) {
+            case GraphNodePayload::kWeight:
+                node.weight = random.fraction();
+                break;
+            case GraphNodePayload::kText:
+                node.text = random.text(random.between(8, 32));
+                break;
+            case GraphNodePayload::kSeries:
+                for (int64_t j = random.between(2, 8); j > 0; j--) {
+                    node.values.push_back(random.between(0, 1000000));
+                }
+                break;
+        }
+
+        if (i > 0) {
+            parents[i] = random.between(0, i - 1);
+            result.nodes[parents[i]].children.push_back(i);
+        }
+    }
+
+    // every other node links either to a later node or back to one of its
+    // ancestors
+    for (size_t i = 0; i < nodes; i++) {
+        if (random.next() % 2 != 0) {
+            continue;
+        }
+
+        if (random.next() % 2 == 0 && i > 0) {
+            std::vector<size_t> ancestors(1, parents[i]);
+            while (ancestors.back() != 0) {
+                ancestors.push_back(parents[ancestors.back()]);
+            }
+            result.nodes[i].links.push_back(ancestors[random.next() % ancestors.size()]);
+        } else if (i + 1 < nodes) {
+            result.nodes[i].links.push_back(random.between(i + 1, nodes - 1));
+        }
+    }
+
+    return result;
+}
+
+GraphPayload &
+graph()
+{
+    static GraphPayload instance;
+    return instance;
+}
+
+bool &
+graph_tracking()
+{
+    static bool tracking = true;
+    return tracking;
+}
+
+void
+run_graph(const std::string &name, const std::function<void()> &test)
+{
+    std::vector<std::string> labels;
+    labels.push_back("tracked");
+    labels.push_back("untracked");
+
+    run_variants(name, test, labels, [](size_t i) { graph_tracking() = i == 0; });
+}
+
+namespace {
+
+// The nodes of a tracked graph are kept by id as shared pointers, for the
+// links to them.
+template <typename Node>
+void
+keep(std::vector<std::shared_ptr<Node> > &shared, const std::shared_ptr<Node> &node)
+{
+    shared[node->id] = node;
+}
+
+template <typename Node>
+void
+keep(std::vector<std::shared_ptr<Node> > &, const std::unique_ptr<Node> &)
+{
+}
+
+template <typename Node>
+void
+point(std::shared_ptr<Node> &link, const std::vector<std::shared_ptr<Node> > &shared, int64_t id)
+{
+    link = shared[id];
+}
+
+template <typename Node>
+void
+point(int64_t &link, const std::vector<std::shared_ptr<Node> > &, int64_t id)
+{
+    link = id;
+}
+
+// Builds node `id` and its children, the same way for the graph types of
+// every serializer.
+template <typename Graph>
+typename Graph::Pointer
+build(const GraphPayload &data, int64_t id, std::vector<typename Graph::NodeType *> &nodes,
+      std::vector<std::shared_ptr<typename Graph::NodeType> > &shared)
+{
+    const GraphNodePayload &source = data.nodes[id];
+    typename Graph::NodeType *node = NULL;
+
+    switch (source.kind) {
+        case GraphNodePayload::kWeight: {
+            typename Graph::WeightType *weight = new typename Graph::WeightType();
+            weight->weight = source.weight;
+            node = weight;
+            break;
+        }
+        case GraphNodePayload::kText: {
+            typename Graph::TextType *text = new typename Graph::TextType();
+            text->text = source.text;
+            node = text;
+            break;
+        }
+        case GraphNodePayload::kSeries: {
+            typename Graph::SeriesType *series = new typename Graph::SeriesType();
+            series->values = source.values;
+            node = series;
+            break;
+        }
+    }
+
+    typename Graph::Pointer result(node);
+    node->id = id;
+    nodes[id] = node;
+    keep(shared, result);
+
+    for (size_t i = 0; i < source.children.size(); i++) {
+        node->children.push_back(build<Graph>(data, source.children[i], nodes, shared));
+    }
+
+    return result;
+}
+
+template <typename Graph>
+void
+assign(Graph &graph, const GraphPayload &data)
+{
+    typedef typename Graph::NodeType Node;
+
+    std::vector<Node *> nodes(data.nodes.size(), NULL);
+    std::vector<std::shared_ptr<Node> > shared(data.nodes.size());
+
+    graph.clear();
+    graph.root = build<Graph>(data, 0, nodes, shared);
+
+    for (size_t i = 0; i < data.nodes.size(); i++) {
+        const std::vector<int64_t> &links = data.nodes[i].links;
+        nodes[i]->links.resize(links.size());
+        for (size_t j = 0; j < links.size(); j++) {
+            point(nodes[i]->links[j], shared, links[j]);
+        }
+    }
+}
+
+template <typename Node, typename Pointer>
+void
+collect(const Pointer &node, std::vector<const Node *> &nodes)
+{
+    if (node->id < 0) {
+        return;
+    }
+
+    size_t id = node->id;
+    if (id >= nodes.size()) {
+        nodes.resize(id + 1, NULL);
+    }
+    nodes[id] = node.get();
+
+    for (size_t i = 0; i < node->children.size(); i++) {
+        collect(node->children[i], nodes);
+    }
+}
+
+// The id a link points to, or -1 when a tracked link points to a copy
+// rather than to the node of that id.
+template <typename Node>
+int64_t
+target(const std::shared_ptr<Node> &link, const std::vector<const Node *> &nodes)
+{
+    if (!link || link->id < 0 || static_cast<size_t>(link->id) >= nodes.size() ||
+        nodes[link->id] != link.get()) {
+        return -1;
+    }
+    return link->id;
+}
+
+template <typename Node>
+int64_t
+target(int64_t link, const std::vector<const Node *> &)
+{
+    return link;
+}
+
+template <typename Graph>
+GraphPayload
+payload_of(const Graph &graph)
+{
+    typedef typename Graph::NodeType Node;
+
+    std::vector<const Node *> nodes;
+    if (graph.root) {
+        collect(graph.root, nodes);
+    }
+
+    GraphPayload result;
+    result.nodes.resize(nodes.size());
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const Node *node = nodes[i];
+        if (node == NULL) {
+            continue;
+        }
+
+        GraphNodePayload &payload = result.nodes[i];
+
+        if (const typename Graph::WeightType *weight = dynamic_cast<const typename Graph::WeightType *>(node)) {
+            payload.kind = GraphNodePayload::kWeight;
+            payload.weight = weight->weight;
+        } else if (const typename Graph::TextType *text = dynamic_cast<const typename Graph::TextType *>(node)) {
+            payload.kind = GraphNodePayload::kText;
+            payload.text = text->text;
+        } else if (const typename Graph::SeriesType *series = dynamic_cast<const typename Graph::SeriesType *>(node)) {
+            payload.kind = GraphNodePayload::kSeries;
+            payload.values = series->values;
+        }
+
+        for (size_t j = 0; j < node->children.size(); j++) {
+            payload.children.push_back(node->children[j]->id);
+        }
+        for (size_t j = 0; j < node->links.size(); j++) {
+            payload.links.push_back(target(node->links[j], nodes));
+        }
+    }
+
+    return result;
+}
+
+template <typename Graph, typename ToString, typename FromString>
+void
+archive_graph_test(size_t iterations, const std::string &name, const std::string &version,
+                   const GraphPayload &data, ToString to_string, FromString from_string)
+{
+    Graph g1, g2;
+    assign(g1, data);
+
+    std::string serialized;
+
+    auto check = [&] {
+        if (payload_of(g2) != data) {
+            throw std::logic_error(name + "'s case: deserialization failed");
+        }
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            to_string(g1, serialized);
+        },
+        [&] {
+            from_string(g2, serialized);
+        },
+        check);
+
+    check();
+
+    print_timings(name, version, timings, serialized.size());
+}
+
+template <bool Tracked>
+void
+boost_graph_test(size_t iterations)
+{
+    archive_graph_test<boost_test::Graph<Tracked> >(iterations, "boost",
+        boost::lexical_cast<std::string>(BOOST_VERSION), graph(),
+        [](const boost_test::Graph<Tracked> &g, std::string &s) { boost_test::to_string(g, s); },
+        [](boost_test::Graph<Tracked> &g, const std::string &s) { boost_test::from_string(g, s); });
+}
+
+template <bool Tracked>
+void
+cereal_graph_test(size_t iterations)
+{
+    archive_graph_test<cereal_test::Graph<Tracked> >(iterations, "cereal", "", graph(),
+        [](const cereal_test::Graph<Tracked> &g, std::string &s) { cereal_test::to_string(g, s); },
+        [](cereal_test::Graph<Tracked> &g, const std::string &s) { cereal_test::from_string(g, s); });
+}
+
+// HPX registers a tracked pointer only once the object it points to is
+// read, so a link back to an ancestor that is still being read can't be
+// resolved: hpx runs on the graph without those links.
+template <bool Tracked>
+void
+hpx_graph_test(size_t iterations)
+{
+    archive_graph_test<hpx_test::Graph<Tracked> >(iterations, "hpx", hpx::full_version_as_string(),
+        graph().acyclic(),
+        [](const hpx_test::Graph<Tracked> &g, std::string &s) { hpx_test::to_string(g, s); },
+        [](hpx_test::Graph<Tracked> &g, const std::string &s) { hpx_test::from_string(g, s); });
+}
+
+// Runs the tracked or the untracked test as run_graph() selected.
+Test
+graph_test(const std::string &name, void (*tracked)(size_t), void (*untracked)(size_t))
+{
+    Test test = {name,
+                 [=](size_t n) {
+                     if (graph_tracking()) {
+                         tracked(n);
+                     } else {
+                         untracked(n);
+                     }
+                 },
+                 true};
+    return test;
+}
+
+} // namespace
+
+Tests
+graph_tests()
+{
+    Tests tests = {
+        graph_test("boost", boost_graph_test<true>, boost_graph_test<false>),
+        graph_test("cereal", cereal_graph_test<true>, cereal_graph_test<false>),
+        graph_test("hpx", hpx_graph_test<true>, hpx_graph_test<false>),
+    };
+
+    return tests;
+}
@@ -0,0 +1,74 @@
+#ifndef __TRACKING_HPP_INCLUDED__
+#define __TRACKING_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <stdint.h>
+
+// The graph schema's tests (--schema=graph) serialize an object graph of
+// polymorphic nodes held by pointers, which only the serializers with
+// pointer tracking and class registration (boost, cereal, hpx) support.
+// Node i has the id i. Node 0 is the root, every other node is the child of
+// an earlier one and may link to later nodes, which are then reached more
+// than once, or back to one of its ancestors, which closes a cycle.
+const size_t kGraphNodes = 512;
+
+struct GraphNodePayload {
+    enum Kind {
+        kWeight,
+        kText,
+        kSeries
+    };
+
+    Kind                 kind;
+    double               weight;   // of a weight node
+    std::string          text;     // of a text node
+    std::vector<int64_t> values;   // of a series node
+    std::vector<int64_t> children; // ids of the nodes it owns
+    std::vector<int64_t> links;    // ids of the other nodes it points to
+
+    GraphNodePayload() : kind(kWeight), weight(0) {}
+
+    bool operator==(const GraphNodePayload &other) const;
+};
+
+struct GraphPayload {
+    std::vector<GraphNodePayload> nodes;
+
+    bool operator==(const GraphPayload &other) const {
+        return nodes == other.nodes;
+    }
+
+    bool operator!=(const GraphPayload &other) const {
+        return !(*this == other);
+    }
+
+    // Number of links, and of those pointing back to an ancestor.
+    size_t links() const;
+    size_t cycles() const;
+
+    // The same graph without the links pointing back to an ancestor.
+    GraphPayload acyclic() const;
+
+    // Size of the raw data: 8 bytes per weight, integer and edge, plus the
+    // characters of the texts.
+    size_t bytes() const;
+};
+
+// Generates a graph of `nodes` nodes from `seed`.
+GraphPayload generate_graph(size_t nodes, uint64_t seed);
+
+// The graph shared by the graph schema's tests.
+GraphPayload &graph();
+
+// Whether the graph schema's tests serialize the tracked graph or the
+// untracked tree with links by id, see run_graph().
+bool &graph_tracking();
+
+// Runs `test` with pointer tracking on and then off, and reports the size
+// and the time per graph of each as "name/tracked" and "name/untracked".
+void run_graph(const std::string &name, const std::function<void()> &test);
+
+#endif
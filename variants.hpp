@@ -0,0 +1,60 @@
+#ifndef __VARIANTS_HPP_INCLUDED__
+#define __VARIANTS_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <functional>
+
+#include "benchmark.hpp"
+
+// Runs `test` once per variant of the workload, select(i) switching to the
+// i-th, and prints the size and the time per message of every phase.
+// Results are kept as "name/label".
+inline void
+run_variants(const std::string &name, const std::function<void()> &test,
+             const std::vector<std::string> &labels, const std::function<void(size_t)> &select)
+{
+    for (size_t i = 0; i < labels.size(); i++) {
+        const std::string &label = labels[i];
+
+        Barrier start(1);
+        Collector results(&start);
+        std::string error;
+
+        select(i);
+        collector() = &results;
+
+        try {
+            test();
+        } catch (std::exception &exc) {
+            error = exc.what();
+        }
+
+        collector() = NULL;
+
+        if (!error.empty()) {
+            std::cout << name << ": " << label << " FAILED: " << error << std::endl;
+            continue;
+        }
+
+        const Timings &timings = results.timings;
+        Result result = make_result(name + "/" + label, results.version, timings, results.size);
+
+        double messages = static_cast<double>(timings.iterations);
+        if (messages > 0) {
+            std::cout << name << ": " << label << " = " << results.size << " bytes, encode "
+                      << 1e6 * result.encode.mean / messages << ", decode "
+                      << 1e6 * result.decode.mean / messages << ", round trip "
+                      << 1e6 * result.total.mean / messages << " ns/message" << std::endl;
+        }
+        print_allocations(name, label + " encode", timings.encode_allocations);
+        print_allocations(name, label + " decode", timings.decode_allocations);
+
+        add_result(result);
+    }
+
+    std::cout << std::endl;
+}
+
+#endif
@@ -0,0 +1,813 @@
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <memory>
+#include <functional>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "thrift/gen-cpp/evolution_v1_types.h"
+#include "thrift/gen-cpp/evolution_v1_constants.h"
+#include "thrift/gen-cpp/evolution_v2_types.h"
+#include "thrift/gen-cpp/evolution_v2_constants.h"
+
+#include <capnp/message.h>
+#include <capnp/serialize.h>
+
+#include <avro/Compiler.hh>
+
+#include "protobuf/evolution_v1.pb.h"
+#include "protobuf/evolution_v2.pb.h"
+#include "capnproto/evolution_v1.capnp.h"
+#include "capnproto/evolution_v2.capnp.h"
+#include "avro/evolution_v1.hpp"
+#include "avro/evolution_v2.hpp"
+#include "flatbuffers/evolution_v1_generated.h"
+#include "flatbuffers/evolution_v2_generated.h"
+
+#include "versioning.hpp"
+#include "random.hpp"
+#include "benchmark.hpp"
+#include "variants.hpp"
+#include "results.hpp"
+#include "tests.hpp"
+
+bool
+EvolutionPayload::operator==(const EvolutionPayload &other) const
+{
+    return id == other.id && name == other.name && ids == other.ids && strings == other.strings &&
+           legacy == other.legacy && timestamp == other.timestamp && tags == other.tags;
+}
+
+EvolutionPayload
+EvolutionPayload::as_read(int writer, int reader) const
+{
+    EvolutionPayload result = *this;
+
+    if (writer != 1 || reader != 1) {
+        result.legacy = 0;
+    }
+
+    if (writer != 2 || reader != 2) {
+        result.timestamp = 0;
+        result.tags.clear();
+    }
+
+    return result;
+}
+
+size_t
+EvolutionPayload::bytes(int version) const
+{
+    size_t total = sizeof(id) + name.size() + ids.size() * sizeof(int64_t);
+    for (size_t i = 0; i < strings.size(); i++) {
+        total += strings[i].size();
+    }
+
+    if (version == 1) {
+        total += sizeof(legacy);
+    } else {
+        total += sizeof(timestamp);
+        for (size_t i = 0; i < tags.size(); i++) {
+            total += tags[i].size();
+        }
+    }
+
+    return total;
+}
+
+EvolutionPayload
+generate_evolution(const Payload &record, uint64_t seed)
+{
+    Random random(seed);
+
+    EvolutionPayload result;
+
+    result.id = random.between(1, 1LL << 40);
+    result.name = random.text(16);
+    result.ids = record.ids;
+    result.strings = record.strings;
+    result.legacy = random.between(1, 1000);
+    result.timestamp = 1500000000000LL + random.between(0, 100000000000LL);
+
+    for (size_t i = 0; i < 8; i++) {
+        result.tags.push_back(random.text(random.between(4, 12)));
+    }
+
+    return result;
+}
+
+EvolutionPayload &
+evolution()
+{
+    static EvolutionPayload instance;
+    return instance;
+}
+
+Versions &
+evolution_versions()
+{
+    static Versions versions = {1, 1};
+    return versions;
+}
+
+void
+run_evolution(const std::string &name, const std::function<void()> &test)
+{
+    static const Versions versions[] = {{1, 1}, {2, 2}, {2, 1}, {1, 2}};
+
+    std::vector<std::string> labels;
+    labels.push_back("v1");
+    labels.push_back("v2");
+    labels.push_back("v2-to-v1");
+    labels.push_back("v1-to-v2");
+
+    run_variants(name, test, labels, [](size_t i) { evolution_versions() = versions[i]; });
+}
+
+void
+print_evolution_table()
+{
+    std::vector<Result> all = results();
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    std::cout << "decode time of a message written with the other version, relative to one written with the "
+              << "reader's own:" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const std::string &name = all[i].name;
+        std::string::size_type slash = name.rfind('/');
+        if (slash == std::string::npos || name.substr(slash + 1) != "v2-to-v1") {
+            continue;
+        }
+
+        std::string serializer = name.substr(0, slash);
+        const Result *same[2] = {NULL, NULL};
+        const Result *other[2] = {&all[i], NULL};
+
+        for (size_t j = 0; j < all.size(); j++) {
+            if (all[j].name == serializer + "/v1") {
+                same[0] = &all[j];
+            } else if (all[j].name == serializer + "/v2") {
+                same[1] = &all[j];
+            } else if (all[j].name == serializer + "/v1-to-v2") {
+                other[1] = &all[j];
+            }
+        }
+
+        std::cout << "  " << serializer << ":" << std::fixed << std::setprecision(2);
+        for (size_t version = 0; version < 2; version++) {
+            std::cout << (version == 0 ? " v2-to-v1 " : ", v1-to-v2 ");
+            if (same[version] == NULL || other[version] == NULL || same[version]->decode.mean <= 0) {
+                std::cout << "n/a";
+                continue;
+            }
+            // per message, as the variants may run different iteration counts
+            double reference = same[version]->decode.mean / same[version]->iterations;
+            double decode = other[version]->decode.mean / other[version]->iterations;
+            std::cout << decode / reference << "x of v" << version + 1;
+        }
+        std::cout << std::endl;
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+
+    std::cout << std::endl;
+}
+
+namespace {
+
+// Fills, and reads back, the records of thrift and avro, whose versions
+// share the names of EvolutionPayload's fields. The fields of one version
+// only are set by the overloads below.
+template <typename Record>
+void
+assign_common(Record &record, const EvolutionPayload &data)
+{
+    record.id = data.id;
+    record.name = data.name;
+    record.ids.assign(data.ids.begin(), data.ids.end());
+    record.strings.assign(data.strings.begin(), data.strings.end());
+}
+
+template <typename Record>
+void
+read_common(const Record &record, EvolutionPayload &result)
+{
+    result.id = record.id;
+    result.name = record.name;
+    result.ids.assign(record.ids.begin(), record.ids.end());
+    result.strings.assign(record.strings.begin(), record.strings.end());
+}
+
+void
+assign(thrift_v1::Record &record, const EvolutionPayload &data)
+{
+    assign_common(record, data);
+    record.__set_legacy(data.legacy);
+}
+
+void
+assign(thrift_v2::Record &record, const EvolutionPayload &data)
+{
+    assign_common(record, data);
+    record.__set_timestamp(data.timestamp);
+    record.__set_tags(data.tags);
+}
+
+EvolutionPayload
+payload_of(const thrift_v1::Record &record)
+{
+    EvolutionPayload result;
+    read_common(record, result);
+    if (record.__isset.legacy) {
+        result.legacy = record.legacy;
+    }
+    return result;
+}
+
+EvolutionPayload
+payload_of(const thrift_v2::Record &record)
+{
+    EvolutionPayload result;
+    read_common(record, result);
+    if (record.__isset.timestamp) {
+        result.timestamp = record.timestamp;
+    }
+    if (record.__isset.tags) {
+        result.tags = record.tags;
+    }
+    return result;
+}
+
+void
+assign(avro_v1::Record &record, const EvolutionPayload &data)
+{
+    assign_common(record, data);
+    record.legacy = data.legacy;
+}
+
+void
+assign(avro_v2::Record &record, const EvolutionPayload &data)
+{
+    assign_common(record, data);
+    record.timestamp = data.timestamp;
+    record.tags = data.tags;
+}
+
+EvolutionPayload
+payload_of(const avro_v1::Record &record)
+{
+    EvolutionPayload result;
+    read_common(record, result);
+    result.legacy = record.legacy;
+    return result;
+}
+
+EvolutionPayload
+payload_of(const avro_v2::Record &record)
+{
+    EvolutionPayload result;
+    read_common(record, result);
+    result.timestamp = record.timestamp;
+    result.tags = record.tags;
+    return result;
+}
+
+// Protobuf's versions share their accessors but for the fields of one
+// version only.
+template <typename Record>
+void
+assign_common_protobuf(Record &record, const EvolutionPayload &data)
+{
+    record.set_id(data.id);
+    record.set_name(data.name);
+    for (size_t i = 0; i < data.ids.size(); i++) {
+        record.add_ids(data.ids[i]);
+    }
+    for (size_t i = 0; i < data.strings.size(); i++) {
+        record.add_strings(data.strings[i]);
+    }
+}
+
+template <typename Record>
+void
+read_common_protobuf(const Record &record, EvolutionPayload &result)
+{
+    result.id = record.id();
+    result.name = record.name();
+    result.ids.assign(record.ids().begin(), record.ids().end());
+    result.strings.assign(record.strings().begin(), record.strings().end());
+}
+
+void
+assign(protobuf_v1::Record &record, const EvolutionPayload &data)
+{
+    assign_common_protobuf(record, data);
+    record.set_legacy(data.legacy);
+}
+
+void
+assign(protobuf_v2::Record &record, const EvolutionPayload &data)
+{
+    assign_common_protobuf(record, data);
+    record.set_timestamp(data.timestamp);
+    for (size_t i = 0; i < data.tags.size(); i++) {
+        record.add_tags(data.tags[i]);
+    }
+}
+
+EvolutionPayload
+payload_of(const protobuf_v1::Record &record)
+{
+    EvolutionPayload result;
+    read_common_protobuf(record, result);
+    result.legacy = record.legacy();
+    return result;
+}
+
+EvolutionPayload
+payload_of(const protobuf_v2::Record &record)
+{
+    EvolutionPayload result;
+    read_common_protobuf(record, result);
+    result.timestamp = record.timestamp();
+    result.tags.assign(record.tags().begin(), record.tags().end());
+    return result;
+}
+
+// The same for capnproto's builders and readers.
+template <typename Builder>
+void
+assign_common_capnp(Builder record, const EvolutionPayload &data)
+{
+    record.setId(data.id);
+    record.setName(data.name);
+
+    auto ids = record.initIds(data.ids.size());
+    for (size_t i = 0; i < data.ids.size(); i++) {
+        ids.set(i, data.ids[i]);
+    }
+
+    auto strings = record.initStrings(data.strings.size());
+    for (size_t i = 0; i < data.strings.size(); i++) {
+        strings.set(i, data.strings[i]);
+    }
+}
+
+template <typename Reader>
+void
+read_common_capnp(Reader record, EvolutionPayload &result)
+{
+    result.id = record.getId();
+    result.name = record.getName().cStr();
+    for (auto id: record.getIds()) {
+        result.ids.push_back(id);
+    }
+    for (auto string: record.getStrings()) {
+        result.strings.push_back(string.cStr());
+    }
+}
+
+void
+assign(capnp_v1::Record::Builder record, const EvolutionPayload &data)
+{
+    assign_common_capnp(record, data);
+    record.setLegacy(data.legacy);
+}
+
+void
+assign(capnp_v2::Record::Builder record, const EvolutionPayload &data)
+{
+    assign_common_capnp(record, data);
+    record.setTimestamp(data.timestamp);
+
+    auto tags = record.initTags(data.tags.size());
+    for (size_t i = 0; i < data.tags.size(); i++) {
+        tags.set(i, data.tags[i]);
+    }
+}
+
+EvolutionPayload
+payload_of(capnp_v1::Record::Reader record)
+{
+    EvolutionPayload result;
+    read_common_capnp(record, result);
+    result.legacy = record.getLegacy();
+    return result;
+}
+
+EvolutionPayload
+payload_of(capnp_v2::Record::Reader record)
+{
+    EvolutionPayload result;
+    read_common_capnp(record, result);
+    result.timestamp = record.getTimestamp();
+    for (auto tag: record.getTags()) {
+        result.tags.push_back(tag.cStr());
+    }
+    return result;
+}
+
+// And for flatbuffers, whose tables are built through their builders to
+// name every field rather than rely on the order of Create's arguments.
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String> > >
+create_strings(flatbuffers::FlatBufferBuilder &builder, const std::vector<std::string> &values)
+{
+    std::vector<flatbuffers::Offset<flatbuffers::String> > strings;
+    for (size_t i = 0; i < values.size(); i++) {
+        strings.push_back(builder.CreateString(values[i]));
+    }
+    return builder.CreateVector(strings);
+}
+
+flatbuffers::Offset<flatbuffers_v1::Record>
+build(flatbuffers::FlatBufferBuilder &builder, const EvolutionPayload &data, const flatbuffers_v1::Record *)
+{
+    auto name = builder.CreateString(data.name);
+    auto ids = builder.CreateVector(data.ids);
+    auto strings = create_strings(builder, data.strings);
+
+    flatbuffers_v1::RecordBuilder record(builder);
+    record.add_id(data.id);
+    record.add_name(name);
+    record.add_ids(ids);
+    record.add_strings(strings);
+    record.add_legacy(data.legacy);
+    return record.Finish();
+}
+
+flatbuffers::Offset<flatbuffers_v2::Record>
+build(flatbuffers::FlatBufferBuilder &builder, const EvolutionPayload &data, const flatbuffers_v2::Record *)
+{
+    auto name = builder.CreateString(data.name);
+    auto ids = builder.CreateVector(data.ids);
+    auto strings = create_strings(builder, data.strings);
+    auto tags = create_strings(builder, data.tags);
+
+    flatbuffers_v2::RecordBuilder record(builder);
+    record.add_id(data.id);
+    record.add_name(name);
+    record.add_ids(ids);
+    record.add_strings(strings);
+    record.add_timestamp(data.timestamp);
+    record.add_tags(tags);
+    return record.Finish();
+}
+
+template <typename Record>
+void
+read_common_flatbuffers(const Record *record, EvolutionPayload &result)
+{
+    result.id = record->id();
+    result.name = record->name()->str();
+    for (size_t i = 0; i < record->ids()->size(); i++) {
+        result.ids.push_back(record->ids()->Get(i));
+    }
+    for (size_t i = 0; i < record->strings()->size(); i++) {
+        result.strings.push_back(record->strings()->Get(i)->str());
+    }
+}
+
+EvolutionPayload
+payload_of(const flatbuffers_v1::Record *record)
+{
+    EvolutionPayload result;
+    read_common_flatbuffers(record, result);
+    result.legacy = record->legacy();
+    return result;
+}
+
+EvolutionPayload
+payload_of(const flatbuffers_v2::Record *record)
+{
+    EvolutionPayload result;
+    read_common_flatbuffers(record, result);
+    result.timestamp = record->timestamp();
+    if (record->tags() != nullptr) {
+        for (size_t i = 0; i < record->tags()->size(); i++) {
+            result.tags.push_back(record->tags()->Get(i)->str());
+        }
+    }
+    return result;
+}
+
+void
+check(const EvolutionPayload &decoded, const std::string &name)
+{
+    const Versions &versions = evolution_versions();
+    if (decoded != evolution().as_read(versions.writer, versions.reader)) {
+        throw std::logic_error(name + "'s case: deserialization failed");
+    }
+}
+
+enum class ThriftSerializationProto {
+    Binary,
+    Compact
+};
+
+// A reader skips the fields it doesn't know with TProtocol::skip().
+template <typename Writer, typename Reader, ThriftSerializationProto Proto>
+void
+thrift_evolution_test(size_t iterations)
+{
+    using apache::thrift::transport::TMemoryBuffer;
+    using apache::thrift::protocol::TBinaryProtocol;
+    using apache::thrift::protocol::TCompactProtocol;
+
+    boost::shared_ptr<TMemoryBuffer> buffer1(new TMemoryBuffer());
+    boost::shared_ptr<TMemoryBuffer> buffer2(new TMemoryBuffer());
+
+    TBinaryProtocol binary_protocol1(buffer1);
+    TBinaryProtocol binary_protocol2(buffer2);
+
+    TCompactProtocol compact_protocol1(buffer1);
+    TCompactProtocol compact_protocol2(buffer2);
+
+    Writer r1;
+    Reader r2;
+    assign(r1, evolution());
+
+    std::string serialized;
+
+    auto verify = [&] {
+        check(payload_of(r2), "thrift");
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            buffer1->resetBuffer();
+
+            if (Proto == ThriftSerializationProto::Binary) {
+                r1.write(&binary_protocol1);
+            } else {
+                r1.write(&compact_protocol1);
+            }
+
+            serialized = buffer1->getBufferAsString();
+        },
+        [&] {
+            buffer2->resetBuffer((uint8_t*)serialized.data(), serialized.length());
+
+            if (Proto == ThriftSerializationProto::Binary) {
+                r2.read(&binary_protocol2);
+            } else {
+                r2.read(&compact_protocol2);
+            }
+        },
+        verify);
+
+    verify();
+
+    std::string tag = Proto == ThriftSerializationProto::Binary ? "thrift-binary" : "thrift-compact";
+
+    print_timings(tag, VERSION, timings, serialized.size());
+}
+
+// A reader keeps the fields it doesn't know among its unknown fields.
+template <typename Writer, typename Reader>
+void
+protobuf_evolution_test(size_t iterations)
+{
+    Writer r1;
+    Reader r2;
+    assign(r1, evolution());
+
+    std::string serialized;
+
+    auto verify = [&] {
+        check(payload_of(r2), "protobuf");
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized.clear();
+            r1.SerializeToString(&serialized);
+        },
+        [&] {
+            r2.ParseFromString(serialized);
+        },
+        verify);
+
+    verify();
+
+    print_timings("protobuf", boost::lexical_cast<std::string>(GOOGLE_PROTOBUF_VERSION), timings, serialized.size());
+}
+
+// Fields are read in place, at the offsets of the reader's version: a
+// field the writer doesn't have reads as its default.
+template <typename Writer, typename Reader>
+void
+capnproto_evolution_test(size_t iterations)
+{
+    capnp::MallocMessageBuilder message;
+    assign(message.initRoot<Writer>(), evolution());
+
+    kj::ArrayPtr<const kj::ArrayPtr<const capnp::word>> serialized =
+        message.getSegmentsForOutput();
+
+    size_t size = 0;
+    for (auto segment: serialized) {
+      size += segment.asBytes().size();
+    }
+
+    // as in the Record test, decoding is opening a reader and reaching the
+    // root's lists
+    size_t decoded = 0;
+
+    auto verify = [&] {
+        capnp::SegmentArrayMessageReader reader(serialized);
+        if (decoded != evolution().ids.size() + evolution().strings.size()) {
+            throw std::logic_error("capnproto's case: deserialization failed");
+        }
+        check(payload_of(reader.getRoot<Reader>()), "capnproto");
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            serialized = message.getSegmentsForOutput();
+        },
+        [&] {
+            capnp::SegmentArrayMessageReader reader(serialized);
+            typename Reader::Reader r2 = reader.getRoot<Reader>();
+            decoded = r2.getIds().size() + r2.getStrings().size();
+        },
+        verify);
+
+    verify();
+
+    print_timings("capnproto", boost::lexical_cast<std::string>(CAPNP_VERSION), timings, size);
+}
+
+// Fields are found through the vtable: one missing from the writer's reads
+// as its default.
+template <typename Writer, typename Reader>
+void
+flatbuffers_evolution_test(size_t iterations)
+{
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<char> buf;
+
+    auto encode = [&] {
+        builder.Clear();
+        builder.Finish(build(builder, evolution(), static_cast<const Writer *>(NULL)));
+
+        auto p = reinterpret_cast<char*>(builder.GetBufferPointer());
+        auto sz = builder.GetSize();
+        buf.assign(p, p + sz);
+
+        builder.ReleaseBufferPointer();
+    };
+
+    std::string version = boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MAJOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_MINOR) + "." +
+                          boost::lexical_cast<std::string>(FLATBUFFERS_VERSION_REVISION);
+
+    // as in the Record test, decoding is getting the root table and
+    // reaching its lists
+    size_t decoded = 0;
+
+    auto verify = [&] {
+        if (decoded != evolution().ids.size() + evolution().strings.size()) {
+            throw std::logic_error("flatbuffer's case: deserialization failed");
+        }
+        check(payload_of(flatbuffers::GetRoot<Reader>(buf.data())), "flatbuffer");
+    };
+
+    auto timings = measure(iterations,
+        encode,
+        [&] {
+            auto r2 = flatbuffers::GetRoot<Reader>(buf.data());
+            decoded = r2->ids()->size() + r2->strings()->size();
+        },
+        verify);
+
+    verify();
+
+    print_timings("flatbuffers", version, timings, buf.size());
+}
+
+// The schema of `version`, which a ResolvingDecoder needs for both the
+// writer's and the reader's side. Avro's generated code doesn't embed it,
+// so it is read from the source tree.
+const avro::ValidSchema &
+avro_schema(int version)
+{
+    static const avro::ValidSchema v1 = avro::compileJsonSchemaFromFile(SCHEMA_DIR "/evolution_v1.json");
+    static const avro::ValidSchema v2 = avro::compileJsonSchemaFromFile(SCHEMA_DIR "/evolution_v2.json");
+
+    return version == 1 ? v1 : v2;
+}
+
+// Messages written with the reader's version are read with a plain binary
+// decoder, others through a ResolvingDecoder, whose grammar is built once
+// ahead of the measured loop. The generated decode() then reads the
+// fields in the writer's order, skipping those the reader doesn't have
+// and filling in the defaults of those the writer doesn't.
+template <typename Writer, typename Reader>
+void
+avro_evolution_test(size_t iterations)
+{
+    const Versions &versions = evolution_versions();
+
+    Writer r1;
+    Reader r2;
+    assign(r1, evolution());
+
+    avro::DecoderPtr decoder = avro::binaryDecoder();
+    if (versions.writer != versions.reader) {
+        decoder = avro::resolvingDecoder(avro_schema(versions.writer), avro_schema(versions.reader), decoder);
+    }
+
+    std::auto_ptr<avro::OutputStream> out;
+
+    auto verify = [&] {
+        check(payload_of(r2), "avro");
+    };
+
+    auto timings = measure(iterations,
+        [&] {
+            out = avro::memoryOutputStream();
+            auto encoder = avro::binaryEncoder();
+            encoder->init(*out);
+            avro::encode(*encoder, r1);
+            encoder->flush();
+        },
+        [&] {
+            auto in = avro::memoryInputStream(*out);
+            decoder->init(*in);
+            avro::decode(*decoder, r2);
+        },
+        verify);
+
+    verify();
+
+    print_timings("avro", "", timings, out->byteCount());
+}
+
+// Runs the test of the versions run_evolution() selected.
+Test
+evolution_test(const std::string &name, void (*v1)(size_t), void (*v2)(size_t),
+               void (*v2_to_v1)(size_t), void (*v1_to_v2)(size_t))
+{
+    Test test = {name,
+                 [=](size_t n) {
+                     const Versions &versions = evolution_versions();
+                     if (versions.writer == versions.reader) {
+                         (versions.writer == 1 ? v1 : v2)(n);
+                     } else {
+                         (versions.writer == 2 ? v2_to_v1 : v1_to_v2)(n);
+                     }
+                 },
+                 true};
+    return test;
+}
+
+template <typename Writer, typename Reader>
+void
+thrift_binary_evolution_test(size_t iterations)
+{
+    thrift_evolution_test<Writer, Reader, ThriftSerializationProto::Binary>(iterations);
+}
+
+template <typename Writer, typename Reader>
+void
+thrift_compact_evolution_test(size_t iterations)
+{
+    thrift_evolution_test<Writer, Reader, ThriftSerializationProto::Compact>(iterations);
+}
+
+// Instantiates `test` for the Record types of namespaces `v1` and `v2`.
+#define EVOLUTION_TEST(name, test, v1, v2)                                  \
+    evolution_test(name, test<v1::Record, v1::Record>,                      \
+                   test<v2::Record, v2::Record>,                            \
+                   test<v2::Record, v1::Record>,                            \
+                   test<v1::Record, v2::Record>)
+
+} // namespace
+
+Tests
+evolution_tests()
+{
+    Tests tests = {
+        EVOLUTION_TEST("thrift-binary", thrift_binary_evolution_test, thrift_v1, thrift_v2),
+        EVOLUTION_TEST("thrift-compact", thrift_compact_evolution_test, thrift_v1, thrift_v2),
+        EVOLUTION_TEST("protobuf", protobuf_evolution_test, protobuf_v1, protobuf_v2),
+        EVOLUTION_TEST("capnproto", capnproto_evolution_test, capnp_v1, capnp_v2),
+        EVOLUTION_TEST("avro", avro_evolution_test, avro_v1, avro_v2),
+        EVOLUTION_TEST("flatbuffers", flatbuffers_evolution_test, flatbuffers_v1, flatbuffers_v2),
+    };
+
+#undef EVOLUTION_TEST
+
+    return tests;
+}
@@ -0,0 +1,72 @@
+#ifndef __VERSIONING_HPP_INCLUDED__
+#define __VERSIONING_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <stdint.h>
+
+#include "workload.hpp"
+
+// The evolution schema's tests (--schema=evolution) write a record with one
+// version of its schema and read it with another, as readers and writers
+// rolled out at different times do. Version 1 (evolution_v1.*) has an id, a
+// name, the workload's ids and strings and a legacy integer. Version 2
+// (evolution_v2.*) drops legacy, adds a timestamp and a list of tags and
+// declares the other fields in another order. Only the serializers with
+// schema evolution take part: thrift, protobuf, capnproto, flatbuffers and
+// avro.
+struct EvolutionPayload {
+    int64_t                  id;
+    std::string              name;
+    std::vector<int64_t>     ids;
+    std::vector<std::string> strings;
+    int32_t                  legacy;    // version 1 only
+    int64_t                  timestamp; // version 2 only
+    std::vector<std::string> tags;      // version 2 only
+
+    EvolutionPayload() : id(0), legacy(0), timestamp(0) {}
+
+    bool operator==(const EvolutionPayload &other) const;
+
+    bool operator!=(const EvolutionPayload &other) const {
+        return !(*this == other);
+    }
+
+    // What a reader of version `reader` gets from a message written with
+    // version `writer`: the fields either version lacks are left to their
+    // defaults.
+    EvolutionPayload as_read(int writer, int reader) const;
+
+    // Size of the raw data written with `version`: 8 bytes per integer,
+    // 4 for legacy, plus the characters of the strings.
+    size_t bytes(int version) const;
+};
+
+// Generates an evolving record holding the ids and strings of `record`,
+// the other fields drawn from `seed`.
+EvolutionPayload generate_evolution(const Payload &record, uint64_t seed);
+
+// The record shared by the evolution schema's tests.
+EvolutionPayload &evolution();
+
+// The versions the evolution schema's tests write and read with, see
+// run_evolution().
+struct Versions {
+    int writer;
+    int reader;
+};
+
+Versions &evolution_versions();
+
+// Runs `test` writing and reading with version 1, then with version 2, then
+// writing with 2 and reading with 1 and the reverse, and reports each as
+// "name/v1", "name/v2", "name/v2-to-v1" and "name/v1-to-v2".
+void run_evolution(const std::string &name, const std::function<void()> &test);
+
+// Prints how much slower every result decodes a message written with the
+// other version than one written with its own.
+void print_evolution_table();
+
+#endif
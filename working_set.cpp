@@ -0,0 +1,183 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <functional>
+
+#include "working_set.hpp"
+#include "options.hpp"
+#include "variants.hpp"
+#include "results.hpp"
+
+namespace {
+
+// "32KB", "1MB", "1GB", or the exact size when it isn't a round number
+std::string
+format_bytes(size_t bytes)
+{
+    static const char *units[] = {"B", "KB", "MB", "GB"};
+
+    size_t unit = 0;
+    while (unit < 3 && bytes >= 1024 && bytes % 1024 == 0) {
+        bytes /= 1024;
+        unit++;
+    }
+
+    std::ostringstream out;
+    out << bytes << units[unit];
+    return out.str();
+}
+
+// Number of records at the start of the pool adding up to `bytes`.
+size_t
+records_for(const std::vector<Payload> &pool, size_t bytes)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < pool.size(); i++) {
+        total += pool[i].bytes();
+        if (total >= bytes) {
+            return i + 1;
+        }
+    }
+    return pool.size();
+}
+
+// Raw bytes per record of every working set, by label.
+std::vector<std::pair<std::string, size_t> > &
+raw_bytes()
+{
+    static std::vector<std::pair<std::string, size_t> > sizes;
+    return sizes;
+}
+
+} // namespace
+
+std::vector<Payload>
+make_working_set_pool(const std::vector<Payload> &base, const WorkloadSpec &spec, size_t bytes)
+{
+    std::vector<Payload> pool;
+    WorkloadSpec seeded = spec;
+
+    for (size_t total = 0; total < bytes || pool.empty();) {
+        if (spec.corpus.empty()) {
+            seeded.seed = spec.seed + pool.size();
+            pool.push_back(generate_payload(seeded));
+        } else {
+            pool.push_back(base[pool.size() % base.size()]);
+        }
+        total += pool.back().bytes();
+    }
+
+    return pool;
+}
+
+std::vector<Payload> &
+working_set_pool()
+{
+    static std::vector<Payload> pool;
+    return pool;
+}
+
+void
+run_working_sets(const std::string &name, const std::function<void()> &test)
+{
+    const std::vector<size_t> &sizes = options().working_sets;
+    const std::vector<Payload> &pool = working_set_pool();
+
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        labels.push_back(format_bytes(sizes[i]));
+    }
+
+    std::vector<Payload> saved;
+    saved.swap(payloads());
+
+    run_variants(name, test, labels, [&](size_t i) {
+        size_t count = records_for(pool, sizes[i]);
+        payloads().assign(pool.begin(), pool.begin() + count);
+
+        std::vector<std::pair<std::string, size_t> > &known = raw_bytes();
+        for (size_t j = 0; j < known.size(); j++) {
+            if (known[j].first == labels[i]) {
+                return;
+            }
+        }
+        known.push_back(std::make_pair(labels[i], average_bytes(payloads())));
+    });
+
+    payloads().swap(saved);
+}
+
+void
+print_working_set_table()
+{
+    const std::vector<std::pair<std::string, size_t> > &sizes = raw_bytes();
+    std::vector<Result> all = results();
+
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+
+    // without --flush every decode reads the message the encode before it
+    // just wrote, from the caches, so only the encodes see the working set
+    std::vector<std::pair<std::string, Summary Result::*> > phases;
+    phases.push_back(std::make_pair("encode", &Result::encode));
+    if (options().flush) {
+        phases.push_back(std::make_pair("decode", &Result::decode));
+    }
+
+    std::cout << "throughput over the raw data, by working set";
+    if (options().flush) {
+        std::cout << " (caches flushed)";
+    } else {
+        std::cout << " (encode only, decodes read a message still in the caches without --flush)";
+    }
+    std::cout << ":" << std::endl;
+
+    for (size_t i = 0; i < all.size(); i++) {
+        const std::string &name = all[i].name;
+        std::string::size_type slash = name.rfind('/');
+        if (sizes.empty() || slash == std::string::npos || name.substr(slash + 1) != sizes[0].first) {
+            continue;
+        }
+
+        std::string serializer = name.substr(0, slash);
+
+        for (size_t phase = 0; phase < phases.size(); phase++) {
+            double reference = 0;
+
+            std::cout << "  " << serializer << " " << phases[phase].first << ":" << std::fixed
+                      << std::setprecision(2);
+            for (size_t label = 0; label < sizes.size(); label++) {
+                std::cout << (label == 0 ? " " : ", ") << sizes[label].first << " ";
+
+                const Result *result = NULL;
+                for (size_t j = 0; j < all.size(); j++) {
+                    if (all[j].name == serializer + "/" + sizes[label].first) {
+                        result = &all[j];
+                    }
+                }
+
+                const Summary *time = result ? &(result->*phases[phase].second) : NULL;
+                if (time == NULL || time->mean <= 0) {
+                    std::cout << "n/a";
+                    continue;
+                }
+
+                double throughput = static_cast<double>(sizes[label].second) * result->iterations /
+                                    (time->mean * 1e6);
+                std::cout << throughput << " GB/s";
+                if (label == 0) {
+                    reference = throughput;
+                } else if (reference > 0) {
+                    std::cout << " (" << throughput / reference << "x)";
+                }
+            }
+            std::cout << std::endl;
+
+            std::cout.flags(flags);
+            std::cout.precision(precision);
+        }
+    }
+    std::cout << std::endl;
+}
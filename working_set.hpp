@@ -0,0 +1,36 @@
+#ifndef __WORKING_SET_HPP_INCLUDED__
+#define __WORKING_SET_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "workload.hpp"
+
+// The working set tests (--working-set) run every serializer on a pool of
+// distinct records whose raw data adds up to each working set of
+// options().working_sets in turn, one record after the other, so that past
+// the size of the caches every encode reads its record from memory. The
+// message buffer is still reused from one round trip to the next: --flush
+// evicts it as well, before every batch of encodes and of decodes.
+
+// Makes the pool of records the working sets are taken from, enough for the
+// largest: distinct generated payloads, seeded spec.seed, spec.seed + 1...
+// or the records of `base` (a corpus) over and over, each a copy of its
+// own.
+std::vector<Payload> make_working_set_pool(const std::vector<Payload> &base, const WorkloadSpec &spec,
+                                           size_t bytes);
+
+// The pool the working sets are taken from, set up by main().
+std::vector<Payload> &working_set_pool();
+
+// Runs `test` on every working set, payloads() holding the first records of
+// the pool adding up to it, and reports each as "name/32KB", "name/1MB"...
+void run_working_sets(const std::string &name, const std::function<void()> &test);
+
+// Prints the encode throughput of every serializer on every working set,
+// relative to the smallest, and with --flush the decode throughput too:
+// otherwise every decode reads the message just encoded from the caches.
+void print_working_set_table();
+
+#endif
@@ -0,0 +1,508 @@
+#include "workload.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "data.hpp"
+#include "random.hpp"
+
+namespace {
+
+std::vector<int64_t>
+generate_ids(const WorkloadSpec &spec, Random &random)
+{
+    std::vector<int64_t> ids;
+    ids.reserve(spec.ints);
+
+    const std::string &distribution = spec.int_distribution;
+    int64_t timestamp = 1500000000000; // milliseconds since the epoch
+
+    for (size_t i = 0; i < spec.ints; i++) {
+        if (distribution == "data") {
+            ids.push_back(kIntegers[i % kIntegers.size()]);
+        } else if (distribution == "small") {
+            // fits a single varint byte
+            ids.push_back(random.between(0, 127));
+        } else if (distribution == "uniform64") {
+            ids.push_back(static_cast<int64_t>(random.next()));
+        } else if (distribution == "negative") {
+            ids.push_back(random.between(-1000000, -1));
+        } else if (distribution == "monotonic") {
+            timestamp += random.between(1, 1000);
+            ids.push_back(timestamp);
+        } else if (distribution == "zipf") {
+            // Zipf with exponent 1 over [1, 10^6] through its continuous
+            // approximation, where the inverse CDF is n^u
+            ids.push_back(static_cast<int64_t>(std::pow(1e6, random.fraction())));
+        } else {
+            throw std::invalid_argument("unknown integer distribution '" + distribution + "'");
+        }
+    }
+
+    return ids;
+}
+
+size_t
+string_length(const std::string &distribution, Random &random)
+{
+    if (distribution == "sso") {
+        // stays within libstdc++'s small string buffer
+        return static_cast<size_t>(random.between(1, 15));
+    } else if (distribution == "medium") {
+        return static_cast<size_t>(random.between(16, 256));
+    } else if (distribution == "kb") {
+        return static_cast<size_t>(random.between(1024, 8192));
+    }
+
+    char *end = NULL;
+    unsigned long length = strtoul(distribution.c_str(), &end, 10);
+    if (distribution.empty() || *end != '\0') {
+        throw std::invalid_argument("unknown string length distribution '" + distribution + "'");
+    }
+    return length;
+}
+
+std::vector<std::string>
+generate_strings(const WorkloadSpec &spec, Random &random)
+{
+    std::vector<std::string> strings;
+    strings.reserve(spec.strings);
+
+    for (size_t i = 0; i < spec.strings; i++) {
+        if (spec.string_distribution == "data") {
+            strings.push_back(kStringValue);
+        } else {
+            strings.push_back(random.text(string_length(spec.string_distribution, random)));
+        }
+    }
+
+    return strings;
+}
+
+// Reads the records of a JSON lines corpus, one object per line.
+class JsonRecordReader {
+public:
+
+    JsonRecordReader(const std::string &text, const std::string &where)
+        : text_(text), where_(where), position_(0) {}
+
+    Payload read() {
+        Payload result;
+
+        expect('{');
+        if (!consume('}')) {
+            do {
+                std::string key = read_string();
+                expect(':');
+                if (key == "ids") {
+                    result.ids.clear();
+                    expect('[');
+                    if (!consume(']')) {
+                        do {
+                            result.ids.push_back(read_integer());
+                        } while (consume(','));
+                        expect(']');
+                    }
+                } else if (key == "strings") {
+                    result.strings.clear();
+                    expect('[');
+                    if (!consume(']')) {
+                        do {
+                            result.strings.push_back(read_string());
+                        } while (consume(','));
+                        expect(']');
+                    }
+                } else {
+                    skip_value();
+                }
+            } while (consume(','));
+            expect('}');
+        }
+
+        skip_spaces();
+        if (position_ != text_.size()) {
+            fail("unexpected characters after the record");
+        }
+
+        return result;
+    }
+
+private:
+
+    void fail(const std::string &message) const {
+        std::ostringstream error;
+        error << where_ << ", column " << position_ + 1 << ": " << message;
+        throw std::runtime_error(error.str());
+    }
+
+    void skip_spaces() {
+        while (position_ < text_.size() && isspace(static_cast<unsigned char>(text_[position_]))) {
+            position_++;
+        }
+    }
+
+    bool consume(char c) {
+        skip_spaces();
+        if (position_ < text_.size() && text_[position_] == c) {
+            position_++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+
+    int64_t read_integer() {
+        skip_spaces();
+        const char *begin = text_.c_str() + position_;
+        char *end = NULL;
+        errno = 0;
+        long long value = strtoll(begin, &end, 10);
+        if (end == begin || errno == ERANGE || *end == '.' || *end == 'e' || *end == 'E') {
+            fail("expected a 64-bit integer");
+        }
+        position_ += end - begin;
+        return value;
+    }
+
+    void append_utf8(std::string &out, unsigned long code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    unsigned long read_hex4() {
+        if (position_ + 4 > text_.size()) {
+            fail("truncated \\u escape");
+        }
+        std::string digits = text_.substr(position_, 4);
+        char *end = NULL;
+        unsigned long code = strtoul(digits.c_str(), &end, 16);
+        if (*end != '\0') {
+            fail("invalid \\u escape");
+        }
+        position_ += 4;
+        return code;
+    }
+
+    std::string read_string() {
+        expect('"');
+
+        std::string result;
+        while (position_ < text_.size() && text_[position_] != '"') {
+            char c = text_[position_++];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (position_ == text_.size()) {
+                break;
+            }
+            switch (c = text_[position_++]) {
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u': {
+                unsigned long code = read_hex4();
+                if (code >= 0xd800 && code < 0xdc00 && text_.compare(position_, 2, "\\u") == 0) {
+                    position_ += 2;
+                    unsigned long low = read_hex4();
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                }
+                append_utf8(result, code);
+                break;
+            }
+            default: result += c; break;
+            }
+        }
+
+        if (position_ == text_.size()) {
+            fail("unterminated string");
+        }
+        position_++;
+
+        return result;
+    }
+
+    void skip_value() {
+        skip_spaces();
+        if (position_ == text_.size()) {
+            fail("expected a value");
+        }
+
+        char c = text_[position_];
+        if (c == '"') {
+            read_string();
+        } else if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            position_++;
+            if (!consume(close)) {
+                do {
+                    if (c == '{') {
+                        read_string();
+                        expect(':');
+                    }
+                    skip_value();
+                } while (consume(','));
+                expect(close);
+            }
+        } else {
+            // number, true, false or null
+            while (position_ < text_.size() && text_[position_] != ',' && text_[position_] != '}' &&
+                   text_[position_] != ']' && !isspace(static_cast<unsigned char>(text_[position_]))) {
+                position_++;
+            }
+        }
+    }
+
+    const std::string &text_;
+    std::string where_;
+    size_t position_;
+};
+
+std::vector<Payload>
+read_json_lines(std::istream &in, const std::string &path)
+{
+    std::vector<Payload> result;
+
+    std::string line;
+    for (size_t number = 1; std::getline(in, line); number++) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::ostringstream where;
+        where << path << ":" << number;
+        result.push_back(JsonRecordReader(line, where.str()).read());
+    }
+
+    return result;
+}
+
+// Reads the little-endian integers of a length-prefixed corpus.
+class DumpReader {
+public:
+
+    DumpReader(const std::string &data, const std::string &path) : data_(data), path_(path), position_(0) {}
+
+    bool done() const {
+        return position_ == data_.size();
+    }
+
+    uint64_t read(size_t bytes) {
+        if (data_.size() - position_ < bytes) {
+            std::ostringstream error;
+            error << path_ << ": truncated record at offset " << position_;
+            throw std::runtime_error(error.str());
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[position_ + i])) << (8 * i);
+        }
+        position_ += bytes;
+        return value;
+    }
+
+    std::string read_string(size_t length) {
+        if (data_.size() - position_ < length) {
+            read(length); // throws
+        }
+        std::string value = data_.substr(position_, length);
+        position_ += length;
+        return value;
+    }
+
+private:
+
+    const std::string &data_;
+    std::string path_;
+    size_t position_;
+};
+
+std::vector<Payload>
+read_dump(std::istream &in, const std::string &path)
+{
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    DumpReader reader(data, path);
+
+    std::vector<Payload> result;
+
+    while (!reader.done()) {
+        Payload record;
+
+        uint64_t ids = reader.read(4);
+        for (uint64_t i = 0; i < ids; i++) {
+            record.ids.push_back(static_cast<int64_t>(reader.read(8)));
+        }
+
+        uint64_t strings = reader.read(4);
+        for (uint64_t i = 0; i < strings; i++) {
+            record.strings.push_back(reader.read_string(reader.read(4)));
+        }
+
+        result.push_back(record);
+    }
+
+    return result;
+}
+
+bool
+ends_with(const std::string &text, const std::string &suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+size_t
+Payload::bytes() const
+{
+    size_t total = ids.size() * sizeof(int64_t);
+    for (size_t i = 0; i < strings.size(); i++) {
+        total += strings[i].size();
+    }
+    return total;
+}
+
+WorkloadSpec::WorkloadSpec()
+    : ints(kIntegers.size()), int_distribution("data"),
+      strings(kStringsCount), string_distribution("data"), seed(1), schema("record")
+{
+    fills.push_back(1);
+    fills.push_back(10);
+    fills.push_back(100);
+}
+
+std::string
+WorkloadSpec::describe() const
+{
+    if (!corpus.empty()) {
+        return "corpus " + corpus;
+    }
+
+    std::ostringstream description;
+
+    if (schema == "nested") {
+        description << "nested documents, seed " << seed;
+        return description.str();
+    }
+
+    if (schema == "graph") {
+        description << "a graph of polymorphic nodes with shared and cyclic references, seed " << seed;
+        return description.str();
+    }
+
+    if (schema == "hpc") {
+        description << "a simulation step of samples, particles and a matrix, seed " << seed;
+        return description.str();
+    }
+
+    if (schema == "envelope") {
+        description << "envelopes of 16 message types in random order, seed " << seed;
+        return description.str();
+    }
+
+    if (schema == "sparse") {
+        description << "records of 64 optional fields filled at ";
+        for (size_t i = 0; i < fills.size(); i++) {
+            description << (i > 0 ? ", " : "") << fills[i] << "%";
+        }
+        description << ", seed " << seed;
+        return description.str();
+    }
+
+    bool fixed = !string_distribution.empty() &&
+                 string_distribution.find_first_not_of("0123456789") == std::string::npos;
+
+    description << ints << " " << int_distribution << " integers, " << strings << " "
+                << (fixed ? string_distribution + "-character" : string_distribution)
+                << " strings, seed " << seed;
+    return description.str();
+}
+
+Payload
+generate_payload(const WorkloadSpec &spec)
+{
+    Random random(spec.seed);
+
+    Payload result;
+    result.ids = generate_ids(spec, random);
+    result.strings = generate_strings(spec, random);
+    return result;
+}
+
+std::vector<Payload>
+load_corpus(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("can't open corpus '" + path + "'");
+    }
+
+    std::vector<Payload> result;
+    if (ends_with(path, ".json") || ends_with(path, ".jsonl")) {
+        result = read_json_lines(in, path);
+    } else {
+        result = read_dump(in, path);
+    }
+
+    if (result.empty()) {
+        throw std::runtime_error("corpus '" + path + "' holds no records");
+    }
+
+    return result;
+}
+
+std::vector<Payload>
+load_payloads(const WorkloadSpec &spec)
+{
+    if (!spec.corpus.empty()) {
+        return load_corpus(spec.corpus);
+    }
+    return std::vector<Payload>(1, generate_payload(spec));
+}
+
+size_t
+average_bytes(const std::vector<Payload> &payloads)
+{
+    if (payloads.empty()) {
+        return 0;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < payloads.size(); i++) {
+        total += payloads[i].bytes();
+    }
+    return total / payloads.size();
+}
+
+std::vector<Payload> &
+payloads()
+{
+    static std::vector<Payload> instance;
+    return instance;
+}
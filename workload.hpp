@@ -0,0 +1,102 @@
+#ifndef __WORKLOAD_HPP_INCLUDED__
+#define __WORKLOAD_HPP_INCLUDED__
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+// The ids and strings every serializer's Record is filled with.
+struct Payload {
+    std::vector<int64_t>     ids;
+    std::vector<std::string> strings;
+
+    // Size of the raw data: 8 bytes per id plus the string characters.
+    size_t bytes() const;
+};
+
+// Describes the payload to generate. The defaults reproduce data.hpp: its
+// 1000 kIntegers and kStringsCount copies of kStringValue.
+struct WorkloadSpec {
+    size_t      ints;
+    std::string int_distribution;    // data, small, uniform64, negative, monotonic or zipf
+    size_t      strings;
+    std::string string_distribution; // data, sso, medium, kb or a fixed length
+    uint64_t    seed;
+    std::string corpus;              // file of recorded payloads replacing the generated one
+    std::string schema;              // record, nested, sparse, envelope, graph, hpc or evolution
+    std::vector<size_t> fills;       // percentages of the sparse schema's fields set
+
+    WorkloadSpec();
+
+    std::string describe() const;
+};
+
+// Generates the payload for `spec`. The same spec and seed give the same
+// payload on every platform. Throws std::invalid_argument for unknown
+// distributions.
+Payload generate_payload(const WorkloadSpec &spec);
+
+// Reads the payloads recorded in `path`. Files named *.json or *.jsonl hold
+// one JSON object per line, {"ids": [1, 2], "strings": ["a", "b"]}, other
+// keys being ignored. Any other file is a dump of length-prefixed records:
+// a 32-bit count of ids followed by the ids as 64-bit integers, then a
+// 32-bit count of strings, each string being its 32-bit length followed by
+// its characters, all little-endian. Throws std::runtime_error when the file
+// can't be read or parsed.
+std::vector<Payload> load_corpus(const std::string &path);
+
+// The payloads the tests run on: the records of spec.corpus when given,
+// the generated payload otherwise.
+std::vector<Payload> load_payloads(const WorkloadSpec &spec);
+
+// Mean raw size of `payloads`.
+size_t average_bytes(const std::vector<Payload> &payloads);
+
+// The payloads shared by all the serializer tests.
+std::vector<Payload> &payloads();
+
+// A serializer's native records, one per payload in payloads(), which a
+// test cycles through so that consecutive round trips see different
+// records when replaying a corpus.
+template <typename Record>
+class Records {
+public:
+
+    // Calls fill(record, payload) to build the record of every payload.
+    template <typename Fill>
+    explicit Records(Fill fill) : records_(payloads().size()), next_(0), last_(0) {
+        for (size_t i = 0; i < records_.size(); i++) {
+            fill(records_[i], payloads()[i]);
+        }
+    }
+
+    size_t size() const {
+        return records_.size();
+    }
+
+    // The record to encode next, going back to the first after the last.
+    Record &next() {
+        last_ = next_;
+        next_ = next_ + 1 < records_.size() ? next_ + 1 : 0;
+        return records_[last_];
+    }
+
+    // The record returned by the latest call to next().
+    Record &last() {
+        return records_[last_];
+    }
+
+    // The payload `last()` was built from.
+    const Payload &last_payload() const {
+        return payloads()[last_];
+    }
+
+private:
+
+    std::vector<Record> records_;
+    size_t next_;
+    size_t last_;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include "yas/document.hpp"
+
+namespace yas_test {
+
+void
+to_string(const Document &document, std::string &data)
+{
+    yas::mem_ostream os;
+    yas::binary_oarchive<yas::mem_ostream> oa(os);
+    oa & document;
+
+    auto buf = os.get_intrusive_buffer();
+    data.assign(buf.data, buf.size);
+}
+
+void
+from_string(Document &document, const std::string &data)
+{
+    yas::mem_istream is(data.c_str(), data.size());
+    yas::binary_iarchive<yas::mem_istream> ia(is);
+    ia & document;
+}
+
+} // namespace
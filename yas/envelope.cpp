@@ -0,0 +1,78 @@
+#include "yas/envelope.hpp"
+
+#include <utility>
+#include <stdexcept>
+
+#include <boost/mpl/size.hpp>
+
+namespace yas_test {
+
+namespace {
+
+typedef yas::binary_oarchive<yas::mem_ostream> OutputArchive;
+typedef yas::binary_iarchive<yas::mem_istream> InputArchive;
+
+class BodyWriter : public boost::static_visitor<> {
+public:
+
+    explicit BodyWriter(OutputArchive &archive) : archive_(archive) {}
+
+    template <typename Message>
+    void operator()(const Message &message) const {
+        archive_ & message;
+    }
+
+private:
+
+    OutputArchive &archive_;
+};
+
+// Reads the message of type `type`, trying Type and the ones after it.
+template <int Type>
+void
+read_body(InputArchive &archive, int type, Body &body)
+{
+    if (type == Type) {
+        Message<Type> message;
+        archive & message;
+        body = std::move(message);
+    } else {
+        read_body<Type + 1>(archive, type, body);
+    }
+}
+
+template <>
+void
+read_body<boost::mpl::size<Body::types>::value>(InputArchive &, int, Body &)
+{
+    throw std::runtime_error("yas: unknown message type");
+}
+
+} // namespace
+
+void
+to_string(const Envelope &envelope, std::string &data)
+{
+    yas::mem_ostream os;
+    OutputArchive oa(os);
+
+    int type = envelope.body.which();
+    oa & envelope.sequence & type;
+    boost::apply_visitor(BodyWriter(oa), envelope.body);
+
+    auto buf = os.get_intrusive_buffer();
+    data.assign(buf.data, buf.size);
+}
+
+void
+from_string(Envelope &envelope, const std::string &data)
+{
+    yas::mem_istream is(data.c_str(), data.size());
+    InputArchive ia(is);
+
+    int type = 0;
+    ia & envelope.sequence & type;
+    read_body<0>(ia, type, envelope.body);
+}
+
+} // namespace
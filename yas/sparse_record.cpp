@@ -0,0 +1,24 @@
+#include "yas/sparse_record.hpp"
+
+namespace yas_test {
+
+void
+to_string(const SparseRecord &record, std::string &data)
+{
+    yas::mem_ostream os;
+    yas::binary_oarchive<yas::mem_ostream> oa(os);
+    oa & record;
+
+    auto buf = os.get_intrusive_buffer();
+    data.assign(buf.data, buf.size);
+}
+
+void
+from_string(SparseRecord &record, const std::string &data)
+{
+    yas::mem_istream is(data.c_str(), data.size());
+    yas::binary_iarchive<yas::mem_istream> ia(is);
+    ia & record;
+}
+
+} // namespace